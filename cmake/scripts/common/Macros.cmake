@@ -111,6 +111,14 @@ function(core_add_test_library name)
   endforeach()
 endfunction()
 
+# Add a benchmark library, its sources are built into the benchmark executable
+function(core_add_benchmark_library name)
+  foreach(src IN LISTS SOURCES HEADERS)
+    get_filename_component(src_path "${src}" ABSOLUTE)
+    set(benchmark_sources "${src_path}" ${benchmark_sources} CACHE STRING "" FORCE)
+  endforeach()
+endfunction()
+
 # Add an dl-loaded shared library
 # Arguments:
 #   name name of the library to add
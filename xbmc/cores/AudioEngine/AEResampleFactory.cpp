@@ -8,6 +8,15 @@
 
 #include "AEResampleFactory.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleFFMPEG.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <utility>
+
 #if defined(TARGET_RASPBERRY_PI)
   #include "ServiceBroker.h"
   #include "settings/Settings.h"
@@ -18,6 +27,37 @@
 namespace ActiveAE
 {
 
+namespace
+{
+// released resamplers, oldest first
+const size_t MAX_POOLED_RESAMPLERS = 4;
+CCriticalSection poolSection;
+std::list<std::pair<AEResampleConfig, std::unique_ptr<IAEResample>>> pool;
+
+bool CompareSampleConfig(const SampleConfig &lhs, const SampleConfig &rhs)
+{
+  return lhs.fmt == rhs.fmt &&
+         lhs.channel_layout == rhs.channel_layout &&
+         lhs.channels == rhs.channels &&
+         lhs.sample_rate == rhs.sample_rate &&
+         lhs.bits_per_sample == rhs.bits_per_sample &&
+         lhs.dither_bits == rhs.dither_bits;
+}
+} // namespace
+
+bool AEResampleConfig::operator==(const AEResampleConfig& other) const
+{
+  return CompareSampleConfig(dstConfig, other.dstConfig) &&
+         CompareSampleConfig(srcConfig, other.srcConfig) &&
+         upmix == other.upmix &&
+         normalize == other.normalize &&
+         centerMix == other.centerMix &&
+         remap == other.remap &&
+         (!remap || remapLayout == other.remapLayout) &&
+         quality == other.quality &&
+         forceResample == other.forceResample;
+}
+
 IAEResample *CAEResampleFactory::Create(uint32_t flags /* = 0 */)
 {
 #if defined(TARGET_RASPBERRY_PI)
@@ -27,4 +67,53 @@ IAEResample *CAEResampleFactory::Create(uint32_t flags /* = 0 */)
   return new CActiveAEResampleFFMPEG();
 }
 
+IAEResample *CAEResampleFactory::Acquire(AEResampleConfig &config)
+{
+  std::unique_ptr<IAEResample> resampler;
+  {
+    CSingleLock lock(poolSection);
+    auto it = std::find_if(pool.begin(), pool.end(),
+                           [&config](const std::pair<AEResampleConfig, std::unique_ptr<IAEResample>> &entry)
+                           {
+                             return entry.first == config;
+                           });
+    if (it != pool.end())
+    {
+      resampler = std::move(it->second);
+      pool.erase(it);
+    }
+  }
+
+  if (!resampler)
+    resampler.reset(Create());
+
+  if (!resampler->Init(config.dstConfig, config.srcConfig,
+                       config.upmix,
+                       config.normalize,
+                       config.centerMix,
+                       config.remap ? &config.remapLayout : nullptr,
+                       config.quality,
+                       config.forceResample))
+  {
+    CLog::Log(LOGERROR, "CAEResampleFactory::%s - failed to init %s", __FUNCTION__, resampler->GetName());
+  }
+
+  return resampler.release();
+}
+
+void CAEResampleFactory::Release(IAEResample *resampler, const AEResampleConfig &config)
+{
+  // only swresample contexts can be initialized again
+  if (!dynamic_cast<CActiveAEResampleFFMPEG*>(resampler))
+  {
+    delete resampler;
+    return;
+  }
+
+  CSingleLock lock(poolSection);
+  pool.emplace_back(config, std::unique_ptr<IAEResample>(resampler));
+  if (pool.size() > MAX_POOLED_RESAMPLERS)
+    pool.pop_front();
+}
+
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "cores/AudioEngine/Interfaces/AEResample.h"
+#include "cores/AudioEngine/Utils/AEChannelInfo.h"
 
 class IAEResample;
 
@@ -24,10 +25,41 @@ enum AEResampleFactoryOptions
   AERESAMPLEFACTORY_QUICK_RESAMPLE = 0x01
 };
 
+/*!
+ \brief All parameters of IAEResample::Init
+ */
+struct AEResampleConfig
+{
+  SampleConfig dstConfig;
+  SampleConfig srcConfig;
+  bool upmix = false;
+  bool normalize = true;
+  double centerMix = 0.0;
+  bool remap = false;
+  CAEChannelInfo remapLayout;
+  AEQuality quality = AE_QUALITY_MID;
+  bool forceResample = false;
+
+  bool operator==(const AEResampleConfig& other) const;
+};
+
 class CAEResampleFactory
 {
 public:
   static IAEResample *Create(uint32_t flags = 0U);
+
+  /*!
+   \brief Get an initialized resampler, setting up swresample is expensive so
+   a released one of the same config is reused
+   \return the resampler, never nullptr. If Init failed it is logged and the
+   resampler returned anyway, as callers did with the one of Create before.
+   */
+  static IAEResample *Acquire(AEResampleConfig &config);
+
+  /*!
+   \brief Give back a resampler of Acquire, it is kept for the next stream
+   */
+  static void Release(IAEResample *resampler, const AEResampleConfig &config);
 };
 
 }
@@ -15,6 +15,7 @@ using namespace ActiveAE;
 #include "ActiveAEStream.h"
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamData.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
@@ -30,6 +31,10 @@ using namespace ActiveAE;
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
 #define MAX_BUFFER_TIME 0.1   // max time of a buffer in seconds
 
+#define LOW_LATENCY_CACHE_LEVEL 0.05 // total cache time of stream in low latency mode
+#define LOW_LATENCY_WATER_LEVEL 0.04 // buffered time after stream stages in low latency mode
+#define LOW_LATENCY_BUFFER_TIME 0.01 // period requested from the sink in low latency mode
+
 void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 {
   CSingleLock lock(m_lock);
@@ -40,6 +45,13 @@ void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
   m_pcmOutput = pcm;
 }
 
+void CEngineStats::SetLevels(float cacheLevel, float waterLevel)
+{
+  CSingleLock lock(m_lock);
+  m_cacheLevel = cacheLevel;
+  m_waterLevel = waterLevel;
+}
+
 void CEngineStats::UpdateSinkDelay(const AEDelayStatus& status, int samples)
 {
   CSingleLock lock(m_lock);
@@ -205,12 +217,13 @@ float CEngineStats::GetCacheTime(CActiveAEStream *stream)
 
 float CEngineStats::GetCacheTotal()
 {
-  return MAX_CACHE_LEVEL;
+  CSingleLock lock(m_lock);
+  return m_cacheLevel;
 }
 
 float CEngineStats::GetMaxDelay() const
 {
-  return MAX_CACHE_LEVEL + MAX_WATER_LEVEL + m_sinkCacheTotal;
+  return m_cacheLevel + m_waterLevel + m_sinkCacheTotal;
 }
 
 float CEngineStats::GetWaterLevel()
@@ -267,7 +280,11 @@ CActiveAE::CActiveAE() :
   m_vizInitialized = false;
   m_sinkHasVolume = false;
   m_aeGUISoundForce = false;
+  m_lowLatency = false;
+  m_cacheLevel = MAX_CACHE_LEVEL;
+  m_waterLevel = MAX_WATER_LEVEL;
   m_stats.Reset(44100, true);
+  m_stats.SetLevels(m_cacheLevel, m_waterLevel);
   m_streamIdGen = 0;
 
   m_settingsHandler.reset(new CActiveAESettings(*this));
@@ -1166,12 +1183,20 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   ApplySettingsToFormat(m_sinkRequestFormat, m_settings, (int*)&m_mode);
   m_extKeepConfig = 0;
 
+  // ask the sink for short periods in low latency mode, else let it choose
+  bool lowLatency = NeedLowLatency(m_mode);
+  if (lowLatency)
+    m_sinkRequestFormat.m_frames = LOW_LATENCY_BUFFER_TIME * m_sinkRequestFormat.m_sampleRate;
+  else
+    m_sinkRequestFormat.m_frames = 0;
+
   std::string device = (m_sinkRequestFormat.m_dataFormat == AE_FMT_RAW) ? m_settings.passthroughdevice : m_settings.device;
   std::string driver;
   CAESinkFactory::ParseDevice(device, driver);
   if ((!CompareFormat(m_sinkRequestFormat, m_sinkFormat) && !CompareFormat(m_sinkRequestFormat, oldSinkRequestFormat)) ||
       m_currDevice.compare(device) != 0 ||
-      m_settings.driver.compare(driver) != 0)
+      m_settings.driver.compare(driver) != 0 ||
+      lowLatency != m_lowLatency)
   {
     FlushEngine();
     if (!InitSink())
@@ -1180,6 +1205,20 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     m_currDevice = device;
     initSink = true;
     m_stats.Reset(m_sinkFormat.m_sampleRate, m_mode == MODE_PCM);
+
+    // keep a couple of sink periods queued, sinks may not go as low as requested
+    m_lowLatency = lowLatency;
+    m_cacheLevel = MAX_CACHE_LEVEL;
+    m_waterLevel = MAX_WATER_LEVEL;
+    if (m_lowLatency)
+    {
+      double periodtime = (double)m_sinkFormat.m_frames / m_sinkFormat.m_sampleRate;
+      m_cacheLevel = std::max(LOW_LATENCY_CACHE_LEVEL, 2 * periodtime);
+      m_waterLevel = std::max(LOW_LATENCY_WATER_LEVEL, 2 * periodtime);
+      CLog::Log(LOGDEBUG, "ActiveAE::%s - low latency mode, cache %d ms, water level %d ms", __FUNCTION__,
+                (int)(m_cacheLevel * 1000), (int)(m_waterLevel * 1000));
+    }
+    m_stats.SetLevels(m_cacheLevel, m_waterLevel);
     m_sink.m_controlPort.SendOutMessage(CSinkControlProtocol::VOLUME, &m_volume, sizeof(float));
 
     if (m_sinkRequestFormat.m_dataFormat != AE_FMT_RAW)
@@ -1477,6 +1516,9 @@ CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
   if (streamMsg->options & AESTREAM_FORCE_RESAMPLE)
     stream->m_forceResampler = true;
 
+  if (streamMsg->options & AESTREAM_LOW_LATENCY)
+    stream->m_lowLatency = true;
+
   stream->m_pClock = streamMsg->clock;
 
   m_streams.push_back(stream);
@@ -1754,7 +1796,8 @@ bool CActiveAE::NeedReconfigureBuffers()
 bool CActiveAE::NeedReconfigureSink()
 {
   AEAudioFormat newFormat = GetInputFormat();
-  ApplySettingsToFormat(newFormat, m_settings);
+  int mode;
+  ApplySettingsToFormat(newFormat, m_settings, &mode);
 
   std::string device = (newFormat.m_dataFormat == AE_FMT_RAW) ? m_settings.passthroughdevice : m_settings.device;
   std::string driver;
@@ -1762,7 +1805,24 @@ bool CActiveAE::NeedReconfigureSink()
 
   return !CompareFormat(newFormat, m_sinkFormat) ||
       m_currDevice.compare(device) != 0 ||
-      m_settings.driver.compare(driver) != 0;
+      m_settings.driver.compare(driver) != 0 ||
+      NeedLowLatency(mode) != m_lowLatency;
+}
+
+bool CActiveAE::NeedLowLatency(int mode)
+{
+  if (mode != MODE_PCM)
+    return false;
+
+  if (m_settings.lowLatency)
+    return true;
+
+  for (auto stream : m_streams)
+  {
+    if (stream->m_lowLatency)
+      return true;
+  }
+  return false;
 }
 
 bool CActiveAE::InitSink()
@@ -1901,7 +1961,7 @@ bool CActiveAE::RunStages()
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
-      while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
+      while ((time < m_cacheLevel || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
@@ -1940,7 +2000,7 @@ bool CActiveAE::RunStages()
     }
   }
 
-  if (m_stats.GetWaterLevel() < MAX_WATER_LEVEL &&
+  if (m_stats.GetWaterLevel() < m_waterLevel &&
      (m_mode != MODE_TRANSCODE || (m_encoderBuffers && !m_encoderBuffers->m_freeSamples.empty())))
   {
     // calculate sync error
@@ -2068,39 +2128,53 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
-            for(int i=0; i<nb_loops; i++)
+            const CAEKernels::SKernels& kernels = CAEKernels::Get();
+            if (nb_loops > 1)
             {
-              if ((*it)->m_fadingSamples > 0)
+              // get the gains of all frames first and apply them in one pass
+              RunLimiter(*it, *out->pkt, nb_loops);
+              for(int i=0; i<nb_loops; i++)
               {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
+                if ((*it)->m_fadingSamples > 0)
                 {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
+                  (*it)->m_volume += fadingStep;
+                  (*it)->m_fadingSamples--;
+
+                  if ((*it)->m_fadingSamples == 0)
+                  {
+                    // set variables being polled via stream interface
+                    CSingleLock lock((*it)->m_streamLock);
+                    (*it)->m_streamFading = false;
+                  }
                 }
-              }
 
-              // volume for stream
-              float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
+                // volume for stream
+                float volume = (*it)->m_volume * (*it)->m_rgain;
+                m_gains[i] = volume * m_gains[i];
+              }
 
-              for(int j=0; j<out->pkt->planes; j++)
+              if (out->pkt->planes > 1)
+              {
+                for(int j=0; j<out->pkt->planes; j++)
+                  kernels.MulGains((float*)out->pkt->data[j], m_gains.data(), nb_loops);
+              }
+              else
               {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
+                float* fbuffer = (float*)out->pkt->data[0];
+                for (int i = 0; i < nb_loops; i++, fbuffer += nb_floats)
                 {
-                  fbuffer[k] *= volume;
+                  for (int k = 0; k < nb_floats; ++k)
+                    fbuffer[k] *= m_gains[i];
                 }
-#endif
               }
             }
+            else
+            {
+              // volume for stream
+              float volume = (*it)->m_volume * (*it)->m_rgain;
+              for(int j=0; j<out->pkt->planes; j++)
+                kernels.Mul((float*)out->pkt->data[j], volume, nb_floats);
+            }
           }
           else
           {
@@ -2135,48 +2209,67 @@ bool CActiveAE::RunStages()
               nb_loops = out->pkt->nb_samples;
             }
 
-            for(int i=0; i<nb_loops; i++)
+            const CAEKernels::SKernels& kernels = CAEKernels::Get();
+            int count = nb_floats;
+            if (nb_loops > 1)
             {
-              if ((*it)->m_fadingSamples > 0)
+              // get the gains of all frames first and apply them in one pass
+              RunLimiter(*it, *mix->pkt, nb_loops);
+              for(int i=0; i<nb_loops; i++)
               {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
+                if ((*it)->m_fadingSamples > 0)
                 {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
+                  (*it)->m_volume += fadingStep;
+                  (*it)->m_fadingSamples--;
+
+                  if ((*it)->m_fadingSamples == 0)
+                  {
+                    // set variables being polled via stream interface
+                    CSingleLock lock((*it)->m_streamLock);
+                    (*it)->m_streamFading = false;
+                  }
                 }
+
+                // volume for stream
+                float volume = (*it)->m_volume * (*it)->m_rgain;
+                m_gains[i] = volume * m_gains[i];
               }
 
+              if (out->pkt->planes > 1)
+              {
+                for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
+                  kernels.MulAddGains((float*)out->pkt->data[j], (float*)mix->pkt->data[j], m_gains.data(), nb_loops);
+              }
+              else
+              {
+                float *dst = (float*)out->pkt->data[0];
+                float *src = (float*)mix->pkt->data[0];
+                for (int i = 0; i < nb_loops; i++, dst += nb_floats, src += nb_floats)
+                {
+                  for (int k = 0; k < nb_floats; ++k)
+                    dst[k] += src[k] * m_gains[i];
+                }
+              }
+              count = nb_loops * nb_floats;
+            }
+            else
+            {
               // volume for stream
               float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
-
               for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
+                kernels.MulAdd((float*)out->pkt->data[j], (float*)mix->pkt->data[j], volume, nb_floats);
+            }
+
+            for(int j=0; j<out->pkt->planes && j<mix->pkt->planes && !needClamp; j++)
+            {
+              float *dst = (float*)out->pkt->data[j];
+              for (int k = 0; k < count; ++k)
               {
-                float *dst = (float*)out->pkt->data[j]+i*nb_floats;
-                float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
+                if (fabs(dst[k]) > 1.0f)
                 {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
+                  needClamp = true;
+                  break;
                 }
-#endif
               }
             }
             mix->Return();
@@ -2559,12 +2652,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEKernels::Get().MulAdd(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2589,15 +2677,33 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEKernels::Get().Mul(buffer, volume, nb_floats);
+    }
+  }
+}
+
+void CActiveAE::RunLimiter(CActiveAEStream *stream, CSoundPacket &pkt, int frames)
+{
+  m_peaks.assign(frames, 0.0f);
+  m_gains.resize(frames);
+
+  if (pkt.planes > 1)
+  {
+    for (int j = 0; j < pkt.config.channels; j++)
+      CAEKernels::Get().AbsMax(m_peaks.data(), reinterpret_cast<float*>(pkt.data[j]), frames);
+  }
+  else
+  {
+    const float* data = reinterpret_cast<float*>(pkt.data[0]);
+    int channels = pkt.config.channels;
+    for (int i = 0; i < frames; i++, data += channels)
+    {
+      for (int k = 0; k < channels; k++)
+        m_peaks[i] = std::max(m_peaks[i], fabsf(data[k]));
     }
   }
+
+  stream->m_limiter.Run(m_peaks.data(), m_gains.data(), frames);
 }
 
 //-----------------------------------------------------------------------------
@@ -2633,6 +2739,7 @@ void CActiveAE::LoadSettings()
   m_settings.atempoThreshold = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_ATEMPOTHRESHOLD) / 100.0;
   m_settings.streamNoise = settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_STREAMNOISE);
   m_settings.silenceTimeout = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_STREAMSILENCE) * 60000;
+  m_settings.lowLatency = settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_LOWLATENCY);
 }
 
 void CActiveAE::Start()
@@ -61,6 +61,7 @@ struct AudioSettings
   double atempoThreshold;
   bool streamNoise;
   int silenceTimeout;
+  bool lowLatency;
 };
 
 class CActiveAEControlProtocol : public Protocol
@@ -175,6 +176,7 @@ class CEngineStats
 {
 public:
   void Reset(unsigned int sampleRate, bool pcm);
+  void SetLevels(float cacheLevel, float waterLevel);
   void UpdateSinkDelay(const AEDelayStatus& status, int samples);
   void AddSamples(int samples, std::list<CActiveAEStream*> &streams);
   void GetDelay(AEDelayStatus& status);
@@ -196,6 +198,8 @@ public:
 protected:
   float m_sinkCacheTotal;
   float m_sinkLatency;
+  float m_cacheLevel;
+  float m_waterLevel;
   int m_bufferedSamples;
   unsigned int m_sinkSampleRate;
   AEDelayStatus m_sinkDelay;
@@ -295,6 +299,7 @@ protected:
   void LoadSettings();
   bool NeedReconfigureBuffers();
   bool NeedReconfigureSink();
+  bool NeedLowLatency(int mode);
   void ApplySettingsToFormat(AEAudioFormat &format, AudioSettings &settings, int *mode = NULL);
   void Configure(AEAudioFormat *desiredFmt = NULL);
   AEAudioFormat GetInputFormat(AEAudioFormat *desiredFmt = NULL);
@@ -315,6 +320,7 @@ protected:
   bool ResampleSound(CActiveAESound *sound);
   void MixSounds(CSoundPacket &dstSample);
   void Deamplify(CSoundPacket &dstSample);
+  void RunLimiter(CActiveAEStream *stream, CSoundPacket &pkt, int frames);
 
   bool CompareFormat(AEAudioFormat &lhs, AEAudioFormat &rhs);
 
@@ -340,6 +346,9 @@ protected:
     MODE_TRANSCODE,
     MODE_PCM
   }m_mode;
+  bool m_lowLatency;
+  float m_cacheLevel;                     // stream cache time of the current mode
+  float m_waterLevel;                     // buffered time after stream stages of the current mode
 
   CActiveAESink m_sink;
   AEAudioFormat m_sinkFormat;
@@ -359,6 +368,8 @@ protected:
   CActiveAEBufferPool *m_vizBuffersInput;
   CActiveAEBufferPool *m_silenceBuffers;  // needed to drive gui sounds if we have no streams
   CActiveAEBufferPool *m_encoderBuffers;
+  std::vector<float> m_peaks;             // per frame limiter input
+  std::vector<float> m_gains;             // per frame stream gains
 
   // streams
   std::list<CActiveAEStream*> m_streams;
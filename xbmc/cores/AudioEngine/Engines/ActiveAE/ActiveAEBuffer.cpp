@@ -10,8 +10,10 @@
 
 #include "ActiveAE.h"
 #include "ActiveAEFilter.h"
+#include "ActiveAEResampleDirect.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/log.h"
 
 using namespace ActiveAE;
 
@@ -146,7 +148,7 @@ CActiveAEBufferPoolResample::~CActiveAEBufferPoolResample()
 {
   Flush();
 
-  delete m_resampler;
+  ReleaseResampler();
 }
 
 bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, bool upmix, bool normalize)
@@ -172,15 +174,10 @@ bool CActiveAEBufferPoolResample::Create(unsigned int totaltime, bool remap, boo
 
 void CActiveAEBufferPoolResample::ChangeResampler()
 {
-  if (m_resampler)
-  {
-    delete m_resampler;
-    m_resampler = NULL;
-  }
-
-  m_resampler = CAEResampleFactory::Create();
+  ReleaseResampler();
 
-  SampleConfig dstConfig, srcConfig;
+  AEResampleConfig config;
+  SampleConfig &dstConfig = config.dstConfig;
   dstConfig.channel_layout = CAEUtil::GetAVChannelLayout(m_format.m_channelLayout);
   dstConfig.channels = m_format.m_channelLayout.Count();
   dstConfig.sample_rate = m_format.m_sampleRate;
@@ -188,6 +185,7 @@ void CActiveAEBufferPoolResample::ChangeResampler()
   dstConfig.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_format.m_dataFormat);
   dstConfig.dither_bits = CAEUtil::DataFormatToDitherBits(m_format.m_dataFormat);
 
+  SampleConfig &srcConfig = config.srcConfig;
   srcConfig.channel_layout = CAEUtil::GetAVChannelLayout(m_inputFormat.m_channelLayout);
   srcConfig.channels = m_inputFormat.m_channelLayout.Count();
   srcConfig.sample_rate = m_inputFormat.m_sampleRate;
@@ -195,17 +193,58 @@ void CActiveAEBufferPoolResample::ChangeResampler()
   srcConfig.bits_per_sample = CAEUtil::DataFormatToUsedBits(m_inputFormat.m_dataFormat);
   srcConfig.dither_bits = CAEUtil::DataFormatToDitherBits(m_inputFormat.m_dataFormat);
 
-  m_resampler->Init(dstConfig, srcConfig,
-                    m_stereoUpmix,
-                    m_normalize,
-                    m_centerMixLevel,
-                    m_remap ? &m_format.m_channelLayout : nullptr,
-                    m_resampleQuality,
-                    m_forceResampler);
+  config.upmix = m_stereoUpmix;
+  config.normalize = m_normalize;
+  config.centerMix = m_centerMixLevel;
+  config.remap = m_remap;
+  config.remapLayout = m_format.m_channelLayout;
+  config.quality = m_resampleQuality;
+  config.forceResample = m_forceResampler;
+
+  // formats of the same rate that differ in sample format or channel order
+  // only need a conversion
+  if (!m_forceResampler && m_resampleRatio == 1.0)
+  {
+    std::unique_ptr<IAEResample> direct(new CActiveAEResampleDirect());
+    if (direct->Init(dstConfig, srcConfig,
+                     config.upmix,
+                     config.normalize,
+                     config.centerMix,
+                     config.remap ? &config.remapLayout : nullptr,
+                     config.quality,
+                     config.forceResample))
+    {
+      m_resampler = direct.release();
+      m_directResampler = true;
+    }
+  }
 
+  if (!m_resampler)
+  {
+    m_resampler = CAEResampleFactory::Acquire(config);
+    m_directResampler = false;
+  }
+
+  CLog::Log(LOGDEBUG, "CActiveAEBufferPoolResample::%s - using %s", __FUNCTION__, m_resampler->GetName());
+
+  m_resamplerConfig = config;
   m_changeResampler = false;
 }
 
+void CActiveAEBufferPoolResample::ReleaseResampler()
+{
+  if (!m_resampler)
+    return;
+
+  if (m_directResampler)
+    delete m_resampler;
+  else
+    CAEResampleFactory::Release(m_resampler, m_resamplerConfig);
+
+  m_resampler = nullptr;
+  m_directResampler = false;
+}
+
 bool CActiveAEBufferPoolResample::ResampleBuffers(int64_t timestamp)
 {
   bool busy = false;
@@ -433,6 +472,10 @@ void CActiveAEBufferPoolResample::SetDrain(bool drain)
 void CActiveAEBufferPoolResample::SetRR(double rr)
 {
   m_resampleRatio = rr;
+
+  // the direct conversion can't adjust the rate
+  if (m_directResampler && rr != 1.0)
+    m_changeResampler = true;
 }
 
 double CActiveAEBufferPoolResample::GetRR() const
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "cores/AudioEngine/AEResampleFactory.h"
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include <cmath>
@@ -95,6 +96,7 @@ public:
 
 protected:
   void ChangeResampler();
+  void ReleaseResampler();
 
   uint8_t *m_planes[16];
   bool m_empty = true;
@@ -103,6 +105,8 @@ protected:
   bool m_remap = false;
   CSampleBuffer *m_procSample = nullptr;
   IAEResample *m_resampler = nullptr;
+  AEResampleConfig m_resamplerConfig;
+  bool m_directResampler = false;
   double m_resampleRatio = 1.0f;
   double m_centerMixLevel = M_SQRT1_2;
   bool m_fillPackets = false;
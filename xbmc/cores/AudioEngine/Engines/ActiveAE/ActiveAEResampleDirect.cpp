@@ -0,0 +1,339 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ActiveAEResampleDirect.h"
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+template<typename D, typename S, typename F>
+void ConvertStrided(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int samples, F convert)
+{
+  D *out = reinterpret_cast<D*>(dst);
+  const S *in = reinterpret_cast<const S*>(src);
+  for (int i = 0; i < samples; i++, out += dstStride, in += srcStride)
+    *out = convert(*in);
+}
+
+// the conversions of swresample
+inline float S16ToFloat(int16_t sample)
+{
+  return static_cast<float>(sample) * (1.0f / 32768.0f);
+}
+
+inline float S32ToFloat(int32_t sample)
+{
+  return static_cast<float>(sample) * (1.0f / 2147483648.0f);
+}
+
+inline int32_t S16ToS32(int16_t sample)
+{
+  return static_cast<int32_t>(sample) * (1 << 16);
+}
+
+inline int16_t S32ToS16(int32_t sample)
+{
+  return static_cast<int16_t>(sample >> 16);
+}
+
+template<typename T>
+inline T Copy(T sample)
+{
+  return sample;
+}
+} // namespace
+
+bool CActiveAEResampleDirect::Init(SampleConfig dstConfig, SampleConfig srcConfig, bool upmix, bool normalize, double centerMix,
+                                   CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample)
+{
+  if (force_resample || dstConfig.sample_rate != srcConfig.sample_rate)
+    return false;
+
+  if (!GetLayout(srcConfig, m_src) || !GetLayout(dstConfig, m_dst))
+    return false;
+
+  // swresample aligns the bits of 24 bit formats carried in S32
+  if (m_dst.type == SAMPLE_S32 && (dstConfig.bits_per_sample != 32 || dstConfig.dither_bits != 0))
+    return false;
+
+  m_map.assign(m_dst.channels, -1);
+  if (remapLayout)
+  {
+    // one-to-one mapping of channels, the same as the matrix of swresample
+    if (!srcConfig.channel_layout || static_cast<int>(remapLayout->Count()) != m_dst.channels)
+      return false;
+
+    for (int out = 0; out < m_dst.channels; out++)
+      m_map[out] = CAEUtil::GetAVChannelIndex((*remapLayout)[out], srcConfig.channel_layout);
+  }
+  else
+  {
+    // everything else needs the mixing of swresample
+    if (srcConfig.channel_layout != dstConfig.channel_layout || m_src.channels != m_dst.channels)
+      return false;
+
+    for (int out = 0; out < m_dst.channels; out++)
+      m_map[out] = out;
+  }
+
+  m_identity = (m_src.channels == m_dst.channels);
+  for (int out = 0; out < m_dst.channels; out++)
+  {
+    if (m_map[out] != out)
+      m_identity = false;
+  }
+
+  m_rate = dstConfig.sample_rate;
+  m_pending.clear();
+  m_pendingSamples = 0;
+  return true;
+}
+
+int CActiveAEResampleDirect::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
+{
+  // the caller changes to a real resampler for adjusting the rate. It drains
+  // this one first, the input still pending is output at the old rate.
+  if (ratio != 1.0 && src_buffer && src_samples > 0)
+    return -1;
+
+  int samples = 0;
+
+  // input of previous calls goes first
+  if (m_pendingSamples > 0)
+  {
+    samples = std::min(m_pendingSamples, dst_samples);
+    uint8_t *pending[AE_CH_MAX];
+    for (unsigned int i = 0; i < m_pending.size(); i++)
+      pending[i] = m_pending[i].data();
+    Convert(dst_buffer, 0, pending, 0, samples);
+
+    int frameBytes = m_src.planar ? m_src.bytes : m_src.bytes * m_src.channels;
+    for (auto& plane : m_pending)
+      plane.erase(plane.begin(), plane.begin() + samples * frameBytes);
+    m_pendingSamples -= samples;
+  }
+
+  if (src_buffer && src_samples > 0)
+  {
+    int count = std::min(src_samples, dst_samples - samples);
+    if (count > 0)
+      Convert(dst_buffer, samples, src_buffer, 0, count);
+    if (count < src_samples)
+      Store(src_buffer, count, src_samples - count);
+    samples += count;
+  }
+
+  return samples;
+}
+
+int64_t CActiveAEResampleDirect::GetDelay(int64_t base)
+{
+  return static_cast<int64_t>(m_pendingSamples) * base / m_rate;
+}
+
+int CActiveAEResampleDirect::CalcDstSampleCount(int src_samples, int dst_rate, int src_rate)
+{
+  return (static_cast<int64_t>(src_samples) * dst_rate + src_rate - 1) / src_rate;
+}
+
+int CActiveAEResampleDirect::GetSrcBufferSize(int samples)
+{
+  return samples * m_src.channels * m_src.bytes;
+}
+
+int CActiveAEResampleDirect::GetDstBufferSize(int samples)
+{
+  return samples * m_dst.channels * m_dst.bytes;
+}
+
+bool CActiveAEResampleDirect::GetLayout(const SampleConfig &config, Layout &layout)
+{
+  switch (config.fmt)
+  {
+    case AV_SAMPLE_FMT_FLT:
+    case AV_SAMPLE_FMT_FLTP:
+      layout.type = SAMPLE_FLOAT;
+      layout.bytes = sizeof(float);
+      break;
+    case AV_SAMPLE_FMT_S16:
+    case AV_SAMPLE_FMT_S16P:
+      layout.type = SAMPLE_S16;
+      layout.bytes = sizeof(int16_t);
+      break;
+    case AV_SAMPLE_FMT_S32:
+    case AV_SAMPLE_FMT_S32P:
+      layout.type = SAMPLE_S32;
+      layout.bytes = sizeof(int32_t);
+      break;
+    default:
+      return false;
+  }
+
+  layout.planar = (config.fmt == AV_SAMPLE_FMT_FLTP ||
+                   config.fmt == AV_SAMPLE_FMT_S16P ||
+                   config.fmt == AV_SAMPLE_FMT_S32P);
+  layout.channels = config.channels;
+  return config.channels > 0 && config.channels <= AE_CH_MAX;
+}
+
+void CActiveAEResampleDirect::Convert(uint8_t **dst, int dstOffset, uint8_t * const *src, int srcOffset, int samples)
+{
+  // same channels and packing, whole planes at once
+  if (m_identity && m_src.planar == m_dst.planar)
+  {
+    int planes = m_dst.planar ? m_dst.channels : 1;
+    int channels = m_dst.planar ? 1 : m_dst.channels;
+    for (int i = 0; i < planes; i++)
+    {
+      ConvertChannel(dst[i] + dstOffset * channels * m_dst.bytes, 1,
+                     src[i] + srcOffset * channels * m_src.bytes, 1,
+                     samples * channels);
+    }
+    return;
+  }
+
+  // common stereo float between planar and packed
+  if (m_identity && m_dst.channels == 2 && m_src.type == SAMPLE_FLOAT && m_dst.type == SAMPLE_FLOAT)
+  {
+    const CAEKernels::SKernels& kernels = CAEKernels::Get();
+    if (m_dst.planar)
+    {
+      kernels.Deinterleave2(reinterpret_cast<float*>(dst[0]) + dstOffset,
+                            reinterpret_cast<float*>(dst[1]) + dstOffset,
+                            reinterpret_cast<const float*>(src[0]) + srcOffset * 2, samples);
+    }
+    else
+    {
+      kernels.Interleave2(reinterpret_cast<float*>(dst[0]) + dstOffset * 2,
+                          reinterpret_cast<const float*>(src[0]) + srcOffset,
+                          reinterpret_cast<const float*>(src[1]) + srcOffset, samples);
+    }
+    return;
+  }
+
+  for (int out = 0; out < m_dst.channels; out++)
+  {
+    uint8_t *dstChannel;
+    int dstStride;
+    if (m_dst.planar)
+    {
+      dstChannel = dst[out] + dstOffset * m_dst.bytes;
+      dstStride = 1;
+    }
+    else
+    {
+      dstChannel = dst[0] + (dstOffset * m_dst.channels + out) * m_dst.bytes;
+      dstStride = m_dst.channels;
+    }
+
+    int in = m_map[out];
+    if (in < 0)
+    {
+      for (int i = 0; i < samples; i++)
+        memset(dstChannel + i * dstStride * m_dst.bytes, 0, m_dst.bytes);
+      continue;
+    }
+
+    const uint8_t *srcChannel;
+    int srcStride;
+    if (m_src.planar)
+    {
+      srcChannel = src[in] + srcOffset * m_src.bytes;
+      srcStride = 1;
+    }
+    else
+    {
+      srcChannel = src[0] + (srcOffset * m_src.channels + in) * m_src.bytes;
+      srcStride = m_src.channels;
+    }
+
+    ConvertChannel(dstChannel, dstStride, srcChannel, srcStride, samples);
+  }
+}
+
+void CActiveAEResampleDirect::ConvertChannel(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int samples)
+{
+  if (dstStride == 1 && srcStride == 1)
+  {
+    const CAEKernels::SKernels& kernels = CAEKernels::Get();
+    if (m_src.type == m_dst.type)
+    {
+      memcpy(dst, src, samples * m_dst.bytes);
+      return;
+    }
+    else if (m_src.type == SAMPLE_FLOAT && m_dst.type == SAMPLE_S16)
+    {
+      kernels.FloatToS16(reinterpret_cast<int16_t*>(dst), reinterpret_cast<const float*>(src), samples);
+      return;
+    }
+    else if (m_src.type == SAMPLE_FLOAT && m_dst.type == SAMPLE_S32)
+    {
+      kernels.FloatToS32(reinterpret_cast<int32_t*>(dst), reinterpret_cast<const float*>(src), samples);
+      return;
+    }
+    else if (m_src.type == SAMPLE_S16 && m_dst.type == SAMPLE_FLOAT)
+    {
+      kernels.S16ToFloat(reinterpret_cast<float*>(dst), reinterpret_cast<const int16_t*>(src), samples);
+      return;
+    }
+    else if (m_src.type == SAMPLE_S32 && m_dst.type == SAMPLE_FLOAT)
+    {
+      kernels.S32ToFloat(reinterpret_cast<float*>(dst), reinterpret_cast<const int32_t*>(src), samples);
+      return;
+    }
+  }
+
+  switch (m_src.type)
+  {
+    case SAMPLE_FLOAT:
+      if (m_dst.type == SAMPLE_FLOAT)
+        ConvertStrided<float, float>(dst, dstStride, src, srcStride, samples, Copy<float>);
+      else if (m_dst.type == SAMPLE_S16)
+        ConvertStrided<int16_t, float>(dst, dstStride, src, srcStride, samples, CAEKernels::ToS16);
+      else
+        ConvertStrided<int32_t, float>(dst, dstStride, src, srcStride, samples, CAEKernels::ToS32);
+      break;
+    case SAMPLE_S16:
+      if (m_dst.type == SAMPLE_FLOAT)
+        ConvertStrided<float, int16_t>(dst, dstStride, src, srcStride, samples, S16ToFloat);
+      else if (m_dst.type == SAMPLE_S16)
+        ConvertStrided<int16_t, int16_t>(dst, dstStride, src, srcStride, samples, Copy<int16_t>);
+      else
+        ConvertStrided<int32_t, int16_t>(dst, dstStride, src, srcStride, samples, S16ToS32);
+      break;
+    case SAMPLE_S32:
+      if (m_dst.type == SAMPLE_FLOAT)
+        ConvertStrided<float, int32_t>(dst, dstStride, src, srcStride, samples, S32ToFloat);
+      else if (m_dst.type == SAMPLE_S16)
+        ConvertStrided<int16_t, int32_t>(dst, dstStride, src, srcStride, samples, S32ToS16);
+      else
+        ConvertStrided<int32_t, int32_t>(dst, dstStride, src, srcStride, samples, Copy<int32_t>);
+      break;
+  }
+}
+
+void CActiveAEResampleDirect::Store(uint8_t **src, int srcOffset, int samples)
+{
+  int planes = m_src.planar ? m_src.channels : 1;
+  int frameBytes = m_src.planar ? m_src.bytes : m_src.bytes * m_src.channels;
+
+  m_pending.resize(planes);
+  for (int i = 0; i < planes; i++)
+  {
+    const uint8_t *begin = src[i] + srcOffset * frameBytes;
+    m_pending[i].insert(m_pending[i].end(), begin, begin + samples * frameBytes);
+  }
+  m_pendingSamples += samples;
+}
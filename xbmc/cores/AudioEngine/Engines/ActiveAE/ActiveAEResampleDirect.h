@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AE.h"
+#include "cores/AudioEngine/Interfaces/AEResample.h"
+#include "cores/AudioEngine/Utils/AEChannelInfo.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace ActiveAE
+{
+
+/*!
+ \brief Converts between formats of the same sample rate without swresample.
+
+ Handles identical formats, changes between planar and packed, float to and
+ from S16/S32 and the one to one channel mapping of the sink stage. Init
+ fails for everything else, the caller has to use a real resampler then.
+ Results match swresample, except that float samples at full scale become the
+ largest S32 a float can hold.
+ */
+class CActiveAEResampleDirect : public IAEResample
+{
+public:
+  const char *GetName() override { return "ActiveAEResampleDirect"; }
+  CActiveAEResampleDirect() = default;
+  ~CActiveAEResampleDirect() override = default;
+  bool Init(SampleConfig dstConfig, SampleConfig srcConfig, bool upmix, bool normalize, double centerMix,
+            CAEChannelInfo *remapLayout, AEQuality quality, bool force_resample) override;
+  int Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio) override;
+  int64_t GetDelay(int64_t base) override;
+  int GetBufferedSamples() override { return m_pendingSamples; }
+  bool WantsNewSamples(int samples) override { return GetBufferedSamples() <= samples * 2; }
+  int CalcDstSampleCount(int src_samples, int dst_rate, int src_rate) override;
+  int GetSrcBufferSize(int samples) override;
+  int GetDstBufferSize(int samples) override;
+
+protected:
+  enum SampleType
+  {
+    SAMPLE_FLOAT,
+    SAMPLE_S16,
+    SAMPLE_S32
+  };
+
+  struct Layout
+  {
+    SampleType type;
+    bool planar;
+    int channels;
+    int bytes;
+  };
+
+  static bool GetLayout(const SampleConfig &config, Layout &layout);
+  void Convert(uint8_t **dst, int dstOffset, uint8_t * const *src, int srcOffset, int samples);
+  void ConvertChannel(uint8_t *dst, int dstStride, const uint8_t *src, int srcStride, int samples);
+  void Store(uint8_t **src, int srcOffset, int samples);
+
+  Layout m_src;
+  Layout m_dst;
+  int m_rate = 0;
+  bool m_identity = true;
+  std::vector<int> m_map;   // source channel of every destination channel, -1 for silence
+
+  // input that did not fit into the output, swresample buffers it too
+  std::vector<std::vector<uint8_t>> m_pending;
+  int m_pendingSamples = 0;
+};
+
+}
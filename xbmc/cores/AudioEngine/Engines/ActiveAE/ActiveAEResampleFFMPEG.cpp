@@ -45,15 +45,23 @@ bool CActiveAEResampleFFMPEG::Init(SampleConfig dstConfig, SampleConfig srcConfi
   m_src_bits = srcConfig.bits_per_sample;
   m_src_dither_bits = srcConfig.dither_bits;
 
-  if (m_src_rate != m_dst_rate)
-    m_doesResample = true;
+  m_doesResample = (m_src_rate != m_dst_rate);
 
   if (m_dst_chan_layout == 0)
     m_dst_chan_layout = av_get_default_channel_layout(m_dst_channels);
   if (m_src_chan_layout == 0)
     m_src_chan_layout = av_get_default_channel_layout(m_src_channels);
 
-  m_pContext = swr_alloc_set_opts(NULL, m_dst_chan_layout, m_dst_fmt, m_dst_rate,
+  // init again with the same config, swr_init keeps the filters of the
+  // resampler but the matrix can only be set on a closed context
+  if (m_pContext)
+  {
+    swr_close(m_pContext);
+    // set by compensation
+    av_opt_set_int(m_pContext, "flags", 0, 0);
+  }
+
+  m_pContext = swr_alloc_set_opts(m_pContext, m_dst_chan_layout, m_dst_fmt, m_dst_rate,
                                                         m_src_chan_layout, m_src_fmt, m_src_rate,
                                                         0, NULL);
 
@@ -0,0 +1,151 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEResampleDirect.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+SampleConfig MakeConfig(AEDataFormat format, const CAEChannelInfo& layout, int rate = 48000)
+{
+  SampleConfig config;
+  config.fmt = CAEUtil::GetAVSampleFormat(format);
+  config.channel_layout = CAEUtil::GetAVChannelLayout(layout);
+  config.channels = layout.Count();
+  config.sample_rate = rate;
+  config.bits_per_sample = CAEUtil::DataFormatToUsedBits(format);
+  config.dither_bits = CAEUtil::DataFormatToDitherBits(format);
+  return config;
+}
+
+bool Init(CActiveAEResampleDirect& resampler, const SampleConfig& dst, const SampleConfig& src,
+          CAEChannelInfo* remapLayout = nullptr, bool force = false)
+{
+  return resampler.Init(dst, src, false, true, 1.0, remapLayout, AE_QUALITY_MID, force);
+}
+} // namespace
+
+TEST(TestActiveAEResampleDirect, Unsupported)
+{
+  CAEChannelInfo stereo(AE_CH_LAYOUT_2_0);
+  CAEChannelInfo surround(AE_CH_LAYOUT_5_1);
+  CActiveAEResampleDirect resampler;
+
+  EXPECT_FALSE(Init(resampler, MakeConfig(AE_FMT_FLOAT, stereo, 48000), MakeConfig(AE_FMT_FLOAT, stereo, 44100)));
+  EXPECT_FALSE(Init(resampler, MakeConfig(AE_FMT_FLOAT, stereo), MakeConfig(AE_FMT_FLOAT, stereo), nullptr, true));
+  EXPECT_FALSE(Init(resampler, MakeConfig(AE_FMT_FLOAT, stereo), MakeConfig(AE_FMT_FLOAT, surround)));
+  EXPECT_FALSE(Init(resampler, MakeConfig(AE_FMT_S24NE4MSB, stereo), MakeConfig(AE_FMT_FLOAT, stereo)));
+  EXPECT_TRUE(Init(resampler, MakeConfig(AE_FMT_S32NE, stereo), MakeConfig(AE_FMT_FLOATP, stereo)));
+}
+
+TEST(TestActiveAEResampleDirect, PlanarFloatToS16)
+{
+  CAEChannelInfo stereo(AE_CH_LAYOUT_2_0);
+  CActiveAEResampleDirect resampler;
+  ASSERT_TRUE(Init(resampler, MakeConfig(AE_FMT_S16NE, stereo), MakeConfig(AE_FMT_FLOATP, stereo)));
+
+  const int frames = 37;
+  std::vector<float> left(frames), right(frames);
+  for (int i = 0; i < frames; i++)
+  {
+    left[i] = (i - frames / 2) / 16.0f;
+    right[i] = -left[i] / 3.0f;
+  }
+  std::vector<int16_t> out(frames * 2);
+
+  uint8_t* src[] = {reinterpret_cast<uint8_t*>(left.data()), reinterpret_cast<uint8_t*>(right.data())};
+  uint8_t* dst[] = {reinterpret_cast<uint8_t*>(out.data())};
+  ASSERT_EQ(frames, resampler.Resample(dst, frames, src, frames, 1.0));
+
+  for (int i = 0; i < frames; i++)
+  {
+    EXPECT_EQ(CAEKernels::ToS16(left[i]), out[2 * i]);
+    EXPECT_EQ(CAEKernels::ToS16(right[i]), out[2 * i + 1]);
+  }
+}
+
+TEST(TestActiveAEResampleDirect, Remap)
+{
+  CAEChannelInfo surround(AE_CH_LAYOUT_5_1);
+  CAEChannelInfo sink;
+  sink += AE_CH_FR;
+  sink += AE_CH_FL;
+  sink += AE_CH_BC;
+  sink += AE_CH_LFE;
+
+  CActiveAEResampleDirect resampler;
+  ASSERT_TRUE(Init(resampler, MakeConfig(AE_FMT_FLOAT, sink), MakeConfig(AE_FMT_FLOAT, surround), &sink));
+
+  // the samples of a channel are its index in the order of ffmpeg
+  const int frames = 5;
+  const int channels = surround.Count();
+  std::vector<float> in(frames * channels);
+  for (int i = 0; i < frames; i++)
+  {
+    for (int ch = 0; ch < channels; ch++)
+      in[i * channels + ch] = ch + 1;
+  }
+  std::vector<float> out(frames * sink.Count(), -1.0f);
+
+  uint8_t* src[] = {reinterpret_cast<uint8_t*>(in.data())};
+  uint8_t* dst[] = {reinterpret_cast<uint8_t*>(out.data())};
+  ASSERT_EQ(frames, resampler.Resample(dst, frames, src, frames, 1.0));
+
+  const uint64_t layout = CAEUtil::GetAVChannelLayout(surround);
+  for (int i = 0; i < frames; i++)
+  {
+    EXPECT_EQ(CAEUtil::GetAVChannelIndex(AE_CH_FR, layout) + 1, out[i * 4 + 0]);
+    EXPECT_EQ(CAEUtil::GetAVChannelIndex(AE_CH_FL, layout) + 1, out[i * 4 + 1]);
+    EXPECT_EQ(0.0f, out[i * 4 + 2]);
+    EXPECT_EQ(CAEUtil::GetAVChannelIndex(AE_CH_LFE, layout) + 1, out[i * 4 + 3]);
+  }
+}
+
+TEST(TestActiveAEResampleDirect, Pending)
+{
+  CAEChannelInfo stereo(AE_CH_LAYOUT_2_0);
+  CActiveAEResampleDirect resampler;
+  ASSERT_TRUE(Init(resampler, MakeConfig(AE_FMT_FLOATP, stereo), MakeConfig(AE_FMT_FLOAT, stereo)));
+
+  const int frames = 10;
+  std::vector<float> in(frames * 2);
+  for (int i = 0; i < frames * 2; i++)
+    in[i] = i;
+  std::vector<float> left(frames), right(frames);
+
+  // input that does not fit is kept for the next call
+  uint8_t* src[] = {reinterpret_cast<uint8_t*>(in.data())};
+  uint8_t* dst[] = {reinterpret_cast<uint8_t*>(left.data()), reinterpret_cast<uint8_t*>(right.data())};
+  ASSERT_EQ(4, resampler.Resample(dst, 4, src, frames, 1.0));
+  EXPECT_EQ(6, resampler.GetBufferedSamples());
+
+  uint8_t* rest[] = {reinterpret_cast<uint8_t*>(left.data() + 4), reinterpret_cast<uint8_t*>(right.data() + 4)};
+  ASSERT_EQ(6, resampler.Resample(rest, frames, nullptr, 0, 1.0));
+  EXPECT_EQ(0, resampler.GetBufferedSamples());
+
+  for (int i = 0; i < frames; i++)
+  {
+    EXPECT_EQ(in[2 * i], left[i]);
+    EXPECT_EQ(in[2 * i + 1], right[i]);
+  }
+
+  // the rate is adjusted by a real resampler, pending input is drained first
+  ASSERT_EQ(4, resampler.Resample(dst, 4, src, frames, 1.0));
+  EXPECT_EQ(-1, resampler.Resample(rest, frames, src, frames, 1.01));
+  EXPECT_EQ(6, resampler.Resample(rest, frames, nullptr, 0, 1.01));
+  EXPECT_EQ(0, resampler.GetBufferedSamples());
+  EXPECT_EQ(in[2 * 4], left[4]);
+  EXPECT_EQ(0, resampler.Resample(rest, frames, nullptr, 0, 1.01));
+}
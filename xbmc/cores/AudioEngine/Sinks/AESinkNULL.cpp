@@ -0,0 +1,190 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkNULL.h"
+
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/XTimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <limits.h>
+
+#define NULL_PERIODS 4
+
+CAESinkNULL::~CAESinkNULL()
+{
+  Deinitialize();
+}
+
+void CAESinkNULL::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "NULL";
+  entry.createFunc = CAESinkNULL::Create;
+  entry.enumerateFunc = CAESinkNULL::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkNULL::Create(std::string &device, AEAudioFormat& desiredFormat)
+{
+  IAESink* sink = new CAESinkNULL();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
+{
+  Deinitialize();
+
+  if (format.m_sampleRate == 0 || format.m_channelLayout.Count() == 0)
+    return false;
+
+  if (format.m_dataFormat == AE_FMT_RAW)
+  {
+    // iec bursts are carried in 16 bit frames
+    format.m_frameSize = format.m_channelLayout.Count() * 2;
+  }
+  else
+  {
+    // samples are stored interleaved
+    if (format.m_dataFormat != AE_FMT_S16NE &&
+        format.m_dataFormat != AE_FMT_S32NE &&
+        format.m_dataFormat != AE_FMT_FLOAT)
+      format.m_dataFormat = AE_FMT_FLOAT;
+    format.m_frameSize = format.m_channelLayout.Count() *
+                         (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3);
+  }
+
+  // a period of 20ms unless a smaller one is requested
+  if (format.m_frames == 0)
+    format.m_frames = format.m_sampleRate / 50;
+
+  if (device != "null" && !device.empty())
+  {
+    if (!m_file.OpenForWrite(device, true))
+    {
+      CLog::Log(LOGERROR, "CAESinkNULL::%s - failed to open %s", __FUNCTION__, device.c_str());
+      return false;
+    }
+    m_writeFile = true;
+  }
+
+  m_format = format;
+  m_cacheTotal = static_cast<double>(NULL_PERIODS * format.m_frames) / format.m_sampleRate;
+  m_buffered = 0.0;
+  m_lastUpdate = std::chrono::steady_clock::now();
+  m_framesWritten = 0;
+
+  CLog::Log(LOGINFO, "CAESinkNULL::%s - %s, %s, %u Hz, %u frames", __FUNCTION__,
+            m_writeFile ? device.c_str() : "discarding samples",
+            CAEUtil::DataFormatToStr(format.m_dataFormat), format.m_sampleRate, format.m_frames);
+  return true;
+}
+
+void CAESinkNULL::Deinitialize()
+{
+  if (m_writeFile)
+  {
+    m_file.Close();
+    m_writeFile = false;
+  }
+  m_buffered = 0.0;
+}
+
+void CAESinkNULL::UpdateBuffered()
+{
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  double played = std::chrono::duration<double>(now - m_lastUpdate).count();
+  m_buffered = std::max(m_buffered - played, 0.0);
+  m_lastUpdate = now;
+}
+
+void CAESinkNULL::GetDelay(AEDelayStatus& status)
+{
+  if (!m_realtime)
+  {
+    status.SetDelay(0);
+    return;
+  }
+
+  UpdateBuffered();
+  status.SetDelay(m_buffered);
+}
+
+unsigned int CAESinkNULL::AddPackets(uint8_t **data, unsigned int frames, unsigned int offset)
+{
+  if (m_writeFile && frames)
+  {
+    size_t size = static_cast<size_t>(frames) * m_format.m_frameSize;
+    if (m_file.Write(data[0] + offset * m_format.m_frameSize, size) != static_cast<ssize_t>(size))
+    {
+      CLog::Log(LOGERROR, "CAESinkNULL::%s - write failed", __FUNCTION__);
+      return INT_MAX;
+    }
+  }
+  m_framesWritten += frames;
+
+  if (m_realtime)
+  {
+    // block like a device with a full buffer
+    UpdateBuffered();
+    double wait = m_buffered - (m_cacheTotal - static_cast<double>(m_format.m_frames) / m_format.m_sampleRate);
+    if (wait > 0.0)
+    {
+      KODI::TIME::Sleep(static_cast<unsigned int>(wait * 1000.0));
+      UpdateBuffered();
+    }
+    m_buffered += static_cast<double>(frames) / m_format.m_sampleRate;
+  }
+
+  return frames;
+}
+
+void CAESinkNULL::AddPause(unsigned int millis)
+{
+  if (m_realtime)
+  {
+    UpdateBuffered();
+    m_buffered += millis / 1000.0;
+  }
+}
+
+void CAESinkNULL::Drain()
+{
+  if (m_realtime)
+  {
+    UpdateBuffered();
+    KODI::TIME::Sleep(static_cast<unsigned int>(m_buffered * 1000.0));
+  }
+  m_buffered = 0.0;
+}
+
+void CAESinkNULL::EnumerateDevicesEx(AEDeviceInfoList &list, bool force)
+{
+  CAEDeviceInfo info;
+  info.m_deviceName = "null";
+  info.m_displayName = "Null";
+  info.m_displayNameExtra = "discards all audio";
+  info.m_deviceType = AE_DEVTYPE_HDMI;
+  info.m_channels = CAEChannelInfo(AE_CH_LAYOUT_7_1);
+  info.m_sampleRates = {32000, 44100, 48000, 88200, 96000, 176400, 192000};
+  info.m_dataFormats = {AE_FMT_FLOAT, AE_FMT_S32NE, AE_FMT_S16NE, AE_FMT_RAW};
+  info.m_streamTypes = {CAEStreamInfo::STREAM_TYPE_AC3,
+                        CAEStreamInfo::STREAM_TYPE_EAC3,
+                        CAEStreamInfo::STREAM_TYPE_DTSHD_CORE,
+                        CAEStreamInfo::STREAM_TYPE_DTS_512,
+                        CAEStreamInfo::STREAM_TYPE_DTS_1024,
+                        CAEStreamInfo::STREAM_TYPE_DTS_2048};
+  info.m_wantsIECPassthrough = true;
+  list.push_back(info);
+}
@@ -0,0 +1,61 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+#include "filesystem/File.h"
+
+#include <chrono>
+#include <stdint.h>
+
+/*!
+ \brief Sink without audio hardware, for headless systems and benchmarks.
+
+ The device "null" discards all samples, any other device is the path of a
+ file the raw interleaved samples are written to. By default the sink consumes
+ samples at the pace of real playback, with realtime disabled it takes them
+ as fast as they arrive.
+ */
+class CAESinkNULL : public IAESink
+{
+public:
+  const char *GetName() override { return "NULL"; }
+
+  CAESinkNULL() = default;
+  ~CAESinkNULL() override;
+
+  static void Register();
+  static IAESink* Create(std::string &device, AEAudioFormat &desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
+
+  bool Initialize(AEAudioFormat &format, std::string &device) override;
+  void Deinitialize() override;
+
+  void GetDelay(AEDelayStatus& status) override;
+  double GetCacheTotal() override { return m_realtime ? m_cacheTotal : 0.0; }
+  unsigned int AddPackets(uint8_t **data, unsigned int frames, unsigned int offset) override;
+  void AddPause(unsigned int millis) override;
+  void Drain() override;
+
+  void SetRealtime(bool realtime) { m_realtime = realtime; }
+  uint64_t GetFramesWritten() const { return m_framesWritten; }
+
+private:
+  void UpdateBuffered();
+
+  AEAudioFormat m_format;
+  XFILE::CFile m_file;
+  bool m_writeFile = false;
+  bool m_realtime = true;
+  double m_cacheTotal = 0.0;
+  double m_buffered = 0.0;     // seconds of audio not yet "played"
+  std::chrono::steady_clock::time_point m_lastUpdate;
+  uint64_t m_framesWritten = 0;
+};
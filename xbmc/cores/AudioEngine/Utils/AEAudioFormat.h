@@ -34,7 +34,8 @@ struct AEAudioFormat
   CAEChannelInfo m_channelLayout;
 
   /**
-   * The number of frames per period
+   * The number of frames per period, when opening a sink a non zero value
+   * asks for periods of at most this size
    */
   unsigned int m_frames;
 
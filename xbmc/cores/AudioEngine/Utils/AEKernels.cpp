@@ -0,0 +1,239 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+
+#include "AEUtil.h"
+#include "ServiceBroker.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <memory>
+
+namespace
+{
+void Mul(float* data, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] *= mul;
+}
+
+void MulAdd(float* data, const float* add, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] += add[i] * mul;
+}
+
+void MulGains(float* data, const float* gains, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] *= gains[i];
+}
+
+void MulAddGains(float* data, const float* add, const float* gains, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    data[i] += add[i] * gains[i];
+}
+
+void AbsMax(float* peaks, const float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    peaks[i] = std::max(peaks[i], fabsf(data[i]));
+}
+
+void FloatToS16(int16_t* dst, const float* src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    dst[i] = CAEKernels::ToS16(src[i]);
+}
+
+void FloatToS32(int32_t* dst, const float* src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    dst[i] = CAEKernels::ToS32(src[i]);
+}
+
+void S16ToFloat(float* dst, const int16_t* src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    dst[i] = static_cast<float>(src[i]) * (1.0f / 32768.0f);
+}
+
+void S32ToFloat(float* dst, const int32_t* src, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; i++)
+    dst[i] = static_cast<float>(src[i]) * (1.0f / 2147483648.0f);
+}
+
+void Interleave2(float* dst, const float* left, const float* right, uint32_t frames)
+{
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    dst[2 * i] = left[i];
+    dst[2 * i + 1] = right[i];
+  }
+}
+
+void Deinterleave2(float* left, float* right, const float* src, uint32_t frames)
+{
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    left[i] = src[2 * i];
+    right[i] = src[2 * i + 1];
+  }
+}
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+void SSEMul(float* data, float mul, uint32_t count)
+{
+  CAEUtil::SSEMulArray(data, mul, count);
+}
+
+void SSEMulAdd(float* data, const float* add, float mul, uint32_t count)
+{
+  CAEUtil::SSEMulAddArray(data, const_cast<float*>(add), mul, count);
+}
+#endif
+
+const CAEKernels::SKernels scalarKernels =
+{
+  Mul,
+  MulAdd,
+  MulGains,
+  MulAddGains,
+  AbsMax,
+  FloatToS16,
+  FloatToS32,
+  S16ToFloat,
+  S32ToFloat,
+  Interleave2,
+  Deinterleave2
+};
+
+unsigned int GetCPUFeatures()
+{
+  std::shared_ptr<CCPUInfo> cpuInfo = CServiceBroker::GetCPUInfo();
+  if (!cpuInfo)
+    cpuInfo = CCPUInfo::GetCPUInfo();
+  return cpuInfo->GetCPUFeatures();
+}
+} // namespace
+
+const CAEKernels::SKernels& CAEKernels::Get()
+{
+  static const SKernels* kernels = Get(GetType());
+  return *kernels;
+}
+
+CAEKernels::Type CAEKernels::GetType()
+{
+  static const Type type = Select();
+  return type;
+}
+
+const CAEKernels::SKernels* CAEKernels::Get(Type type)
+{
+  static const std::vector<const SKernels*> tables = CreateTables();
+
+  if (type < 0 || type >= TYPE_COUNT)
+    return nullptr;
+  return tables[type];
+}
+
+const char* CAEKernels::TypeToStr(Type type)
+{
+  switch (type)
+  {
+    case SCALAR:
+      return "scalar";
+    case SSE:
+      return "sse";
+    case AVX2:
+      return "avx2";
+    case NEON:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
+
+CAEKernels::Type CAEKernels::Select()
+{
+  Type type = SCALAR;
+  for (int i = TYPE_COUNT - 1; i > SCALAR; i--)
+  {
+    if (Get(static_cast<Type>(i)))
+    {
+      type = static_cast<Type>(i);
+      break;
+    }
+  }
+
+  CLog::Log(LOGINFO, "CAEKernels::%s - using %s sample kernels", __FUNCTION__, TypeToStr(type));
+  return type;
+}
+
+std::vector<const CAEKernels::SKernels*> CAEKernels::CreateTables()
+{
+  std::vector<const SKernels*> tables(TYPE_COUNT, nullptr);
+  const unsigned int features = GetCPUFeatures();
+
+  tables[SCALAR] = &scalarKernels;
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+  static SKernels sseKernels = scalarKernels;
+  sseKernels.Mul = SSEMul;
+  sseKernels.MulAdd = SSEMulAdd;
+  tables[SSE] = &sseKernels;
+#endif
+
+  static SKernels avx2Kernels = scalarKernels;
+  if ((features & CPU_FEATURE_AVX2) && InitAVX2(avx2Kernels))
+    tables[AVX2] = &avx2Kernels;
+
+  static SKernels neonKernels = scalarKernels;
+  if ((features & CPU_FEATURE_NEON) && InitNEON(neonKernels))
+    tables[NEON] = &neonKernels;
+
+  return tables;
+}
+
+void CAEKernels::Interleave(float* dst, const float* const* src, int channels, uint32_t frames)
+{
+  if (channels == 2)
+  {
+    Get().Interleave2(dst, src[0], src[1], frames);
+    return;
+  }
+
+  for (int ch = 0; ch < channels; ch++)
+  {
+    const float* plane = src[ch];
+    float* out = dst + ch;
+    for (uint32_t i = 0; i < frames; i++, out += channels)
+      *out = plane[i];
+  }
+}
+
+void CAEKernels::Deinterleave(float* const* dst, const float* src, int channels, uint32_t frames)
+{
+  if (channels == 2)
+  {
+    Get().Deinterleave2(dst[0], dst[1], src, frames);
+    return;
+  }
+
+  for (int ch = 0; ch < channels; ch++)
+  {
+    float* plane = dst[ch];
+    const float* in = src + ch;
+    for (uint32_t i = 0; i < frames; i++, in += channels)
+      plane[i] = *in;
+  }
+}
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \brief Sample processing kernels of the audio engine.
+
+ Every kernel has a portable version, the AVX2 and NEON versions are selected
+ at runtime if the cpu supports them. All versions give bit identical results
+ for finite samples: products are never fused into multiply-add and float to
+ integer conversion clamps first and then rounds to nearest even.
+ */
+class CAEKernels
+{
+public:
+  enum Type
+  {
+    SCALAR = 0,
+    SSE,
+    AVX2,
+    NEON,
+    TYPE_COUNT
+  };
+
+  struct SKernels
+  {
+    //! data[i] *= mul
+    void (*Mul)(float* data, float mul, uint32_t count);
+    //! data[i] += add[i] * mul
+    void (*MulAdd)(float* data, const float* add, float mul, uint32_t count);
+    //! data[i] *= gains[i]
+    void (*MulGains)(float* data, const float* gains, uint32_t count);
+    //! data[i] += add[i] * gains[i]
+    void (*MulAddGains)(float* data, const float* add, const float* gains, uint32_t count);
+    //! peaks[i] = max(peaks[i], |data[i]|)
+    void (*AbsMax)(float* peaks, const float* data, uint32_t count);
+
+    void (*FloatToS16)(int16_t* dst, const float* src, uint32_t count);
+    void (*FloatToS32)(int32_t* dst, const float* src, uint32_t count);
+    void (*S16ToFloat)(float* dst, const int16_t* src, uint32_t count);
+    void (*S32ToFloat)(float* dst, const int32_t* src, uint32_t count);
+
+    void (*Interleave2)(float* dst, const float* left, const float* right, uint32_t frames);
+    void (*Deinterleave2)(float* left, float* right, const float* src, uint32_t frames);
+  };
+
+  /*!
+   \brief The kernels of the best type the cpu supports.
+   */
+  static const SKernels& Get();
+  static Type GetType();
+
+  /*!
+   \brief The kernels of a type, for comparing them.
+   \return nullptr if the type is not built in or not supported by the cpu
+   */
+  static const SKernels* Get(Type type);
+  static const char* TypeToStr(Type type);
+
+  /*!
+   \brief Planes to interleaved frames of any number of channels.
+   */
+  static void Interleave(float* dst, const float* const* src, int channels, uint32_t frames);
+  static void Deinterleave(float* const* dst, const float* src, int channels, uint32_t frames);
+
+  static inline int16_t ToS16(float sample)
+  {
+    return static_cast<int16_t>(lrintf(std::min(std::max(sample * 32768.0f, -32768.0f), 32767.0f)));
+  }
+
+  static inline int32_t ToS32(float sample)
+  {
+    // 2147483520 is the largest float below 2^31
+    return static_cast<int32_t>(lrintf(std::min(std::max(sample * 2147483648.0f, -2147483648.0f), 2147483520.0f)));
+  }
+
+private:
+  static Type Select();
+  static std::vector<const SKernels*> CreateTables();
+
+  // fill in the kernels of the instruction set, false if not built in
+  static bool InitAVX2(SKernels& kernels);
+  static bool InitNEON(SKernels& kernels);
+};
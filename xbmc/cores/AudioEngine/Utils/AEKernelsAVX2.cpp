@@ -0,0 +1,225 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+
+// this file is built with AVX2 enabled if the compiler supports it, its
+// kernels are only called after checking the cpu
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace
+{
+// inline functions and templates of other headers must not be instantiated
+// here, the linker may pick the AVX2 copy for the whole program
+inline float Min(float a, float b)
+{
+  return b < a ? b : a;
+}
+
+inline float Max(float a, float b)
+{
+  return a < b ? b : a;
+}
+
+int16_t ToS16(float sample)
+{
+  return static_cast<int16_t>(lrintf(Min(Max(sample * 32768.0f, -32768.0f), 32767.0f)));
+}
+
+int32_t ToS32(float sample)
+{
+  return static_cast<int32_t>(lrintf(Min(Max(sample * 2147483648.0f, -2147483648.0f), 2147483520.0f)));
+}
+
+void Mul(float* data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  for (; i < count; i++)
+    data[i] *= mul;
+}
+
+void MulAdd(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 product = _mm256_mul_ps(_mm256_loadu_ps(add + i), m);
+    _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i), product));
+  }
+  for (; i < count; i++)
+    data[i] += add[i] * mul;
+}
+
+void MulGains(float* data, const float* gains, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_loadu_ps(gains + i)));
+  for (; i < count; i++)
+    data[i] *= gains[i];
+}
+
+void MulAddGains(float* data, const float* add, const float* gains, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 product = _mm256_mul_ps(_mm256_loadu_ps(add + i), _mm256_loadu_ps(gains + i));
+    _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i), product));
+  }
+  for (; i < count; i++)
+    data[i] += add[i] * gains[i];
+}
+
+void AbsMax(float* peaks, const float* data, uint32_t count)
+{
+  const __m256 abs = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256 sample = _mm256_and_ps(_mm256_loadu_ps(data + i), abs);
+    _mm256_storeu_ps(peaks + i, _mm256_max_ps(_mm256_loadu_ps(peaks + i), sample));
+  }
+  for (; i < count; i++)
+    peaks[i] = Max(peaks[i], fabsf(data[i]));
+}
+
+void FloatToS16(int16_t* dst, const float* src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(32768.0f);
+  const __m256 low = _mm256_set1_ps(-32768.0f);
+  const __m256 high = _mm256_set1_ps(32767.0f);
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256 a = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+    __m256 b = _mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale);
+    a = _mm256_min_ps(_mm256_max_ps(a, low), high);
+    b = _mm256_min_ps(_mm256_max_ps(b, low), high);
+    // packs works within the 128 bit lanes, put the quad words back in order
+    const __m256i packed = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(packed, 0xD8));
+  }
+  for (; i < count; i++)
+    dst[i] = ToS16(src[i]);
+}
+
+void FloatToS32(int32_t* dst, const float* src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(2147483648.0f);
+  const __m256 low = _mm256_set1_ps(-2147483648.0f);
+  const __m256 high = _mm256_set1_ps(2147483520.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 a = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+    a = _mm256_min_ps(_mm256_max_ps(a, low), high);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtps_epi32(a));
+  }
+  for (; i < count; i++)
+    dst[i] = ToS32(src[i]);
+}
+
+void S16ToFloat(float* dst, const int16_t* src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m256 a = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(samples));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(a, scale));
+  }
+  for (; i < count; i++)
+    dst[i] = static_cast<float>(src[i]) * (1.0f / 32768.0f);
+}
+
+void S32ToFloat(float* dst, const int32_t* src, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / 2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(samples), scale));
+  }
+  for (; i < count; i++)
+    dst[i] = static_cast<float>(src[i]) * (1.0f / 2147483648.0f);
+}
+
+void Interleave2(float* dst, const float* left, const float* right, uint32_t frames)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= frames; i += 8)
+  {
+    const __m256 l = _mm256_loadu_ps(left + i);
+    const __m256 r = _mm256_loadu_ps(right + i);
+    // l0 r0 l1 r1 | l4 r4 l5 r5 and l2 r2 l3 r3 | l6 r6 l7 r7
+    const __m256 lo = _mm256_unpacklo_ps(l, r);
+    const __m256 hi = _mm256_unpackhi_ps(l, r);
+    _mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+  }
+  for (; i < frames; i++)
+  {
+    dst[2 * i] = left[i];
+    dst[2 * i + 1] = right[i];
+  }
+}
+
+void Deinterleave2(float* left, float* right, const float* src, uint32_t frames)
+{
+  uint32_t i = 0;
+  for (; i + 8 <= frames; i += 8)
+  {
+    const __m256 a = _mm256_loadu_ps(src + 2 * i);
+    const __m256 b = _mm256_loadu_ps(src + 2 * i + 8);
+    // l0 r0 l1 r1 | l4 r4 l5 r5 and l2 r2 l3 r3 | l6 r6 l7 r7
+    const __m256 lo = _mm256_permute2f128_ps(a, b, 0x20);
+    const __m256 hi = _mm256_permute2f128_ps(a, b, 0x31);
+    _mm256_storeu_ps(left + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+    _mm256_storeu_ps(right + i, _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+  }
+  for (; i < frames; i++)
+  {
+    left[i] = src[2 * i];
+    right[i] = src[2 * i + 1];
+  }
+}
+} // namespace
+
+bool CAEKernels::InitAVX2(SKernels& kernels)
+{
+  kernels.Mul = Mul;
+  kernels.MulAdd = MulAdd;
+  kernels.MulGains = MulGains;
+  kernels.MulAddGains = MulAddGains;
+  kernels.AbsMax = AbsMax;
+  kernels.FloatToS16 = FloatToS16;
+  kernels.FloatToS32 = FloatToS32;
+  kernels.S16ToFloat = S16ToFloat;
+  kernels.S32ToFloat = S32ToFloat;
+  kernels.Interleave2 = Interleave2;
+  kernels.Deinterleave2 = Deinterleave2;
+  return true;
+}
+
+#else
+
+bool CAEKernels::InitAVX2(SKernels& kernels)
+{
+  return false;
+}
+
+#endif
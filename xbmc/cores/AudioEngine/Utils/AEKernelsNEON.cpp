@@ -0,0 +1,196 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEKernels.h"
+
+// armv7 NEON flushes denormals to zero, results match the portable versions
+// for normal samples only there
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+namespace
+{
+void Mul(float* data, float mul, uint32_t count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), m));
+  for (; i < count; i++)
+    data[i] *= mul;
+}
+
+void MulAdd(float* data, const float* add, float mul, uint32_t count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    // multiply and add separately like the portable version
+    const float32x4_t product = vmulq_f32(vld1q_f32(add + i), m);
+    vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), product));
+  }
+  for (; i < count; i++)
+    data[i] += add[i] * mul;
+}
+
+void MulGains(float* data, const float* gains, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), vld1q_f32(gains + i)));
+  for (; i < count; i++)
+    data[i] *= gains[i];
+}
+
+void MulAddGains(float* data, const float* add, const float* gains, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    const float32x4_t product = vmulq_f32(vld1q_f32(add + i), vld1q_f32(gains + i));
+    vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), product));
+  }
+  for (; i < count; i++)
+    data[i] += add[i] * gains[i];
+}
+
+void AbsMax(float* peaks, const float* data, uint32_t count)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(peaks + i, vmaxq_f32(vld1q_f32(peaks + i), vabsq_f32(vld1q_f32(data + i))));
+  for (; i < count; i++)
+    peaks[i] = std::max(peaks[i], fabsf(data[i]));
+}
+
+#if defined(__aarch64__)
+// armv7 has no float to int conversion rounding to nearest, it keeps the
+// portable versions of these
+void FloatToS16(int16_t* dst, const float* src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(32768.0f);
+  const float32x4_t low = vdupq_n_f32(-32768.0f);
+  const float32x4_t high = vdupq_n_f32(32767.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    float32x4_t a = vmulq_f32(vld1q_f32(src + i), scale);
+    float32x4_t b = vmulq_f32(vld1q_f32(src + i + 4), scale);
+    a = vminq_f32(vmaxq_f32(a, low), high);
+    b = vminq_f32(vmaxq_f32(b, low), high);
+    vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b))));
+  }
+  for (; i < count; i++)
+    dst[i] = CAEKernels::ToS16(src[i]);
+}
+
+void FloatToS32(int32_t* dst, const float* src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(2147483648.0f);
+  const float32x4_t low = vdupq_n_f32(-2147483648.0f);
+  const float32x4_t high = vdupq_n_f32(2147483520.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t a = vmulq_f32(vld1q_f32(src + i), scale);
+    a = vminq_f32(vmaxq_f32(a, low), high);
+    vst1q_s32(dst + i, vcvtnq_s32_f32(a));
+  }
+  for (; i < count; i++)
+    dst[i] = CAEKernels::ToS32(src[i]);
+}
+#endif
+
+void S16ToFloat(float* dst, const int16_t* src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const int16x8_t samples = vld1q_s16(src + i);
+    const float32x4_t a = vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples)));
+    const float32x4_t b = vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples)));
+    vst1q_f32(dst + i, vmulq_f32(a, scale));
+    vst1q_f32(dst + i + 4, vmulq_f32(b, scale));
+  }
+  for (; i < count; i++)
+    dst[i] = static_cast<float>(src[i]) * (1.0f / 32768.0f);
+}
+
+void S32ToFloat(float* dst, const int32_t* src, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(1.0f / 2147483648.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(src + i)), scale));
+  for (; i < count; i++)
+    dst[i] = static_cast<float>(src[i]) * (1.0f / 2147483648.0f);
+}
+
+void Interleave2(float* dst, const float* left, const float* right, uint32_t frames)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    float32x4x2_t frame;
+    frame.val[0] = vld1q_f32(left + i);
+    frame.val[1] = vld1q_f32(right + i);
+    vst2q_f32(dst + 2 * i, frame);
+  }
+  for (; i < frames; i++)
+  {
+    dst[2 * i] = left[i];
+    dst[2 * i + 1] = right[i];
+  }
+}
+
+void Deinterleave2(float* left, float* right, const float* src, uint32_t frames)
+{
+  uint32_t i = 0;
+  for (; i + 4 <= frames; i += 4)
+  {
+    const float32x4x2_t frame = vld2q_f32(src + 2 * i);
+    vst1q_f32(left + i, frame.val[0]);
+    vst1q_f32(right + i, frame.val[1]);
+  }
+  for (; i < frames; i++)
+  {
+    left[i] = src[2 * i];
+    right[i] = src[2 * i + 1];
+  }
+}
+} // namespace
+
+bool CAEKernels::InitNEON(SKernels& kernels)
+{
+  kernels.Mul = Mul;
+  kernels.MulAdd = MulAdd;
+  kernels.MulGains = MulGains;
+  kernels.MulAddGains = MulAddGains;
+  kernels.AbsMax = AbsMax;
+#if defined(__aarch64__)
+  kernels.FloatToS16 = FloatToS16;
+  kernels.FloatToS32 = FloatToS32;
+#endif
+  kernels.S16ToFloat = S16ToFloat;
+  kernels.S32ToFloat = S32ToFloat;
+  kernels.Interleave2 = Interleave2;
+  kernels.Deinterleave2 = Deinterleave2;
+  return true;
+}
+
+#else
+
+bool CAEKernels::InitNEON(SKernels& kernels)
+{
+  return false;
+}
+
+#endif
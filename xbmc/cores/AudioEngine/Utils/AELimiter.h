@@ -21,6 +21,8 @@ class CAELimiter
     int   m_holdcounter;
     float m_increase;
 
+    float Gain(float highest);
+
   public:
     CAELimiter();
 
@@ -40,4 +42,10 @@ class CAELimiter
     }
 
     float Run(float* frame[AE_CH_MAX], int channels, int offset = 0, bool planar = false);
+
+    /*!
+     \brief Gains of a block of frames, same as calling Run for each frame
+     \param peaks highest absolute sample of each frame
+     */
+    void Run(const float* peaks, float* gains, int frames);
 };
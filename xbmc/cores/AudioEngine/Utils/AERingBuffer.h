@@ -18,17 +18,33 @@
 #include "utils/log.h"
 #include "utils/MemUtils.h"
 
+#include <algorithm>
+#include <atomic>
 #include <string.h>
 
 /**
  * This buffer can be used by one read and one write thread at any one time
  * without the risk of data corruption.
+ * It is wait-free: reading and writing never lock, log or allocate, so
+ * either side may run in a real-time audio callback.
  * If you intend to call the Reset() method, please use Locks.
  * All other operations are thread-safe.
  */
 class AERingBuffer {
 
 public:
+  /**
+   * Up to two contiguous parts of a plane, the second one is used when the
+   * region wraps around the end of the buffer.
+   */
+  struct Region
+  {
+    unsigned char* data[2] = {nullptr, nullptr};
+    unsigned int size[2] = {0, 0};
+
+    unsigned int GetSize() const { return size[0] + size[1]; }
+  };
+
   AERingBuffer() = default;
 
   AERingBuffer(unsigned int size, unsigned int planes = 1) { Create(size, planes); }
@@ -72,8 +88,8 @@ public:
 #ifdef AE_RING_BUFFER_DEBUG
     CLog::Log(LOGDEBUG, "AERingBuffer::Reset: Buffer reset.");
 #endif
-    m_iWritten = 0;
-    m_iRead = 0;
+    m_iWritten.store(0, std::memory_order_relaxed);
+    m_iRead.store(0, std::memory_order_relaxed);
     m_iReadPos = 0;
     m_iWritePos = 0;
   }
@@ -91,19 +107,12 @@ public:
     //do we have enough space for all the data?
     if (size > space || plane >= m_planes)
     {
-#ifdef AE_RING_BUFFER_DEBUG
-    CLog::Log(LOGDEBUG, "AERingBuffer: Not enough space, ignoring data. Requested: %u Available: %u",size, space);
-#endif
       return AE_RING_BUFFER_FULL;
     }
 
     //no wrapping?
     if ( m_iSize > size + m_iWritePos )
     {
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Written to: %u size: %u space before: %u", m_iWritePos,
-                size, space);
-#endif
       memcpy(m_Buffer[plane] + m_iWritePos, src, size);
     }
     //need to wrap
@@ -111,11 +120,6 @@ public:
     {
       unsigned int first = m_iSize - m_iWritePos;
       unsigned int second = size - first;
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG,
-                "AERingBuffer: Written to (split) first: %u second: %u size: %u space before: %u",
-                first, second, size, space);
-#endif
       memcpy(m_Buffer[plane] + m_iWritePos, src, first);
       memcpy(m_Buffer[plane], src + first, second);
     }
@@ -139,28 +143,18 @@ public:
     //want to read more than we have written?
     if( space == 0 )
     {
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Can't read from empty buffer.");
-#endif
       return AE_RING_BUFFER_EMPTY;
     }
 
     //want to read more than we have available
     if( size > space || plane >= m_planes)
     {
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Can't read %u bytes when we only have %u.", size, space);
-#endif
       return AE_RING_BUFFER_NOTAVAILABLE;
     }
 
     //no wrapping?
     if ( size + m_iReadPos < m_iSize )
     {
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Reading from: %u size: %u space before: %u", m_iWritePos,
-                size, space);
-#endif
       if (dest)
         memcpy(dest, m_Buffer[plane] + m_iReadPos, size);
     }
@@ -169,11 +163,6 @@ public:
     {
       unsigned int first = m_iSize - m_iReadPos;
       unsigned int second = size - first;
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG,
-                "AERingBuffer: Reading from (split) first: %u second: %u size: %u space before: %u",
-                first, second, size, space);
-#endif
       if (dest)
       {
         memcpy(dest, m_Buffer[plane] + m_iReadPos, first);
@@ -186,6 +175,48 @@ public:
     return AE_RING_BUFFER_OK;
   }
 
+  /**
+   * Free space of a plane for writing into it in place, without copying.
+   * Call CommitWrite() after filling all planes.
+   */
+  Region GetWriteRegion(unsigned int plane = 0)
+  {
+    Region region;
+    if (plane < m_planes)
+      Split(region, m_Buffer[plane], m_iWritePos, GetWriteSize());
+    return region;
+  }
+
+  /**
+   * Makes the first size bytes of the write regions of all planes
+   * available to the reader.
+   */
+  void CommitWrite(unsigned int size)
+  {
+    WriteFinished(size);
+  }
+
+  /**
+   * Data of a plane for reading it in place, without copying.
+   * Call CommitRead() after consuming all planes.
+   */
+  Region GetReadRegion(unsigned int plane = 0)
+  {
+    Region region;
+    if (plane < m_planes)
+      Split(region, m_Buffer[plane], m_iReadPos, GetReadSize());
+    return region;
+  }
+
+  /**
+   * Hands the first size bytes of the read regions of all planes back to
+   * the writer.
+   */
+  void CommitRead(unsigned int size)
+  {
+    ReadFinished(size);
+  }
+
   /**
    * Dumps the buffer.
    */
@@ -214,7 +245,9 @@ public:
    */
   unsigned int GetWriteSize()
   {
-    return m_iSize - ( m_iWritten - m_iRead );
+    // acquire: the reader is done with the data before the space is reused
+    return m_iSize - (m_iWritten.load(std::memory_order_relaxed) -
+                      m_iRead.load(std::memory_order_acquire));
   }
 
   /**
@@ -223,7 +256,9 @@ public:
    */
   unsigned int GetReadSize()
   {
-    return m_iWritten - m_iRead;
+    // acquire: the data of the writer is visible before it is read
+    return m_iWritten.load(std::memory_order_acquire) -
+           m_iRead.load(std::memory_order_relaxed);
   }
 
   /**
@@ -254,7 +289,7 @@ private:
       m_iWritePos = size - (m_iSize - m_iWritePos);
 
     //we can increase the write count now
-    m_iWritten+=size;
+    m_iWritten.store(m_iWritten.load(std::memory_order_relaxed) + size, std::memory_order_release);
   }
 
   /**
@@ -269,13 +304,23 @@ private:
       m_iReadPos = size - (m_iSize - m_iReadPos);
 
     //we can increase the read count now
-    m_iRead+=size;
+    m_iRead.store(m_iRead.load(std::memory_order_relaxed) + size, std::memory_order_release);
+  }
+
+  void Split(Region& region, unsigned char* plane, unsigned int pos, unsigned int size) const
+  {
+    region.data[0] = plane + pos;
+    region.size[0] = std::min(size, m_iSize - pos);
+    region.data[1] = plane;
+    region.size[1] = size - region.size[0];
   }
 
   unsigned int m_iReadPos = 0;
   unsigned int m_iWritePos = 0;
-  unsigned int m_iRead = 0;
-  unsigned int m_iWritten = 0;
+  // only the reader changes m_iRead and m_iReadPos, only the writer
+  // m_iWritten and m_iWritePos
+  std::atomic<unsigned int> m_iRead{0};
+  std::atomic<unsigned int> m_iWritten{0};
   unsigned int m_iSize = 0;
   unsigned int m_planes = 0;
   unsigned char** m_Buffer = nullptr;
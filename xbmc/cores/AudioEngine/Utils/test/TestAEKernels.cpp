@@ -0,0 +1,238 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "cores/AudioEngine/Utils/AELimiter.h"
+
+#include <random>
+#include <string.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// odd lengths and offsets so that the vector loops, their tails and unaligned
+// buffers are all covered
+const uint32_t MAX_COUNT = 67;
+const uint32_t MAX_OFFSET = 3;
+
+std::vector<float> RandomSamples(std::mt19937& rng, uint32_t count)
+{
+  // exceed the sample range to hit the clamping
+  std::uniform_real_distribution<float> dist(-1.5f, 1.5f);
+  std::vector<float> samples(count);
+  for (float& sample : samples)
+    sample = dist(rng);
+
+  // conversions round ties to even
+  const float ties[] = {0.5f / 32768.0f, 1.5f / 32768.0f, -2.5f / 32768.0f, 1.0f, -1.0f, 0.0f};
+  for (uint32_t i = 0; i < count && i < sizeof(ties) / sizeof(ties[0]); i++)
+    samples[count - 1 - i] = ties[i];
+
+  return samples;
+}
+
+std::vector<const CAEKernels::SKernels*> GetAvailableKernels()
+{
+  std::vector<const CAEKernels::SKernels*> kernels;
+  for (int type = CAEKernels::SCALAR + 1; type < CAEKernels::TYPE_COUNT; type++)
+  {
+    const CAEKernels::SKernels* k = CAEKernels::Get(static_cast<CAEKernels::Type>(type));
+    if (k)
+      kernels.push_back(k);
+  }
+  return kernels;
+}
+} // namespace
+
+class TestAEKernels : public ::testing::Test
+{
+protected:
+  TestAEKernels() : m_rng(1234), m_scalar(*CAEKernels::Get(CAEKernels::SCALAR)) {}
+
+  std::mt19937 m_rng;
+  const CAEKernels::SKernels& m_scalar;
+};
+
+TEST_F(TestAEKernels, Selected)
+{
+  ASSERT_NE(nullptr, CAEKernels::Get(CAEKernels::SCALAR));
+  EXPECT_EQ(CAEKernels::Get(CAEKernels::GetType()), &CAEKernels::Get());
+}
+
+TEST_F(TestAEKernels, Mul)
+{
+  for (const CAEKernels::SKernels* kernels : GetAvailableKernels())
+  {
+    for (uint32_t count = 0; count <= MAX_COUNT; count++)
+    {
+      for (uint32_t offset = 0; offset <= MAX_OFFSET; offset++)
+      {
+        const std::vector<float> data = RandomSamples(m_rng, count + offset);
+        const std::vector<float> add = RandomSamples(m_rng, count + offset);
+        const std::vector<float> gains = RandomSamples(m_rng, count + offset);
+
+        std::vector<float> expected = data;
+        std::vector<float> actual = data;
+        m_scalar.Mul(expected.data() + offset, 0.7f, count);
+        kernels->Mul(actual.data() + offset, 0.7f, count);
+        EXPECT_EQ(0, memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)));
+
+        expected = data;
+        actual = data;
+        m_scalar.MulAdd(expected.data() + offset, add.data() + offset, 0.3f, count);
+        kernels->MulAdd(actual.data() + offset, add.data() + offset, 0.3f, count);
+        EXPECT_EQ(0, memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)));
+
+        expected = data;
+        actual = data;
+        m_scalar.MulGains(expected.data() + offset, gains.data() + offset, count);
+        kernels->MulGains(actual.data() + offset, gains.data() + offset, count);
+        EXPECT_EQ(0, memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)));
+
+        expected = data;
+        actual = data;
+        m_scalar.MulAddGains(expected.data() + offset, add.data() + offset, gains.data() + offset, count);
+        kernels->MulAddGains(actual.data() + offset, add.data() + offset, gains.data() + offset, count);
+        EXPECT_EQ(0, memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)));
+
+        std::vector<float> expectedPeaks(count, 0.2f);
+        std::vector<float> actualPeaks(count, 0.2f);
+        m_scalar.AbsMax(expectedPeaks.data(), data.data() + offset, count);
+        kernels->AbsMax(actualPeaks.data(), data.data() + offset, count);
+        EXPECT_EQ(expectedPeaks, actualPeaks);
+      }
+    }
+  }
+}
+
+TEST_F(TestAEKernels, Convert)
+{
+  for (const CAEKernels::SKernels* kernels : GetAvailableKernels())
+  {
+    for (uint32_t count = 0; count <= MAX_COUNT; count++)
+    {
+      for (uint32_t offset = 0; offset <= MAX_OFFSET; offset++)
+      {
+        const std::vector<float> samples = RandomSamples(m_rng, count + offset);
+
+        std::vector<int16_t> expected16(count);
+        std::vector<int16_t> actual16(count);
+        m_scalar.FloatToS16(expected16.data(), samples.data() + offset, count);
+        kernels->FloatToS16(actual16.data(), samples.data() + offset, count);
+        EXPECT_EQ(expected16, actual16);
+
+        std::vector<int32_t> expected32(count);
+        std::vector<int32_t> actual32(count);
+        m_scalar.FloatToS32(expected32.data(), samples.data() + offset, count);
+        kernels->FloatToS32(actual32.data(), samples.data() + offset, count);
+        EXPECT_EQ(expected32, actual32);
+
+        std::vector<float> expected(count);
+        std::vector<float> actual(count);
+        m_scalar.S16ToFloat(expected.data(), expected16.data(), count);
+        kernels->S16ToFloat(actual.data(), expected16.data(), count);
+        EXPECT_EQ(0, memcmp(expected.data(), actual.data(), count * sizeof(float)));
+
+        m_scalar.S32ToFloat(expected.data(), expected32.data(), count);
+        kernels->S32ToFloat(actual.data(), expected32.data(), count);
+        EXPECT_EQ(0, memcmp(expected.data(), actual.data(), count * sizeof(float)));
+      }
+    }
+  }
+}
+
+TEST_F(TestAEKernels, ConvertLimits)
+{
+  EXPECT_EQ(32767, CAEKernels::ToS16(1.0f));
+  EXPECT_EQ(-32768, CAEKernels::ToS16(-1.0f));
+  EXPECT_EQ(0, CAEKernels::ToS16(0.5f / 32768.0f));
+  EXPECT_EQ(2, CAEKernels::ToS16(1.5f / 32768.0f));
+  EXPECT_EQ(2147483520, CAEKernels::ToS32(1.0f));
+  EXPECT_EQ(-2147483647 - 1, CAEKernels::ToS32(-1.5f));
+}
+
+TEST_F(TestAEKernels, Interleave)
+{
+  for (int channels : {1, 2, 6})
+  {
+    for (uint32_t frames = 0; frames <= MAX_COUNT; frames++)
+    {
+      std::vector<std::vector<float>> planes;
+      std::vector<const float*> src;
+      for (int ch = 0; ch < channels; ch++)
+      {
+        planes.push_back(RandomSamples(m_rng, frames));
+        src.push_back(planes.back().data());
+      }
+
+      std::vector<float> interleaved(frames * channels);
+      CAEKernels::Interleave(interleaved.data(), src.data(), channels, frames);
+      for (uint32_t i = 0; i < frames; i++)
+      {
+        for (int ch = 0; ch < channels; ch++)
+          ASSERT_EQ(planes[ch][i], interleaved[i * channels + ch]);
+      }
+
+      std::vector<std::vector<float>> result(channels, std::vector<float>(frames));
+      std::vector<float*> dst;
+      for (int ch = 0; ch < channels; ch++)
+        dst.push_back(result[ch].data());
+      CAEKernels::Deinterleave(dst.data(), interleaved.data(), channels, frames);
+      EXPECT_EQ(planes, result);
+    }
+  }
+
+  for (const CAEKernels::SKernels* kernels : GetAvailableKernels())
+  {
+    for (uint32_t frames = 0; frames <= MAX_COUNT; frames++)
+    {
+      const std::vector<float> left = RandomSamples(m_rng, frames);
+      const std::vector<float> right = RandomSamples(m_rng, frames);
+
+      std::vector<float> expected(2 * frames);
+      std::vector<float> actual(2 * frames);
+      m_scalar.Interleave2(expected.data(), left.data(), right.data(), frames);
+      kernels->Interleave2(actual.data(), left.data(), right.data(), frames);
+      EXPECT_EQ(expected, actual);
+
+      std::vector<float> actualLeft(frames);
+      std::vector<float> actualRight(frames);
+      kernels->Deinterleave2(actualLeft.data(), actualRight.data(), expected.data(), frames);
+      EXPECT_EQ(left, actualLeft);
+      EXPECT_EQ(right, actualRight);
+    }
+  }
+}
+
+TEST_F(TestAEKernels, LimiterBlock)
+{
+  const int frames = 4800;
+  const int channels = 2;
+
+  std::vector<float> samples = RandomSamples(m_rng, frames * channels);
+  std::vector<float> peaks(frames, 0.0f);
+  for (int i = 0; i < frames; i++)
+  {
+    for (int ch = 0; ch < channels; ch++)
+      peaks[i] = std::max(peaks[i], fabsf(samples[i * channels + ch]));
+  }
+
+  CAELimiter frameLimiter;
+  CAELimiter blockLimiter;
+  frameLimiter.SetAmplification(2.0f);
+  blockLimiter.SetAmplification(2.0f);
+
+  std::vector<float> gains(frames);
+  blockLimiter.Run(peaks.data(), gains.data(), frames);
+
+  float* data[AE_CH_MAX] = {samples.data()};
+  for (int i = 0; i < frames; i++)
+    ASSERT_EQ(frameLimiter.Run(data, channels, i * channels), gains[i]);
+}
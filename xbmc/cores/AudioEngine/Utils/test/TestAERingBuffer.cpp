@@ -0,0 +1,186 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+std::vector<unsigned char> Sequence(unsigned int start, unsigned int size)
+{
+  std::vector<unsigned char> data(size);
+  for (unsigned int i = 0; i < size; i++)
+    data[i] = static_cast<unsigned char>(start + i);
+  return data;
+}
+} // namespace
+
+TEST(TestAERingBuffer, WriteRead)
+{
+  AERingBuffer buffer(16);
+  std::vector<unsigned char> out(16);
+
+  EXPECT_EQ(16u, buffer.GetWriteSize());
+  EXPECT_EQ(0u, buffer.GetReadSize());
+  EXPECT_EQ(1, buffer.Read(out.data(), 1));
+
+  // wrap around the end several times
+  for (unsigned int i = 0; i < 10; i++)
+  {
+    std::vector<unsigned char> in = Sequence(i * 11, 11);
+    EXPECT_EQ(0, buffer.Write(in.data(), 11));
+    EXPECT_EQ(11u, buffer.GetReadSize());
+    EXPECT_EQ(5u, buffer.GetWriteSize());
+    EXPECT_EQ(2, buffer.Write(in.data(), 6));
+
+    EXPECT_EQ(0, buffer.Read(out.data(), 11));
+    EXPECT_EQ(in, std::vector<unsigned char>(out.begin(), out.begin() + 11));
+  }
+  EXPECT_EQ(1, buffer.Read(out.data(), 1));
+}
+
+TEST(TestAERingBuffer, Planes)
+{
+  AERingBuffer buffer(8, 2);
+  std::vector<unsigned char> left = Sequence(0, 6);
+  std::vector<unsigned char> right = Sequence(100, 6);
+  std::vector<unsigned char> out(6);
+
+  // the data becomes readable with the last plane
+  EXPECT_EQ(0, buffer.Write(left.data(), 6, 0));
+  EXPECT_EQ(0u, buffer.GetReadSize());
+  EXPECT_EQ(0, buffer.Write(right.data(), 6, 1));
+  EXPECT_EQ(6u, buffer.GetReadSize());
+  EXPECT_EQ(2, buffer.Write(right.data(), 1, 2));
+
+  EXPECT_EQ(0, buffer.Read(out.data(), 6, 0));
+  EXPECT_EQ(left, out);
+  EXPECT_EQ(6u, buffer.GetReadSize());
+  EXPECT_EQ(0, buffer.Read(out.data(), 6, 1));
+  EXPECT_EQ(right, out);
+  EXPECT_EQ(0u, buffer.GetReadSize());
+}
+
+TEST(TestAERingBuffer, Regions)
+{
+  AERingBuffer buffer(8);
+  std::vector<unsigned char> in = Sequence(0, 6);
+  std::vector<unsigned char> out(6);
+
+  EXPECT_EQ(0, buffer.Write(in.data(), 6));
+  EXPECT_EQ(0, buffer.Read(out.data(), 6));
+
+  // the free space wraps after two bytes
+  AERingBuffer::Region region = buffer.GetWriteRegion();
+  EXPECT_EQ(8u, region.GetSize());
+  EXPECT_EQ(2u, region.size[0]);
+  EXPECT_EQ(6u, region.size[1]);
+  for (unsigned int i = 0; i < 5; i++)
+  {
+    unsigned int part = i < region.size[0] ? 0 : 1;
+    unsigned int offset = part == 0 ? i : i - region.size[0];
+    region.data[part][offset] = static_cast<unsigned char>(50 + i);
+  }
+  EXPECT_EQ(0u, buffer.GetReadSize());
+  buffer.CommitWrite(5);
+  EXPECT_EQ(5u, buffer.GetReadSize());
+  EXPECT_EQ(3u, buffer.GetWriteRegion().GetSize());
+  EXPECT_EQ(0u, buffer.GetWriteRegion(1).GetSize());
+
+  region = buffer.GetReadRegion();
+  ASSERT_EQ(5u, region.GetSize());
+  EXPECT_EQ(2u, region.size[0]);
+  EXPECT_EQ(50, region.data[0][0]);
+  EXPECT_EQ(51, region.data[0][1]);
+  EXPECT_EQ(52, region.data[1][0]);
+  EXPECT_EQ(54, region.data[1][2]);
+  buffer.CommitRead(3);
+
+  EXPECT_EQ(0, buffer.Read(out.data(), 2));
+  EXPECT_EQ(53, out[0]);
+  EXPECT_EQ(54, out[1]);
+  EXPECT_EQ(8u, buffer.GetWriteSize());
+}
+
+TEST(TestAERingBuffer, Threads)
+{
+  const unsigned int total = 1 << 20;
+  AERingBuffer buffer(1000, 2);
+
+  std::thread writer([&buffer, total]() {
+    unsigned int written = 0;
+    std::vector<unsigned char> data;
+    while (written < total)
+    {
+      unsigned int size = std::min({buffer.GetWriteSize(), total - written, 37u + written % 91});
+      if (!size)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      // alternate between copying and writing in place
+      if (written % 2)
+      {
+        data = Sequence(written, size);
+        buffer.Write(data.data(), size, 0);
+        buffer.Write(data.data(), size, 1);
+      }
+      else
+      {
+        for (unsigned int plane = 0; plane < 2; plane++)
+        {
+          AERingBuffer::Region region = buffer.GetWriteRegion(plane);
+          for (unsigned int i = 0; i < size; i++)
+          {
+            if (i < region.size[0])
+              region.data[0][i] = static_cast<unsigned char>(written + i);
+            else
+              region.data[1][i - region.size[0]] = static_cast<unsigned char>(written + i);
+          }
+        }
+        buffer.CommitWrite(size);
+      }
+      written += size;
+    }
+  });
+
+  unsigned int read = 0;
+  bool ok = true;
+  while (read < total && ok)
+  {
+    unsigned int size = std::min(buffer.GetReadSize(), 53u + read % 97);
+    if (!size)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::vector<unsigned char> data(size);
+    buffer.Read(data.data(), size, 0);
+    ok = data == Sequence(read, size);
+
+    AERingBuffer::Region region = buffer.GetReadRegion(1);
+    ok = region.GetSize() >= size ? ok : false;
+    for (unsigned int i = 0; i < size && ok; i++)
+    {
+      unsigned char value = i < region.size[0] ? region.data[0][i] : region.data[1][i - region.size[0]];
+      ok = value == static_cast<unsigned char>(read + i);
+    }
+    buffer.CommitRead(size);
+    read += size;
+  }
+
+  writer.join();
+  EXPECT_TRUE(ok);
+  EXPECT_EQ(total, read);
+}
@@ -0,0 +1,125 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "test/Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+/*!
+ \brief Run every sample kernel of every type the cpu supports over blocks of
+ stereo frames, like ActiveAE does for a period of the sink.
+ */
+int AEKernels(const std::vector<std::string>& args)
+{
+  uint32_t frames = 1024;
+  int iterations = 20000;
+  if (!args.empty())
+    frames = std::strtoul(args[0].c_str(), nullptr, 10);
+  if (args.size() > 1)
+    iterations = std::atoi(args[1].c_str());
+  if (frames == 0 || iterations <= 0)
+  {
+    fprintf(stderr, "aekernels: invalid frames or iterations\n");
+    return 1;
+  }
+
+  const uint32_t samples = 2 * frames;
+  std::vector<float> left(frames, 0.25f);
+  std::vector<float> right(frames, -0.25f);
+  std::vector<float> data(samples, 0.5f);
+  std::vector<float> add(samples, 0.125f);
+  std::vector<float> gains(samples, 0.999f);
+  std::vector<float> peaks(samples);
+  std::vector<int16_t> s16(samples);
+  std::vector<int32_t> s32(samples);
+
+  printf("frames: %u, iterations: %d, selected: %s\n\n", frames, iterations,
+         CAEKernels::TypeToStr(CAEKernels::GetType()));
+
+  for (int type = CAEKernels::SCALAR; type < CAEKernels::TYPE_COUNT; type++)
+  {
+    const CAEKernels::SKernels* kernels = CAEKernels::Get(static_cast<CAEKernels::Type>(type));
+    if (!kernels)
+      continue;
+
+    CBenchmark::CStage mul("mul");
+    CBenchmark::CStage mulAdd("muladd");
+    CBenchmark::CStage mulGains("mul gains");
+    CBenchmark::CStage mulAddGains("muladd gains");
+    CBenchmark::CStage absMax("absmax");
+    CBenchmark::CStage toS16("float to s16");
+    CBenchmark::CStage toS32("float to s32");
+    CBenchmark::CStage fromS16("s16 to float");
+    CBenchmark::CStage fromS32("s32 to float");
+    CBenchmark::CStage interleave("interleave");
+    CBenchmark::CStage deinterleave("deinterleave");
+
+    for (int i = 0; i < iterations; i++)
+    {
+      // gains close to one keep the samples in range over all iterations
+      mul.Begin();
+      kernels->Mul(data.data(), 0.999f, samples);
+      mul.End();
+
+      mulAdd.Begin();
+      kernels->MulAdd(data.data(), add.data(), 0.001f, samples);
+      mulAdd.End();
+
+      mulGains.Begin();
+      kernels->MulGains(data.data(), gains.data(), samples);
+      mulGains.End();
+
+      mulAddGains.Begin();
+      kernels->MulAddGains(data.data(), add.data(), gains.data(), samples);
+      mulAddGains.End();
+
+      absMax.Begin();
+      kernels->AbsMax(peaks.data(), data.data(), samples);
+      absMax.End();
+
+      toS16.Begin();
+      kernels->FloatToS16(s16.data(), data.data(), samples);
+      toS16.End();
+
+      toS32.Begin();
+      kernels->FloatToS32(s32.data(), data.data(), samples);
+      toS32.End();
+
+      fromS16.Begin();
+      kernels->S16ToFloat(data.data(), s16.data(), samples);
+      fromS16.End();
+
+      fromS32.Begin();
+      kernels->S32ToFloat(data.data(), s32.data(), samples);
+      fromS32.End();
+
+      interleave.Begin();
+      kernels->Interleave2(data.data(), left.data(), right.data(), frames);
+      interleave.End();
+
+      deinterleave.Begin();
+      kernels->Deinterleave2(left.data(), right.data(), data.data(), frames);
+      deinterleave.End();
+    }
+
+    printf("kernels: %s\n", CAEKernels::TypeToStr(static_cast<CAEKernels::Type>(type)));
+    CBenchmark::PrintStages({&mul, &mulAdd, &mulGains, &mulAddGains, &absMax, &toS16, &toS32,
+                             &fromS16, &fromS32, &interleave, &deinterleave});
+    printf("\n");
+  }
+
+  return 0;
+}
+} // namespace
+
+BENCHMARK_REGISTER("aekernels", "[frames] [iterations]", AEKernels);
@@ -0,0 +1,401 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Encoders/AEEncoderFFmpeg.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "cores/AudioEngine/Utils/AEBitstreamPacker.h"
+#include "cores/AudioEngine/Utils/AEKernels.h"
+#include "cores/AudioEngine/Utils/AELimiter.h"
+#include "cores/AudioEngine/Utils/AEStreamInfo.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "test/Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ActiveAE;
+
+namespace
+{
+// buffer times of the stream and sink stages of ActiveAE in ms
+constexpr unsigned int STREAM_BUFFER_TIME = 400;
+constexpr unsigned int SINK_BUFFER_TIME = 200;
+
+// frames of a decoded packet
+constexpr unsigned int INPUT_FRAMES = 1024;
+
+struct SStream
+{
+  std::unique_ptr<CActiveAEBufferPool> input;
+  std::unique_ptr<CActiveAEBufferPoolResample> resample;
+  std::unique_ptr<CActiveAEBufferPoolAtempo> atempo;
+  std::deque<CSampleBuffer*> output;
+  CAELimiter limiter;
+  double phase = 0.0;
+  double step = 0.0;
+};
+
+struct SPoolUsage
+{
+  std::string name;
+  const CActiveAEBufferPool* pool;
+  size_t peak;
+};
+
+void FillSine(SStream& stream, CSampleBuffer* buffer)
+{
+  // the same tone at -6 dB in every channel of interleaved S16
+  CSoundPacket* pkt = buffer->pkt;
+  int16_t* data = reinterpret_cast<int16_t*>(pkt->data[0]);
+  const int channels = pkt->config.channels;
+  for (int i = 0; i < pkt->max_nb_samples; i++)
+  {
+    const int16_t sample = static_cast<int16_t>(16384.0 * sin(stream.phase));
+    for (int ch = 0; ch < channels; ch++)
+      *data++ = sample;
+    stream.phase += stream.step;
+  }
+  stream.phase = fmod(stream.phase, 2.0 * M_PI);
+
+  pkt->nb_samples = pkt->max_nb_samples;
+  buffer->timestamp = 0;
+  buffer->pkt_start_offset = 0;
+}
+
+void RunLimiter(CAELimiter& limiter, const CSoundPacket& pkt, std::vector<float>& peaks, std::vector<float>& gains)
+{
+  // the mixing format is planar, see CActiveAE::RunLimiter
+  const int frames = pkt.nb_samples;
+  peaks.assign(frames, 0.0f);
+  gains.resize(frames);
+  for (int j = 0; j < pkt.planes; j++)
+    CAEKernels::Get().AbsMax(peaks.data(), reinterpret_cast<const float*>(pkt.data[j]), frames);
+  limiter.Run(peaks.data(), gains.data(), frames);
+}
+
+/*!
+ \brief Push synthetic streams through the processing stages of ActiveAE into
+ the null sink, as fast as the cpu allows.
+
+ The stages run on one thread in the order of CActiveAE::RunStages: resample
+ and atempo of every stream, limiter and mixing, then either the conversion to
+ the sink format or AC3 encoding and IEC packing. Optionally the sink writes
+ the output to a file.
+ */
+int ActiveAEPipeline(const std::vector<std::string>& args)
+{
+  double seconds = 60.0;
+  int streamCount = 2;
+  float tempo = 1.0f;
+  bool transcode = false;
+  std::string device = "null";
+  if (!args.empty())
+    seconds = std::atof(args[0].c_str());
+  if (args.size() > 1)
+    streamCount = std::atoi(args[1].c_str());
+  if (args.size() > 2)
+    tempo = static_cast<float>(std::atof(args[2].c_str()));
+  if (args.size() > 3)
+    transcode = (args[3] == "ac3");
+  if (args.size() > 4)
+    device = args[4];
+  if (seconds <= 0.0 || streamCount <= 0 || tempo < 0.5f || tempo > 2.0f ||
+      (args.size() > 3 && args[3] != "pcm" && args[3] != "ac3"))
+  {
+    fprintf(stderr, "activeae: invalid arguments\n");
+    return 1;
+  }
+
+  // 44.1 kHz S16 from the decoders, more than 2 channels are transcoded
+  AEAudioFormat inputFormat;
+  inputFormat.m_dataFormat = AE_FMT_S16NE;
+  inputFormat.m_sampleRate = 44100;
+  inputFormat.m_channelLayout = transcode ? AE_CH_LAYOUT_5_1 : AE_CH_LAYOUT_2_0;
+  inputFormat.m_frames = INPUT_FRAMES;
+  inputFormat.m_frameSize = inputFormat.m_channelLayout.Count() * 2;
+
+  // the engine mixes planar float at the rate of the sink
+  AEAudioFormat internalFormat = inputFormat;
+  internalFormat.m_dataFormat = AE_FMT_FLOATP;
+  internalFormat.m_sampleRate = 48000;
+  internalFormat.m_frameSize = internalFormat.m_channelLayout.Count() * sizeof(float);
+
+  CAESinkNULL sink;
+  sink.SetRealtime(false);
+  AEAudioFormat sinkFormat;
+  CAEEncoderFFmpeg encoder;
+  CAEBitstreamPacker packer;
+  std::vector<uint8_t> encoded;
+
+  if (transcode)
+  {
+    if (!encoder.Initialize(internalFormat, true))
+    {
+      fprintf(stderr, "activeae: failed to initialize the AC3 encoder\n");
+      return 1;
+    }
+    encoded.resize(61440);
+
+    sinkFormat.m_dataFormat = AE_FMT_RAW;
+    sinkFormat.m_streamInfo.m_type = CAEStreamInfo::STREAM_TYPE_AC3;
+    sinkFormat.m_streamInfo.m_channels = 2;
+    sinkFormat.m_streamInfo.m_sampleRate = 48000;
+    sinkFormat.m_streamInfo.m_ac3FrameSize = internalFormat.m_frames;
+    sinkFormat.m_sampleRate = CAEBitstreamPacker::GetOutputRate(sinkFormat.m_streamInfo);
+    sinkFormat.m_channelLayout = CAEBitstreamPacker::GetOutputChannelMap(sinkFormat.m_streamInfo);
+  }
+  else
+  {
+    sinkFormat.m_dataFormat = AE_FMT_S16NE;
+    sinkFormat.m_sampleRate = internalFormat.m_sampleRate;
+    sinkFormat.m_channelLayout = internalFormat.m_channelLayout;
+  }
+
+  if (!sink.Initialize(sinkFormat, device))
+  {
+    fprintf(stderr, "activeae: failed to initialize the sink\n");
+    return 1;
+  }
+  if (!transcode)
+    internalFormat.m_frames = sinkFormat.m_frames;
+
+  std::vector<SStream> streams(streamCount);
+  std::vector<SPoolUsage> pools;
+  for (int i = 0; i < streamCount; i++)
+  {
+    SStream& stream = streams[i];
+    stream.input.reset(new CActiveAEBufferPool(inputFormat));
+    stream.input->Create(STREAM_BUFFER_TIME);
+    stream.resample.reset(new CActiveAEBufferPoolResample(inputFormat, internalFormat, AE_QUALITY_MID));
+    stream.resample->Create(STREAM_BUFFER_TIME, false, false);
+    stream.atempo.reset(new CActiveAEBufferPoolAtempo(internalFormat));
+    stream.atempo->Create(STREAM_BUFFER_TIME);
+    stream.atempo->SetTempo(tempo);
+    if (transcode || streamCount > 1)
+    {
+      stream.resample->FillBuffer();
+      stream.atempo->FillBuffer();
+    }
+    stream.limiter.SetSamplerate(internalFormat.m_sampleRate);
+    stream.step = 2.0 * M_PI * (440.0 + 110.0 * i) / inputFormat.m_sampleRate;
+
+    const std::string name = "stream " + std::to_string(i);
+    pools.push_back({name + " input", stream.input.get(), 0});
+    pools.push_back({name + " resample", stream.resample.get(), 0});
+    pools.push_back({name + " atempo", stream.atempo.get(), 0});
+  }
+
+  std::unique_ptr<CActiveAEBufferPoolResample> sinkBuffers;
+  if (!transcode)
+  {
+    sinkBuffers.reset(new CActiveAEBufferPoolResample(internalFormat, sinkFormat, AE_QUALITY_MID));
+    sinkBuffers->Create(SINK_BUFFER_TIME, true, false);
+    pools.push_back({"sink", sinkBuffers.get(), 0});
+  }
+
+  printf("seconds: %.1f, streams: %d, tempo: %.2f, output: %s, device: %s, kernels: %s\n",
+         seconds, streamCount, tempo, transcode ? "ac3" : "pcm", device.c_str(),
+         CAEKernels::TypeToStr(CAEKernels::GetType()));
+  printf("input: %s %u Hz %u ch, mix: %u Hz %u frames, sink: %s %u Hz %u frames\n\n",
+         CAEUtil::DataFormatToStr(inputFormat.m_dataFormat), inputFormat.m_sampleRate,
+         inputFormat.m_channelLayout.Count(), internalFormat.m_sampleRate, internalFormat.m_frames,
+         CAEUtil::DataFormatToStr(sinkFormat.m_dataFormat), sinkFormat.m_sampleRate, sinkFormat.m_frames);
+
+  CBenchmark::CStage resampleStage("resample");
+  CBenchmark::CStage atempoStage("atempo");
+  CBenchmark::CStage limiterStage("limiter");
+  CBenchmark::CStage mixStage("mix");
+  CBenchmark::CStage convertStage("sink convert");
+  CBenchmark::CStage encodeStage("encode");
+  CBenchmark::CStage packStage("iec pack");
+  CBenchmark::CStage sinkStage("sink");
+
+  std::vector<float> peaks;
+  std::vector<float> gains;
+  const uint64_t targetFrames = static_cast<uint64_t>(seconds * internalFormat.m_sampleRate);
+  uint64_t mixedFrames = 0;
+  uint64_t mixedBuffers = 0;
+
+  const uint64_t allocations = CBenchmark::GetAllocations();
+  const uint64_t allocatedBytes = CBenchmark::GetAllocatedBytes();
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  while (mixedFrames < targetFrames)
+  {
+    bool busy = false;
+
+    for (SStream& stream : streams)
+    {
+      // a decoder delivering a packet whenever the stream has room for it
+      if (stream.resample->m_inputSamples.empty() && !stream.input->m_freeSamples.empty())
+      {
+        CSampleBuffer* buffer = stream.input->GetFreeBuffer();
+        FillSine(stream, buffer);
+        stream.resample->m_inputSamples.push_back(buffer);
+        busy = true;
+      }
+
+      resampleStage.Begin();
+      busy |= stream.resample->ResampleBuffers();
+      resampleStage.End();
+
+      while (!stream.resample->m_outputSamples.empty())
+      {
+        stream.atempo->m_inputSamples.push_back(stream.resample->m_outputSamples.front());
+        stream.resample->m_outputSamples.pop_front();
+      }
+
+      atempoStage.Begin();
+      busy |= stream.atempo->ProcessBuffers();
+      atempoStage.End();
+
+      while (!stream.atempo->m_outputSamples.empty())
+      {
+        stream.output.push_back(stream.atempo->m_outputSamples.front());
+        stream.atempo->m_outputSamples.pop_front();
+      }
+    }
+
+    // mix once every stream has a buffer, the first one takes the others
+    bool ready = true;
+    for (const SStream& stream : streams)
+      ready &= !stream.output.empty();
+    if (ready)
+    {
+      CSampleBuffer* out = streams[0].output.front();
+      streams[0].output.pop_front();
+
+      limiterStage.Begin();
+      RunLimiter(streams[0].limiter, *out->pkt, peaks, gains);
+      limiterStage.End();
+
+      const CAEKernels::SKernels& kernels = CAEKernels::Get();
+      mixStage.Begin();
+      for (int j = 0; j < out->pkt->planes; j++)
+        kernels.MulGains(reinterpret_cast<float*>(out->pkt->data[j]), gains.data(), out->pkt->nb_samples);
+      mixStage.End();
+
+      for (size_t i = 1; i < streams.size(); i++)
+      {
+        CSampleBuffer* mix = streams[i].output.front();
+        streams[i].output.pop_front();
+
+        limiterStage.Begin();
+        RunLimiter(streams[i].limiter, *mix->pkt, peaks, gains);
+        limiterStage.End();
+
+        mixStage.Begin();
+        const int frames = std::min(out->pkt->nb_samples, mix->pkt->nb_samples);
+        for (int j = 0; j < out->pkt->planes && j < mix->pkt->planes; j++)
+          kernels.MulAddGains(reinterpret_cast<float*>(out->pkt->data[j]),
+                              reinterpret_cast<const float*>(mix->pkt->data[j]), gains.data(), frames);
+        mixStage.End();
+
+        mix->Return();
+      }
+
+      mixedFrames += out->pkt->nb_samples;
+      mixedBuffers++;
+
+      if (transcode)
+      {
+        encodeStage.Begin();
+        const int size = encoder.Encode(out->pkt->data[0], out->pkt->planes * out->pkt->linesize,
+                                        encoded.data(), encoded.size());
+        encodeStage.End();
+        out->Return();
+
+        if (size > 0)
+        {
+          packStage.Begin();
+          packer.Pack(sinkFormat.m_streamInfo, encoded.data(), size);
+          packStage.End();
+
+          uint8_t* packed = packer.GetBuffer();
+          sinkStage.Begin();
+          sink.AddPackets(&packed, packer.GetSize() / sinkFormat.m_frameSize, 0);
+          sinkStage.End();
+        }
+      }
+      else
+        sinkBuffers->m_inputSamples.push_back(out);
+
+      busy = true;
+    }
+
+    if (!transcode)
+    {
+      convertStage.Begin();
+      busy |= sinkBuffers->ResampleBuffers();
+      convertStage.End();
+
+      while (!sinkBuffers->m_outputSamples.empty())
+      {
+        CSampleBuffer* buffer = sinkBuffers->m_outputSamples.front();
+        sinkBuffers->m_outputSamples.pop_front();
+
+        sinkStage.Begin();
+        sink.AddPackets(buffer->pkt->data, buffer->pkt->nb_samples, 0);
+        sinkStage.End();
+
+        buffer->Return();
+      }
+    }
+
+    for (SPoolUsage& usage : pools)
+      usage.peak = std::max(usage.peak, usage.pool->m_allSamples.size() - usage.pool->m_freeSamples.size());
+
+    if (!busy)
+    {
+      fprintf(stderr, "activeae: pipeline stalled after %.1f seconds\n",
+              static_cast<double>(mixedFrames) / internalFormat.m_sampleRate);
+      return 1;
+    }
+  }
+
+  const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  const double audio = static_cast<double>(mixedFrames) / internalFormat.m_sampleRate;
+
+  std::vector<const CBenchmark::CStage*> stages = {&resampleStage, &atempoStage, &limiterStage, &mixStage};
+  if (transcode)
+    stages.insert(stages.end(), {&encodeStage, &packStage});
+  else
+    stages.push_back(&convertStage);
+  stages.push_back(&sinkStage);
+  CBenchmark::PrintStages(stages);
+
+  printf("\n%-20s %10s %10s\n", "buffer pool", "buffers", "peak used");
+  for (const SPoolUsage& usage : pools)
+    printf("%-20s %10zu %10zu\n", usage.name.c_str(), usage.pool->m_allSamples.size(), usage.peak);
+
+  printf("\naudio: %.1f s in %.3f s, %.1fx realtime, %llu mixed buffers, %llu frames to the sink\n",
+         audio, wall, wall > 0.0 ? audio / wall : 0.0, static_cast<unsigned long long>(mixedBuffers),
+         static_cast<unsigned long long>(sink.GetFramesWritten()));
+  printf("operator new allocations: %llu (%llu bytes)\n",
+         static_cast<unsigned long long>(CBenchmark::GetAllocations() - allocations),
+         static_cast<unsigned long long>(CBenchmark::GetAllocatedBytes() - allocatedBytes));
+
+  for (SStream& stream : streams)
+  {
+    for (CSampleBuffer* buffer : stream.output)
+      buffer->Return();
+  }
+  sink.Deinitialize();
+  return 0;
+}
+} // namespace
+
+BENCHMARK_REGISTER("activeae", "[seconds] [streams] [tempo] [pcm|ac3] [null|output file]", ActiveAEPipeline);
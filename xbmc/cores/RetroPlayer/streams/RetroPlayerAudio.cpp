@@ -12,11 +12,13 @@
 #include "cores/AudioEngine/Interfaces/AE.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Utils/AEChannelInfo.h"
+#include "cores/AudioEngine/Utils/AEStreamData.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/RetroPlayer/audio/AudioTranslator.h"
 #include "cores/RetroPlayer/process/RPProcessInfo.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace KODI;
@@ -90,7 +92,8 @@ bool CRetroPlayerAudio::OpenStream(const StreamProperties& properties)
   audioFormat.m_dataFormat = pcmFormat;
   audioFormat.m_sampleRate = iSampleRate;
   audioFormat.m_channelLayout = channelLayout;
-  m_pAudioStream = audioEngine->MakeStream(audioFormat);
+  // games react to input, keep the engine buffers small
+  m_pAudioStream = audioEngine->MakeStream(audioFormat, AESTREAM_LOW_LATENCY);
 
   if (m_pAudioStream == nullptr)
   {
@@ -120,7 +123,10 @@ void CRetroPlayerAudio::AddStreamData(const StreamPacket& packet)
 
       const unsigned int frameCount = static_cast<unsigned int>(audioPacket.size / frameSize);
 
-      if (delaySecs > MAX_DELAY)
+      // the engine holds less than MAX_DELAY in low latency mode
+      const double maxDelaySecs = std::min(MAX_DELAY, m_pAudioStream->GetMaxDelay());
+
+      if (delaySecs > maxDelaySecs)
       {
         m_pAudioStream->Flush();
         CLog::Log(LOGDEBUG, "RetroPlayer[AUDIO]: Audio delay (%0.2f ms) is too high - flushing",
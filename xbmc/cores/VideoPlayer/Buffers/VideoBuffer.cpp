@@ -449,7 +449,10 @@ CVideoBuffer* CVideoBufferManager::Get(AVPixelFormat format, int size, IVideoBuf
     }
     if (pool->IsCompatible(format, size))
     {
-      return pool->Get();
+      // a pool which can't grow on this thread may be exhausted, try the next one
+      CVideoBuffer* buffer = pool->Get();
+      if (buffer)
+        return buffer;
     }
   }
 
@@ -8,6 +8,7 @@
 
 #include "DVDVideoCodecFFmpeg.h"
 
+#include "Application.h"
 #include "DVDCodecs/DVDCodecs.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDStreamInfo.h"
@@ -33,6 +34,7 @@ extern "C" {
 #include <libavfilter/avfilter.h>
 #include <libavfilter/buffersink.h>
 #include <libavfilter/buffersrc.h>
+#include <libavutil/imgutils.h>
 #include <libavutil/pixdesc.h>
 }
 
@@ -61,6 +63,77 @@ enum EFilterFlags {
   FILTER_ROTATE              = 0x40,  //< rotate image according to the codec hints
 };
 
+namespace
+{
+struct SThreading
+{
+  int type; // FF_THREAD_FRAME and/or FF_THREAD_SLICE
+  int count;
+  const char* reason;
+};
+
+/*!
+ \brief Choose how libavcodec threads a software decode.
+
+ Frame threading scales with the cores for every codec, but each thread holds
+ back one more frame. Low latency decoding keeps two threads, UHD a few more,
+ so only a frame is held back but streams coded as a single slice never end
+ up with a single thread. SD frames are too small to gain from more than a
+ few threads. The threads are halved while the system is busy or the library
+ is scanned, audio and GUI must not starve. libavcodec fixes the threads at
+ open, so the load is only sampled then.
+ */
+SThreading GetThreading(const CDVDStreamInfo& hints)
+{
+  const int cpus = std::max(1, CServiceBroker::GetCPUInfo()->GetCPUCount());
+  const bool uhd = hints.width > 1920 || hints.height > 1088;
+  const bool sd = hints.width > 0 && hints.width <= 1024 && hints.height > 0 && hints.height <= 576;
+  const bool lowLatency = (hints.codecOptions & CODEC_LOW_LATENCY) != 0;
+
+  SThreading threading{FF_THREAD_FRAME | FF_THREAD_SLICE, cpus * 3 / 2, ""};
+  if (lowLatency)
+    threading = {FF_THREAD_FRAME | FF_THREAD_SLICE, uhd ? std::min(cpus, 4) : 2, " (low latency)"};
+  else if (sd)
+    threading.count = std::min(threading.count, 4);
+
+  if (g_application.IsVideoScanning() || g_application.IsMusicScanning() ||
+      CServiceBroker::GetCPUInfo()->GetUsedPercentage() > 75)
+  {
+    threading.count /= 2;
+    threading.reason = lowLatency ? " (low latency, system busy)" : " (system busy)";
+  }
+
+  threading.count = std::max(lowLatency ? 2 : 1, std::min(threading.count, 16));
+  return threading;
+}
+
+/*!
+ \brief Formats decoded into buffers of the renderer, the ones its buffer
+ pools take without conversion.
+ */
+bool IsDirectRenderingFormat(AVPixelFormat format)
+{
+  switch (format)
+  {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUV420P9:
+    case AV_PIX_FMT_YUV420P10:
+    case AV_PIX_FMT_YUV420P12:
+    case AV_PIX_FMT_YUV420P14:
+    case AV_PIX_FMT_YUV420P16:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void ReleaseBuffer(void* opaque, uint8_t* data)
+{
+  CVideoBuffer* buffer = static_cast<CVideoBuffer*>(opaque);
+  buffer->Release();
+}
+} // namespace
+
 //------------------------------------------------------------------------------
 // Video Buffers
 //------------------------------------------------------------------------------
@@ -270,7 +343,8 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   if (ctx->HasHardware())
   {
     ctx->SetHardware(nullptr);
-    avctx->get_buffer2 = avcodec_default_get_buffer2;
+    avctx->get_buffer2 = (avctx->codec->capabilities & AV_CODEC_CAP_DR1) ? GetBuffer
+                                                                         : avcodec_default_get_buffer2;
     avctx->slice_flags = 0;
     av_buffer_unref(&avctx->hw_frames_ctx);
   }
@@ -304,6 +378,78 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   return avcodec_default_get_format(avctx, fmt);
 }
 
+int CDVDVideoCodecFFmpeg::GetBuffer(struct AVCodecContext* avctx, AVFrame* frame, int flags)
+{
+  ICallbackHWAccel* cb = static_cast<ICallbackHWAccel*>(avctx->opaque);
+  CDVDVideoCodecFFmpeg* ctx = dynamic_cast<CDVDVideoCodecFFmpeg*>(cb);
+  const AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+
+  if (!ctx || !IsDirectRenderingFormat(format))
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  // same layout as the default buffers of libavcodec: aligned dimensions and
+  // linesizes, each plane starting at an aligned offset
+  int width = frame->width;
+  int height = frame->height;
+  int strideAlign[AV_NUM_DATA_POINTERS];
+  avcodec_align_dimensions2(avctx, &width, &height, strideAlign);
+
+  int linesizes[4];
+  int unaligned;
+  do
+  {
+    av_image_fill_linesizes(linesizes, format, width);
+    // increase alignment of w for next try (rhs gives the lowest bit set in w)
+    width += width & ~(width - 1);
+
+    unaligned = 0;
+    for (int i = 0; i < 4; i++)
+      unaligned |= linesizes[i] % strideAlign[i];
+  } while (unaligned);
+
+  const int chromaHeight = (height + 1) >> 1;
+  int strides[YuvImage::MAX_PLANES];
+  int offsets[YuvImage::MAX_PLANES];
+  offsets[0] = 0;
+  for (int i = 0; i < YuvImage::MAX_PLANES; i++)
+  {
+    strides[i] = linesizes[i];
+    if (i > 0)
+      offsets[i] = FFALIGN(offsets[i - 1] + strides[i - 1] * (i == 1 ? height : chromaHeight), 64);
+  }
+  const int size = offsets[2] + strides[2] * chromaHeight + 16 + 64;
+
+  std::shared_ptr<IVideoBufferPool> pool = ctx->m_processInfo.GetRenderBufferPool();
+  CVideoBuffer* buffer = pool && pool->IsCompatible(format, size) ? pool->Get() : nullptr;
+  if (!buffer)
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  if (!buffer->GetMemPtr())
+  {
+    buffer->Release();
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+  }
+
+  buffer->SetDimensions(frame->width, frame->height, strides, offsets);
+  frame->buf[0] = av_buffer_create(buffer->GetMemPtr(), size, ReleaseBuffer, buffer, 0);
+  if (!frame->buf[0])
+  {
+    buffer->Release();
+    return AVERROR(ENOMEM);
+  }
+
+  uint8_t* planes[YuvImage::MAX_PLANES];
+  buffer->GetPlanes(planes);
+  for (int i = 0; i < YuvImage::MAX_PLANES; i++)
+  {
+    frame->data[i] = planes[i];
+    frame->linesize[i] = strides[i];
+  }
+  frame->extended_data = frame->data;
+
+  return 0;
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo)
 : CDVDVideoCodec(processInfo), m_postProc(processInfo)
 {
@@ -360,6 +506,10 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->get_format = GetFormat;
   m_pCodecContext->codec_tag = hints.codec_tag;
 
+  // decode straight into the buffers of the renderer if it offers some
+  if (pCodec->capabilities & AV_CODEC_CAP_DR1)
+    m_pCodecContext->get_buffer2 = GetBuffer;
+
   // setup threading model
   if (!(hints.codecOptions & CODEC_FORCE_SOFTWARE))
   {
@@ -369,12 +519,14 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     }
     else
     {
-      int num_threads = CServiceBroker::GetCPUInfo()->GetCPUCount() * 3 / 2;
-      num_threads = std::max(1, std::min(num_threads, 16));
-      m_pCodecContext->thread_count = num_threads;
+      const SThreading threading = GetThreading(hints);
+      m_pCodecContext->thread_type = threading.type;
+      m_pCodecContext->thread_count = threading.count;
       m_pCodecContext->thread_safe_callbacks = 1;
       m_decoderState = STATE_SW_MULTI;
-      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open frame threaded with %d threads", num_threads);
+      CLog::Log(LOGDEBUG, "CDVDVideoCodecFFmpeg - open %s threaded with %d threads%s",
+                threading.type & FF_THREAD_FRAME ? "frame" : "slice", threading.count,
+                threading.reason);
     }
   }
   else
@@ -569,6 +721,8 @@ bool CDVDVideoCodecFFmpeg::AddData(const DemuxPacket &packet)
   avpkt.pts = (packet.pts == DVD_NOPTS_VALUE) ? AV_NOPTS_VALUE : static_cast<int64_t>(packet.pts / DVD_TIME_BASE * AV_TIME_BASE);
   avpkt.side_data = static_cast<AVPacketSideData*>(packet.pSideData);
   avpkt.side_data_elems = packet.iSideDataElems;
+  // lets the decoder take a reference to the demuxer's buffer instead of copying the data
+  avpkt.buf = static_cast<AVBufferRef*>(packet.pDataRef);
 
   int ret = avcodec_send_packet(m_pCodecContext, &avpkt);
 
@@ -48,6 +48,7 @@ public:
 protected:
   void Dispose();
   static enum AVPixelFormat GetFormat(struct AVCodecContext * avctx, const AVPixelFormat * fmt);
+  static int GetBuffer(struct AVCodecContext* avctx, AVFrame* frame, int flags);
 
   int  FilterOpen(const std::string& filters, bool scale);
   void FilterClose();
@@ -8,6 +8,7 @@
 
 #include "DVDDemuxFFmpeg.h"
 
+#include "DVDDemuxProbeCache.h"
 #include "DVDDemuxUtils.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #include "DVDInputStreams/DVDInputStreamFFmpeg.h"
@@ -509,32 +510,54 @@ bool CDVDDemuxFFmpeg::Open(std::shared_ptr<CDVDInputStream> pInput, bool fileinf
   m_bAVI = strcmp(m_pFormatContext->iformat->name, "avi") == 0;
   m_bSup = strcmp(m_pFormatContext->iformat->name, "sup") == 0;
 
-  if (m_streaminfo)
+  // skip probing a channel which has the same streams as when it was last probed
+  const bool probeCache = m_streaminfo && !fileinfo && pInput->IsPVRChannel();
+  bool probeCached = false;
+  if (probeCache)
   {
-    /* to speed up dvd switches, only analyse very short */
-    if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
-      av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
+    // a transport stream goes the way of a reopen, where the parsers find the extradata
+    const bool isTransportStream = strcmp(m_pFormatContext->iformat->name, "mpegts") == 0;
+    probeCached = CDVDDemuxProbeCache::GetInstance().Restore(pInput->GetFileName(), m_pFormatContext,
+                                                            !isTransportStream);
+    if (probeCached)
+    {
+      CLog::Log(LOGDEBUG, "%s - streams unchanged, using cached codec parameters", __FUNCTION__);
+      if (isTransportStream)
+        m_streaminfo = false;
+    }
+  }
 
-    CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
-    int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
-    if (iErr < 0)
+  if (m_streaminfo)
+  {
+    if (!probeCached)
     {
-      CLog::Log(LOGWARNING,"could not find codec parameters for %s", CURL::GetRedacted(strFile).c_str());
-      if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) ||
-          m_pInput->IsStreamType(DVDSTREAM_TYPE_BLURAY) ||
-          (m_pFormatContext->nb_streams == 1 &&
-           m_pFormatContext->streams[0]->codecpar->codec_id == AV_CODEC_ID_AC3) ||
-          m_checkTransportStream)
-      {
-        // special case, our codecs can still handle it.
-      }
-      else
+      /* to speed up dvd switches, only analyse very short */
+      if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD))
+        av_opt_set_int(m_pFormatContext, "analyzeduration", 500000, 0);
+
+      CLog::Log(LOGDEBUG, "%s - avformat_find_stream_info starting", __FUNCTION__);
+      int iErr = avformat_find_stream_info(m_pFormatContext, NULL);
+      if (iErr < 0)
       {
-        Dispose();
-        return false;
+        CLog::Log(LOGWARNING,"could not find codec parameters for %s", CURL::GetRedacted(strFile).c_str());
+        if (m_pInput->IsStreamType(DVDSTREAM_TYPE_DVD) ||
+            m_pInput->IsStreamType(DVDSTREAM_TYPE_BLURAY) ||
+            (m_pFormatContext->nb_streams == 1 &&
+             m_pFormatContext->streams[0]->codecpar->codec_id == AV_CODEC_ID_AC3) ||
+            m_checkTransportStream)
+        {
+          // special case, our codecs can still handle it.
+        }
+        else
+        {
+          Dispose();
+          return false;
+        }
       }
+      else if (probeCache)
+        CDVDDemuxProbeCache::GetInstance().Store(pInput->GetFileName(), m_pFormatContext);
+      CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished", __FUNCTION__);
     }
-    CLog::Log(LOGDEBUG, "%s - av_find_stream_info finished", __FUNCTION__);
 
     // print some extra information
     av_dump_format(m_pFormatContext, 0, CURL::GetRedacted(strFile).c_str(), 0);
@@ -1045,7 +1068,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           {
             if (m_pkt.pkt.stream_index == (int)m_pFormatContext->programs[m_program]->stream_index[i])
             {
-              pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+              pPacket = CDVDDemuxUtils::AllocateDemuxPacketRef(&m_pkt.pkt);
               break;
             }
           }
@@ -1054,7 +1077,7 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
             bReturnEmpty = true;
         }
         else
-          pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+          pPacket = CDVDDemuxUtils::AllocateDemuxPacketRef(&m_pkt.pkt);
       }
       else
         bReturnEmpty = true;
@@ -1068,13 +1091,6 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           m_pkt.pkt.pts = AV_NOPTS_VALUE;
         }
 
-        // copy contents into our own packet
-        pPacket->iSize = m_pkt.pkt.size;
-
-        // maybe we can avoid a memcpy here by detecting where pkt.destruct is pointing too?
-        if (m_pkt.pkt.data)
-          memcpy(pPacket->pData, m_pkt.pkt.data, pPacket->iSize);
-
         pPacket->pts = ConvertTimestamp(m_pkt.pkt.pts, stream->time_base.den, stream->time_base.num);
         pPacket->dts = ConvertTimestamp(m_pkt.pkt.dts, stream->time_base.den, stream->time_base.num);
         pPacket->duration =  DVD_SEC_TO_TIME((double)m_pkt.pkt.duration * stream->time_base.num / stream->time_base.den);
@@ -0,0 +1,225 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDDemuxPacketPool.h"
+
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/MemUtils.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+// in front of every block, 16 bytes keep the payload aligned
+constexpr size_t HEADER_SIZE = 16;
+
+// size classes from 256 bytes to 4 MiB, larger blocks aren't pooled
+constexpr unsigned int MIN_CLASS_SHIFT = 8;
+constexpr unsigned int NUM_CLASSES = 15;
+constexpr uint32_t UNPOOLED = NUM_CLASSES;
+
+// classes up to 64 KiB are cached per thread, the bulk of audio and video packets
+constexpr unsigned int MAX_THREAD_CLASS = 8;
+constexpr size_t THREAD_CACHE_ENTRIES = 16;
+constexpr size_t BATCH_SIZE = THREAD_CACHE_ENTRIES / 2;
+
+// bound of the memory kept in the shared free lists
+constexpr size_t MAX_RETAINED_SIZE = 32 * 1024 * 1024;
+
+struct SBlockHeader
+{
+  uint32_t sizeClass;
+};
+
+size_t ClassSize(unsigned int sizeClass)
+{
+  return size_t(1) << (sizeClass + MIN_CLASS_SHIFT);
+}
+
+unsigned int SizeClass(size_t size)
+{
+  unsigned int sizeClass = 0;
+  while (sizeClass < NUM_CLASSES && ClassSize(sizeClass) < size)
+    sizeClass++;
+  return sizeClass;
+}
+
+class CSharedFreeLists
+{
+public:
+  ~CSharedFreeLists()
+  {
+    for (auto& blocks : m_free)
+      for (void* block : blocks)
+        KODI::MEMORY::AlignedFree(block);
+  }
+
+  void* Pop(unsigned int sizeClass)
+  {
+    CSingleLock lock(m_lock);
+    std::vector<void*>& blocks = m_free[sizeClass];
+    if (blocks.empty())
+      return nullptr;
+
+    void* block = blocks.back();
+    blocks.pop_back();
+    m_retainedSize -= ClassSize(sizeClass);
+    return block;
+  }
+
+  void PopBatch(unsigned int sizeClass, std::vector<void*>& out)
+  {
+    CSingleLock lock(m_lock);
+    std::vector<void*>& blocks = m_free[sizeClass];
+    while (!blocks.empty() && out.size() < BATCH_SIZE)
+    {
+      out.push_back(blocks.back());
+      blocks.pop_back();
+      m_retainedSize -= ClassSize(sizeClass);
+    }
+  }
+
+  void Push(unsigned int sizeClass, void* block)
+  {
+    {
+      CSingleLock lock(m_lock);
+      if (m_retainedSize + ClassSize(sizeClass) <= MAX_RETAINED_SIZE)
+      {
+        m_free[sizeClass].push_back(block);
+        m_retainedSize += ClassSize(sizeClass);
+        return;
+      }
+    }
+    KODI::MEMORY::AlignedFree(block);
+  }
+
+  void PushBatch(unsigned int sizeClass, std::vector<void*>& blocks, size_t count)
+  {
+    std::vector<void*> excess;
+    {
+      CSingleLock lock(m_lock);
+      for (size_t i = 0; i < count && !blocks.empty(); i++)
+      {
+        void* block = blocks.back();
+        blocks.pop_back();
+        if (m_retainedSize + ClassSize(sizeClass) <= MAX_RETAINED_SIZE)
+        {
+          m_free[sizeClass].push_back(block);
+          m_retainedSize += ClassSize(sizeClass);
+        }
+        else
+          excess.push_back(block);
+      }
+    }
+    for (void* block : excess)
+      KODI::MEMORY::AlignedFree(block);
+  }
+
+  size_t GetRetainedSize() const
+  {
+    CSingleLock lock(m_lock);
+    return m_retainedSize;
+  }
+
+private:
+  mutable CCriticalSection m_lock;
+  std::array<std::vector<void*>, NUM_CLASSES> m_free;
+  size_t m_retainedSize = 0;
+};
+
+CSharedFreeLists& GetSharedFreeLists()
+{
+  static CSharedFreeLists freeLists;
+  return freeLists;
+}
+
+// blocks kept by a thread, handed back to the shared lists when the thread ends
+class CThreadCache
+{
+public:
+  CThreadCache()
+  {
+    // make sure the shared lists outlive the caches of the threads
+    GetSharedFreeLists();
+  }
+
+  ~CThreadCache()
+  {
+    for (unsigned int i = 0; i < m_free.size(); i++)
+      GetSharedFreeLists().PushBatch(i, m_free[i], m_free[i].size());
+  }
+
+  std::array<std::vector<void*>, MAX_THREAD_CLASS + 1> m_free;
+};
+
+thread_local CThreadCache threadCache;
+} // namespace
+
+void* CDVDDemuxPacketPool::Allocate(size_t size)
+{
+  const unsigned int sizeClass = SizeClass(size + HEADER_SIZE);
+
+  void* block = nullptr;
+  if (sizeClass == UNPOOLED)
+    // aligned allocations must be a multiple of the alignment
+    block = KODI::MEMORY::AlignedMalloc((size + 2 * HEADER_SIZE - 1) & ~(HEADER_SIZE - 1), 16);
+  else
+  {
+    if (sizeClass <= MAX_THREAD_CLASS)
+    {
+      std::vector<void*>& blocks = threadCache.m_free[sizeClass];
+      if (blocks.empty())
+        GetSharedFreeLists().PopBatch(sizeClass, blocks);
+      if (!blocks.empty())
+      {
+        block = blocks.back();
+        blocks.pop_back();
+      }
+    }
+    else
+      block = GetSharedFreeLists().Pop(sizeClass);
+
+    if (!block)
+      block = KODI::MEMORY::AlignedMalloc(ClassSize(sizeClass), 16);
+  }
+
+  if (!block)
+    return nullptr;
+
+  static_cast<SBlockHeader*>(block)->sizeClass = sizeClass;
+  return static_cast<uint8_t*>(block) + HEADER_SIZE;
+}
+
+void CDVDDemuxPacketPool::Free(void* data)
+{
+  if (!data)
+    return;
+
+  void* block = static_cast<uint8_t*>(data) - HEADER_SIZE;
+  const unsigned int sizeClass = static_cast<SBlockHeader*>(block)->sizeClass;
+
+  if (sizeClass == UNPOOLED)
+    KODI::MEMORY::AlignedFree(block);
+  else if (sizeClass <= MAX_THREAD_CLASS)
+  {
+    std::vector<void*>& blocks = threadCache.m_free[sizeClass];
+    if (blocks.size() >= THREAD_CACHE_ENTRIES)
+      GetSharedFreeLists().PushBatch(sizeClass, blocks, BATCH_SIZE);
+    blocks.push_back(block);
+  }
+  else
+    GetSharedFreeLists().Push(sizeClass, block);
+}
+
+size_t CDVDDemuxPacketPool::GetRetainedSize()
+{
+  return GetSharedFreeLists().GetRetainedSize();
+}
@@ -0,0 +1,39 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/*!
+ \brief Size class allocator for demux packets and their payload.
+
+ Blocks are rounded up to a power of two and recycled instead of being returned
+ to the heap. Every thread keeps a few of the smaller blocks, which it exchanges
+ in batches with free lists shared by all threads, so the demuxer and the codec
+ threads freeing the packets only take a lock once per batch. The memory kept
+ in the shared free lists is bounded, blocks beyond that are freed.
+ */
+class CDVDDemuxPacketPool
+{
+public:
+  /*!
+   \brief Allocate a 16 byte aligned block of at least the given size.
+   */
+  static void* Allocate(size_t size);
+
+  /*!
+   \brief Return a block allocated by Allocate, from any thread.
+   */
+  static void Free(void* block);
+
+  /*!
+   \brief Bytes currently kept in the shared free lists.
+   */
+  static size_t GetRetainedSize();
+};
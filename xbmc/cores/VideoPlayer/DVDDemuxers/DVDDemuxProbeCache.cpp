@@ -0,0 +1,197 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDDemuxProbeCache.h"
+
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace
+{
+bool IsAudioOrVideo(const AVStream* stream)
+{
+  return stream->codecpar->codec_type == AVMEDIA_TYPE_AUDIO ||
+         stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO;
+}
+
+bool IsComplete(const AVCodecParameters* codecpar)
+{
+  if (codecpar->codec_type == AVMEDIA_TYPE_VIDEO)
+    return codecpar->width > 0 && codecpar->height > 0;
+
+  return codecpar->sample_rate > 0 && codecpar->channels > 0;
+}
+} // namespace
+
+CDVDDemuxProbeCache& CDVDDemuxProbeCache::GetInstance()
+{
+  static CDVDDemuxProbeCache cache;
+  return cache;
+}
+
+void CDVDDemuxProbeCache::Store(const std::string& key, const AVFormatContext* context)
+{
+  SEntry entry;
+  entry.format = context->iformat->name;
+
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    const AVStream* stream = context->streams[i];
+    const AVCodecParameters* codecpar = stream->codecpar;
+    if (!IsAudioOrVideo(stream))
+      continue;
+
+    // a stream probing didn't make sense of wouldn't let the next open skip it
+    if (codecpar->codec_id == AV_CODEC_ID_NONE || !IsComplete(codecpar))
+      return;
+
+    SStream cached;
+    cached.id = stream->id;
+    cached.type = codecpar->codec_type;
+    cached.codec = codecpar->codec_id;
+    cached.codecTag = codecpar->codec_tag;
+    if (codecpar->extradata && codecpar->extradata_size > 0)
+      cached.extradata.assign(codecpar->extradata, codecpar->extradata + codecpar->extradata_size);
+    cached.format = codecpar->format;
+    cached.profile = codecpar->profile;
+    cached.level = codecpar->level;
+    cached.bitRate = codecpar->bit_rate;
+    cached.bitsPerCodedSample = codecpar->bits_per_coded_sample;
+    cached.width = codecpar->width;
+    cached.height = codecpar->height;
+    cached.sampleAspectRatio = codecpar->sample_aspect_ratio;
+    cached.avgFrameRate = stream->avg_frame_rate;
+    cached.rFrameRate = stream->r_frame_rate;
+    cached.sampleRate = codecpar->sample_rate;
+    cached.channels = codecpar->channels;
+    cached.channelLayout = codecpar->channel_layout;
+    entry.streams.push_back(std::move(cached));
+  }
+
+  if (entry.streams.empty())
+    return;
+
+  CSingleLock lock(m_section);
+
+  entry.lastUse = ++m_uses;
+  m_entries[key] = std::move(entry);
+
+  if (m_entries.size() > MAX_ENTRIES)
+  {
+    auto oldest = std::min_element(m_entries.begin(), m_entries.end(),
+                                   [](const std::pair<const std::string, SEntry>& a,
+                                      const std::pair<const std::string, SEntry>& b) {
+                                     return a.second.lastUse < b.second.lastUse;
+                                   });
+    m_entries.erase(oldest);
+  }
+}
+
+bool CDVDDemuxProbeCache::Restore(const std::string& key, AVFormatContext* context, bool extradata)
+{
+  CSingleLock lock(m_section);
+
+  auto it = m_entries.find(key);
+  if (it == m_entries.end())
+    return false;
+
+  SEntry& entry = it->second;
+  entry.lastUse = ++m_uses;
+
+  if (entry.format != context->iformat->name)
+    return false;
+
+  // match first, the context is left untouched if the streams have changed
+  std::vector<std::pair<AVStream*, const SStream*>> matches;
+  for (unsigned int i = 0; i < context->nb_streams; i++)
+  {
+    AVStream* stream = context->streams[i];
+    if (!IsAudioOrVideo(stream))
+      continue;
+
+    auto cached = std::find_if(entry.streams.begin(), entry.streams.end(),
+                               [stream](const SStream& cached) {
+                                 return cached.id == stream->id &&
+                                        cached.type == stream->codecpar->codec_type &&
+                                        cached.codec == stream->codecpar->codec_id;
+                               });
+    if (cached == entry.streams.end())
+      return false;
+
+    matches.emplace_back(stream, &*cached);
+  }
+
+  if (matches.size() != entry.streams.size())
+    return false;
+
+  for (const auto& match : matches)
+  {
+    AVStream* stream = match.first;
+    AVCodecParameters* codecpar = stream->codecpar;
+    const SStream& cached = *match.second;
+
+    if (codecpar->codec_tag == 0)
+      codecpar->codec_tag = cached.codecTag;
+    if (extradata && !codecpar->extradata && !cached.extradata.empty())
+    {
+      codecpar->extradata = static_cast<uint8_t*>(
+          av_mallocz(cached.extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+      if (codecpar->extradata)
+      {
+        memcpy(codecpar->extradata, cached.extradata.data(), cached.extradata.size());
+        codecpar->extradata_size = static_cast<int>(cached.extradata.size());
+      }
+    }
+    if (codecpar->format < 0)
+      codecpar->format = cached.format;
+    if (codecpar->profile == FF_PROFILE_UNKNOWN)
+      codecpar->profile = cached.profile;
+    if (codecpar->level == FF_LEVEL_UNKNOWN)
+      codecpar->level = cached.level;
+    if (codecpar->bit_rate == 0)
+      codecpar->bit_rate = cached.bitRate;
+    if (codecpar->bits_per_coded_sample == 0)
+      codecpar->bits_per_coded_sample = cached.bitsPerCodedSample;
+
+    if (codecpar->codec_type == AVMEDIA_TYPE_VIDEO)
+    {
+      if (codecpar->width == 0 || codecpar->height == 0)
+      {
+        codecpar->width = cached.width;
+        codecpar->height = cached.height;
+      }
+      if (codecpar->sample_aspect_ratio.num == 0)
+        codecpar->sample_aspect_ratio = cached.sampleAspectRatio;
+      if (stream->avg_frame_rate.num == 0)
+        stream->avg_frame_rate = cached.avgFrameRate;
+      if (stream->r_frame_rate.num == 0)
+        stream->r_frame_rate = cached.rFrameRate;
+    }
+    else
+    {
+      if (codecpar->sample_rate == 0)
+        codecpar->sample_rate = cached.sampleRate;
+      if (codecpar->channels == 0)
+      {
+        codecpar->channels = cached.channels;
+        codecpar->channel_layout = cached.channelLayout;
+      }
+    }
+
+    if (!IsComplete(codecpar))
+      return false;
+  }
+
+  return true;
+}
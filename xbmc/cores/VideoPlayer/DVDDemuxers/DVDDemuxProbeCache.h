@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavutil/avutil.h>
+#include <libavcodec/avcodec.h>
+}
+
+struct AVFormatContext;
+
+/*!
+ \brief Stream layout found by avformat_find_stream_info, per channel.
+
+ Probing a live stream takes the biggest part of a channel switch. When a
+ channel is opened again and the format context shows the same streams as last
+ time (stream ids and codecs), the parameters probed back then are restored
+ and the demuxer skips probing. Streams that differ fall back to a full probe,
+ which replaces the cached layout.
+ */
+class CDVDDemuxProbeCache
+{
+public:
+  static CDVDDemuxProbeCache& GetInstance();
+
+  /*!
+   \brief Remember the audio and video streams of a probed format context.
+   */
+  void Store(const std::string& key, const AVFormatContext* context);
+
+  /*!
+   \brief Complete the streams of a format context which has just been opened
+   with the parameters cached for the key.
+   \param extradata restore codec extradata too, the transport stream demuxer
+   waits for the parsers to find it before playback starts with a key frame
+   \return true if the context has the same audio and video streams as cached
+   and all of them are complete, probing can be skipped then
+   */
+  bool Restore(const std::string& key, AVFormatContext* context, bool extradata);
+
+private:
+  CDVDDemuxProbeCache() = default;
+  CDVDDemuxProbeCache(const CDVDDemuxProbeCache&) = delete;
+  CDVDDemuxProbeCache& operator=(const CDVDDemuxProbeCache&) = delete;
+
+  struct SStream
+  {
+    int id; // e.g. the PID of a transport stream
+    AVMediaType type;
+    AVCodecID codec;
+    uint32_t codecTag;
+    std::vector<uint8_t> extradata;
+    int format;
+    int profile;
+    int level;
+    int64_t bitRate;
+    int bitsPerCodedSample;
+    int width;
+    int height;
+    AVRational sampleAspectRatio;
+    AVRational avgFrameRate;
+    AVRational rFrameRate;
+    int sampleRate;
+    int channels;
+    uint64_t channelLayout;
+  };
+
+  struct SEntry
+  {
+    std::string format;
+    std::vector<SStream> streams;
+    uint64_t lastUse;
+  };
+
+  static const size_t MAX_ENTRIES = 64;
+
+  CCriticalSection m_section;
+  std::map<std::string, SEntry> m_entries;
+  uint64_t m_uses = 0;
+};
@@ -7,20 +7,44 @@
  */
 
 #include "DVDDemuxUtils.h"
+#include "DVDDemuxPacketPool.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxCrypto.h"
 #include "utils/log.h"
-#include "utils/MemUtils.h"
 
 extern "C" {
 #include <libavcodec/avcodec.h>
 }
 
+#include <new>
+
+namespace
+{
+DemuxPacket* NewDemuxPacket()
+{
+  void* storage = CDVDDemuxPacketPool::Allocate(sizeof(DemuxPacket));
+  if (!storage)
+    return nullptr;
+  return new (storage) DemuxPacket();
+}
+
+void DeleteDemuxPacket(DemuxPacket* pPacket)
+{
+  pPacket->~DemuxPacket();
+  CDVDDemuxPacketPool::Free(pPacket);
+}
+} // namespace
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
-    if (pPacket->pData)
-      KODI::MEMORY::AlignedFree(pPacket->pData);
+    if (pPacket->pDataRef)
+    {
+      AVBufferRef* ref = static_cast<AVBufferRef*>(pPacket->pDataRef);
+      av_buffer_unref(&ref);
+    }
+    else if (pPacket->pData)
+      CDVDDemuxPacketPool::Free(pPacket->pData);
     if (pPacket->iSideDataElems)
     {
       AVPacket avPkt;
@@ -29,13 +53,15 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
       avPkt.side_data_elems = pPacket->iSideDataElems;
       av_packet_free_side_data(&avPkt);
     }
-    delete pPacket;
+    DeleteDemuxPacket(pPacket);
   }
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket();
+  DemuxPacket* pPacket = NewDemuxPacket();
+  if (!pPacket)
+    return NULL;
 
   if (iDataSize > 0)
   {
@@ -48,7 +74,7 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16));
+    pPacket->pData = static_cast<uint8_t*>(CDVDDemuxPacketPool::Allocate(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE));
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
@@ -70,6 +96,38 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigne
   return ret;
 }
 
+DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacketRef(const AVPacket* src)
+{
+  // the buffer must be ours alone, with the padding decoders rely on behind the payload
+  const AVBufferRef* buf = src->buf;
+  if (buf && src->data && av_buffer_is_writable(buf) &&
+      src->data >= buf->data &&
+      src->data + src->size + AV_INPUT_BUFFER_PADDING_SIZE <= buf->data + buf->size)
+  {
+    DemuxPacket* pPacket = NewDemuxPacket();
+    if (!pPacket)
+      return nullptr;
+    pPacket->pDataRef = av_buffer_ref(src->buf);
+    if (!pPacket->pDataRef)
+    {
+      DeleteDemuxPacket(pPacket);
+      return nullptr;
+    }
+    pPacket->pData = src->data;
+    pPacket->iSize = src->size;
+    return pPacket;
+  }
+
+  DemuxPacket* pPacket = AllocateDemuxPacket(src->size);
+  if (pPacket)
+  {
+    pPacket->iSize = src->size;
+    if (src->data)
+      memcpy(pPacket->pData, src->data, src->size);
+  }
+  return pPacket;
+}
+
 void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
 {
   AVPacket avPkt;
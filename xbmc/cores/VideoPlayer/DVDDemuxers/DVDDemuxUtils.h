@@ -19,6 +19,11 @@ public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
+  /*!
+   \brief Allocate a packet sharing the payload of a reference counted AVPacket.
+   The payload is copied if the AVPacket's buffer can't be shared.
+   */
+  static DemuxPacket* AllocateDemuxPacketRef(const AVPacket* src);
   static void StoreSideData(DemuxPacket *pkt, AVPacket *src);
 };
 
@@ -27,6 +27,7 @@
 #include "DVDDemuxers/DVDDemux.h"
 #include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDCodecs/DVDCodecs.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDCodecs/Video/DVDVideoCodec.h"
 #include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
@@ -53,7 +54,7 @@ bool CDVDFileInfo::GetFileDuration(const std::string &path, int& duration)
   std::unique_ptr<CDVDDemux> demux;
 
   CFileItem item(path, false);
-  auto input = CDVDFactoryInputStream::CreateInputStream(NULL, item);
+  auto input = CDVDFactoryInputStream::CreateInputStream(NULL, item, false, XFILE::READ_MMAP);
   if (!input)
     return false;
 
@@ -96,7 +97,7 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
 
   CFileItem item(fileItem);
   item.SetMimeTypeForInternetFile();
-  auto pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, item);
+  auto pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, item, false, XFILE::READ_MMAP);
   if (!pInputStream)
   {
     CLog::Log(LOGERROR, "InputStream: Error creating stream for %s", redactPath.c_str());
@@ -195,7 +196,30 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
     CDVDStreamInfo hint(*pDemuxer->GetStream(demuxerId, nVideoStream), true);
     hint.codecOptions = CODEC_FORCE_SOFTWARE;
 
-    pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
+    if (hint.externalInterfaces)
+      pVideoCodec = CDVDFactoryCodec::CreateVideoCodec(hint, *pProcessInfo);
+    else
+    {
+      // only the first picture after the seek is needed, and at thumbnail size:
+      // skip frames nothing refers to and decode downscaled where the codec
+      // supports it. Deblocking stays on, without it the errors accumulate over
+      // the reference frames up to the picture and show as blocks in the thumb.
+      CDVDCodecOptions options;
+      options.m_keys.emplace_back("skip_frame", "nonref");
+      const int imageRes = static_cast<int>(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
+      int lowres = 0;
+      while (imageRes > 0 && lowres < 3 && (hint.width >> (lowres + 1)) >= imageRes)
+        lowres++;
+      if (lowres > 0)
+        options.m_keys.emplace_back("lowres", std::to_string(lowres));
+
+      pVideoCodec = new CDVDVideoCodecFFmpeg(*pProcessInfo);
+      if (!pVideoCodec->Open(hint, options))
+      {
+        delete pVideoCodec;
+        pVideoCodec = nullptr;
+      }
+    }
 
     if (pVideoCodec)
     {
@@ -322,7 +346,7 @@ bool CDVDFileInfo::GetFileStreamDetails(CFileItem *pItem)
 
   CFileItem item(playablePath, false);
   item.SetMimeTypeForInternetFile();
-  auto pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, item);
+  auto pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, item, false, XFILE::READ_MMAP);
   if (!pInputStream)
     return false;
 
@@ -32,7 +32,7 @@
 #include "utils/URIUtils.h"
 
 
-std::shared_ptr<CDVDInputStream> CDVDFactoryInputStream::CreateInputStream(IVideoPlayer* pPlayer, const CFileItem &fileitem, bool scanforextaudio)
+std::shared_ptr<CDVDInputStream> CDVDFactoryInputStream::CreateInputStream(IVideoPlayer* pPlayer, const CFileItem &fileitem, bool scanforextaudio, unsigned int fileFlags)
 {
   using namespace ADDON;
 
@@ -177,7 +177,8 @@ std::shared_ptr<CDVDInputStream> CDVDFactoryInputStream::CreateInputStream(IVide
   return std::shared_ptr<CDVDInputStreamFile>(new CDVDInputStreamFile(finalFileitem,
                                                                       XFILE::READ_TRUNCATED |
                                                                       XFILE::READ_BITRATE |
-                                                                      XFILE::READ_CHUNKED));
+                                                                      XFILE::READ_CHUNKED |
+                                                                      fileFlags));
 }
 
 std::shared_ptr<CDVDInputStream> CDVDFactoryInputStream::CreateInputStream(IVideoPlayer* pPlayer, const CFileItem &fileitem, const std::vector<std::string>& filenames)
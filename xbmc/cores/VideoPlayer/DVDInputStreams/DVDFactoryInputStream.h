@@ -20,6 +20,11 @@ class IVideoPlayer;
 class CDVDFactoryInputStream
 {
 public:
-  static std::shared_ptr<CDVDInputStream> CreateInputStream(IVideoPlayer* pPlayer, const CFileItem &fileitem, bool scanforextaudio = false);
+  /*!
+   \brief Create the input stream for an item
+   \param fileFlags extra XFILE::READ_* flags for items read through CFile, e.g. READ_MMAP for
+          short lived streams whose file is not expected to change while it's open
+   */
+  static std::shared_ptr<CDVDInputStream> CreateInputStream(IVideoPlayer* pPlayer, const CFileItem &fileitem, bool scanforextaudio = false, unsigned int fileFlags = 0);
   static std::shared_ptr<CDVDInputStream> CreateInputStream(IVideoPlayer* pPlayer, const CFileItem &fileitem, const std::vector<std::string>& filenames);
 };
@@ -187,6 +187,7 @@ public:
   virtual IChapter* GetIChapter() { return nullptr; }
 
   const CVariant &GetProperty(const std::string key){ return m_item.GetProperty(key); }
+  bool IsPVRChannel() const { return m_item.IsPVRChannel(); }
 
 protected:
   DVDStreamType m_streamType;
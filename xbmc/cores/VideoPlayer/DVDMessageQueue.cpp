@@ -47,13 +47,16 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
 
-  m_messages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
-
-  m_prioMessages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
+  m_messages.Remove(type);
+
+  auto it = std::remove_if(m_prioMessages.begin(), m_prioMessages.end(),
+                           [type](const SMessage &item){
+                             if (type != CDVDMsg::NONE && !item.message->IsType(type))
+                               return false;
+                             item.message->Release();
+                             return true;
+                           });
+  m_prioMessages.erase(it, m_prioMessages.end());
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
@@ -117,14 +120,14 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
       prio++;
 
     auto it = std::find_if(m_prioMessages.begin(), m_prioMessages.end(),
-                           [prio](const DVDMessageListItem &item){
+                           [prio](const SMessage &item){
                              return prio <= item.priority;
                            });
-    m_prioMessages.emplace(it, pMsg, priority);
+    m_prioMessages.insert(it, {pMsg, priority});
   }
   else
   {
-    if (m_messages.empty())
+    if (m_messages.Empty())
     {
       m_iDataSize = 0;
       m_TimeBack = DVD_NOPTS_VALUE;
@@ -132,9 +135,9 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
     }
 
     if (front)
-      m_messages.emplace_front(pMsg, priority);
+      m_messages.PushFront({pMsg, priority});
     else
-      m_messages.emplace_back(pMsg, priority);
+      m_messages.PushBack({pMsg, priority});
   }
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
@@ -150,8 +153,6 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
     }
   }
 
-  pMsg->Release();
-
   // inform waiter for new packet
   m_hEvent.Set();
 
@@ -174,24 +175,32 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
-
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+    const bool prio = priority > 0 || !m_prioMessages.empty();
+    SMessage* item = nullptr;
+    if (prio && !m_prioMessages.empty())
+      item = &m_prioMessages.back();
+    else if (!prio && !m_messages.Empty())
+      item = &m_messages.Back();
+
+    if (item && (item->priority >= priority || m_drain))
     {
-      DVDMessageListItem& item(msgs.back());
-      priority = item.priority;
+      priority = item->priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      if (item->message->IsType(CDVDMsg::DEMUXER_PACKET) && item->priority == 0)
       {
-        DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
+        DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item->message)->GetPacket();
         if (packet)
         {
           m_iDataSize -= packet->iSize;
         }
       }
 
-      *pMsg = item.message->Acquire();
-      msgs.pop_back();
+      // the queue's reference goes to the caller
+      *pMsg = item->message;
+      if (prio)
+        m_prioMessages.pop_back();
+      else
+        m_messages.PopBack();
       UpdateTimeBack();
       ret = MSGQ_OK;
       break;
@@ -222,9 +231,9 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
 void CDVDMessageQueue::UpdateTimeFront()
 {
-  if (!m_messages.empty())
+  if (!m_messages.Empty())
   {
-    auto &item = m_messages.front();
+    const SMessage& item = m_messages.Front();
     if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
     {
       DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
@@ -236,7 +245,7 @@ void CDVDMessageQueue::UpdateTimeFront()
           m_TimeFront = packet->pts;
 
         if (m_TimeBack == DVD_NOPTS_VALUE)
-          m_TimeBack = m_TimeFront;
+          m_TimeBack = m_TimeFront.load();
       }
     }
   }
@@ -244,9 +253,9 @@ void CDVDMessageQueue::UpdateTimeFront()
 
 void CDVDMessageQueue::UpdateTimeBack()
 {
-  if (!m_messages.empty())
+  if (!m_messages.Empty())
   {
-    auto &item = m_messages.back();
+    const SMessage& item = m_messages.Back();
     if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
     {
       DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
@@ -258,7 +267,7 @@ void CDVDMessageQueue::UpdateTimeBack()
           m_TimeBack = packet->pts;
 
         if (m_TimeFront == DVD_NOPTS_VALUE)
-          m_TimeFront = m_TimeBack;
+          m_TimeFront = m_TimeBack.load();
       }
     }
   }
@@ -272,9 +281,9 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     return 0;
 
   unsigned count = 0;
-  for (const auto &item : m_messages)
+  for (size_t i = 0; i < m_messages.Size(); i++)
   {
-    if(item.message->IsType(type))
+    if(m_messages.At(i).message->IsType(type))
       count++;
   }
   for (const auto &item : m_prioMessages)
@@ -307,22 +316,26 @@ void CDVDMessageQueue::WaitUntilEmpty()
 
 int CDVDMessageQueue::GetLevel() const
 {
-  CSingleLock lock(m_section);
+  // the demuxer polls this for every packet it reads, so work on a snapshot
+  // of the counters instead of taking the lock
+  const int dataSize = m_iDataSize;
+  const double timeFront = m_TimeFront;
+  const double timeBack = m_TimeBack;
 
-  if (m_iDataSize > m_iMaxDataSize)
+  if (dataSize > m_iMaxDataSize)
     return 100;
-  if (m_iDataSize == 0)
+  if (dataSize == 0)
     return 0;
 
-  if (IsDataBased())
+  if (IsDataBased(timeFront, timeBack))
   {
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
+    return std::min(100, 100 * dataSize / m_iMaxDataSize);
   }
 
-  int level = std::min(100.0, ceil(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
+  int level = std::min(100.0, ceil(100.0 * m_TimeSize * (timeFront - timeBack) / DVD_TIME_BASE ));
 
   // if we added lots of packets with NOPTS, make sure that the queue is not signalled empty
-  if (level == 0 && m_iDataSize != 0)
+  if (level == 0 && dataSize != 0)
   {
     CLog::Log(LOGDEBUG, "CDVDMessageQueue::GetLevel() - can't determine level");
     return 1;
@@ -333,17 +346,67 @@ int CDVDMessageQueue::GetLevel() const
 
 int CDVDMessageQueue::GetTimeSize() const
 {
-  CSingleLock lock(m_section);
+  const double timeFront = m_TimeFront;
+  const double timeBack = m_TimeBack;
 
-  if (IsDataBased())
+  if (IsDataBased(timeFront, timeBack))
     return 0;
   else
-    return (int)((m_TimeFront - m_TimeBack) / DVD_TIME_BASE);
+    return (int)((timeFront - timeBack) / DVD_TIME_BASE);
 }
 
 bool CDVDMessageQueue::IsDataBased() const
 {
-  return (m_TimeBack == DVD_NOPTS_VALUE  ||
-          m_TimeFront == DVD_NOPTS_VALUE ||
-          m_TimeFront <= m_TimeBack);
+  return IsDataBased(m_TimeFront, m_TimeBack);
+}
+
+bool CDVDMessageQueue::IsDataBased(double timeFront, double timeBack)
+{
+  return (timeBack == DVD_NOPTS_VALUE  ||
+          timeFront == DVD_NOPTS_VALUE ||
+          timeFront <= timeBack);
+}
+
+void CDVDMessageQueue::CMessageRing::PushFront(const SMessage& message)
+{
+  if (m_size == m_slots.size())
+    Grow();
+
+  m_head = (m_head - 1) & (m_slots.size() - 1);
+  m_slots[m_head] = message;
+  m_size++;
+}
+
+void CDVDMessageQueue::CMessageRing::PushBack(const SMessage& message)
+{
+  if (m_size == m_slots.size())
+    Grow();
+
+  m_size++;
+  Back() = message;
+}
+
+void CDVDMessageQueue::CMessageRing::Remove(CDVDMsg::Message type)
+{
+  size_t kept = 0;
+  for (size_t i = 0; i < m_size; i++)
+  {
+    SMessage& item = At(i);
+    if (type == CDVDMsg::NONE || item.message->IsType(type))
+      item.message->Release();
+    else
+      At(kept++) = item;
+  }
+  m_size = kept;
+}
+
+void CDVDMessageQueue::CMessageRing::Grow()
+{
+  // keep the capacity a power of two for the index masks
+  std::vector<SMessage> slots(std::max<size_t>(64, m_slots.size() * 2));
+  for (size_t i = 0; i < m_size; i++)
+    slots[i] = At(i);
+
+  m_slots.swap(slots);
+  m_head = 0;
 }
@@ -14,33 +14,8 @@
 
 #include <algorithm>
 #include <atomic>
-#include <list>
 #include <string>
-
-struct DVDMessageListItem
-{
-  DVDMessageListItem(CDVDMsg* msg, int prio)
-  {
-    message = msg->Acquire();
-    priority = prio;
-  }
-  DVDMessageListItem()
-  {
-    message = NULL;
-    priority = 0;
-  }
-  DVDMessageListItem(const DVDMessageListItem&) = delete;
- ~DVDMessageListItem()
-  {
-    if(message)
-      message->Release();
-  }
-
-  DVDMessageListItem& operator=(const DVDMessageListItem&) = delete;
-
-  CDVDMsg* message;
-  int priority;
-};
+#include <vector>
 
 enum MsgQueueReturnCode
 {
@@ -86,7 +61,7 @@ public:
   bool ReceivedAbortRequest() { return m_bAbortRequest; }
   void WaitUntilEmpty();
 
-  // non messagequeue related functions
+  // non messagequeue related functions, these don't take the lock
   bool IsFull() const { return GetLevel() == 100; }
   int GetLevel() const;
 
@@ -98,10 +73,54 @@ public:
   bool IsDataBased() const;
 
 private:
+  struct SMessage
+  {
+    CDVDMsg* message;
+    int priority;
+  };
+
+  /*!
+   \brief Circular buffer of messages, the front holds the newest message and
+   Get takes from the back. It grows by doubling and is never shrunk, so a
+   queue stops allocating once it reached its working size.
+
+   Like the list it replaces it has no capacity limit of its own, dropping or
+   refusing control messages would break playback. Its size is bounded by the
+   producers, which stop putting packets once IsFull() reports the data or
+   time limit of the queue reached.
+   */
+  class CMessageRing
+  {
+  public:
+    bool Empty() const { return m_size == 0; }
+    size_t Size() const { return m_size; }
+    SMessage& At(size_t index) { return m_slots[(m_head + index) & (m_slots.size() - 1)]; }
+    const SMessage& At(size_t index) const { return m_slots[(m_head + index) & (m_slots.size() - 1)]; }
+    SMessage& Front() { return At(0); }
+    SMessage& Back() { return At(m_size - 1); }
+
+    void PushFront(const SMessage& message);
+    void PushBack(const SMessage& message);
+    void PopBack() { m_size--; }
+
+    /*!
+     \brief Release and remove the messages of the given type, all of them
+     for CDVDMsg::NONE, keeping the order of the others.
+     */
+    void Remove(CDVDMsg::Message type);
+
+  private:
+    void Grow();
+
+    std::vector<SMessage> m_slots;
+    size_t m_head = 0;
+    size_t m_size = 0;
+  };
 
   MsgQueueReturnCode Put(CDVDMsg* pMsg, int priority, bool front);
   void UpdateTimeFront();
   void UpdateTimeBack();
+  static bool IsDataBased(double timeFront, double timeBack);
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
@@ -110,15 +129,16 @@ private:
   bool m_bInitialized;
   bool m_drain = false;
 
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  // written under m_section, read without it by the level queries
+  std::atomic<int> m_iDataSize;
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
-  std::list<DVDMessageListItem> m_prioMessages;
+  CMessageRing m_messages;
+  // sorted by ascending priority, usually holds a handful of messages at most
+  std::vector<SMessage> m_prioMessages;
 };
-
@@ -16,6 +16,7 @@ extern "C" {
 
 #define CODEC_FORCE_SOFTWARE 0x01
 #define CODEC_ALLOW_FALLBACK 0x02
+#define CODEC_LOW_LATENCY 0x04 // favour output delay over decode throughput, e.g. live tv
 
 class CDemuxStream;
 struct DemuxCryptoSession;
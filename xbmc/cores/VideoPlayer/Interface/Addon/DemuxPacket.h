@@ -44,6 +44,10 @@ extern "C"
     bool recoveryPoint = false;
 
     std::shared_ptr<DemuxCryptoInfo> cryptoInfo;
+
+    // reference counted buffer (AVBufferRef) holding pData if the payload is shared
+    // with the demuxer, nullptr if pData is owned by the packet
+    void* pDataRef = nullptr;
   } DemuxPacket;
 
 #ifdef __cplusplus
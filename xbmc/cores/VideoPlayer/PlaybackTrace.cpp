@@ -0,0 +1,193 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PlaybackTrace.h"
+
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "filesystem/File.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <inttypes.h>
+
+namespace
+{
+int64_t Now()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* EventName(CPlaybackTrace::Event event)
+{
+  switch (event)
+  {
+    case CPlaybackTrace::Event::DEMUX:
+      return "demux";
+    case CPlaybackTrace::Event::QUEUE_IN:
+      return "queue in";
+    case CPlaybackTrace::Event::DECODE_START:
+      return "decode start";
+    case CPlaybackTrace::Event::DECODE_END:
+      return "decode end";
+    case CPlaybackTrace::Event::RENDER_QUEUE:
+      return "render queue";
+    case CPlaybackTrace::Event::PRESENT:
+      return "present";
+    case CPlaybackTrace::Event::DROP:
+      return "drop";
+    case CPlaybackTrace::Event::DROP_REQUEST:
+      return "drop request";
+  }
+  return "unknown";
+}
+
+const char* DropReasonName(CPlaybackTrace::DropReason reason)
+{
+  switch (reason)
+  {
+    case CPlaybackTrace::DropReason::NONE:
+      return "none";
+    case CPlaybackTrace::DropReason::LATE:
+      return "late";
+    case CPlaybackTrace::DropReason::DECODER:
+      return "decoder";
+    case CPlaybackTrace::DropReason::SPEED:
+      return "speed";
+    case CPlaybackTrace::DropReason::RENDER_QUEUE:
+      return "render queue";
+    case CPlaybackTrace::DropReason::RENDER_LATE:
+      return "render late";
+  }
+  return "unknown";
+}
+
+// the thread the event is recorded on, to give each its own lane
+int EventThread(CPlaybackTrace::Event event)
+{
+  switch (event)
+  {
+    case CPlaybackTrace::Event::DEMUX:
+    case CPlaybackTrace::Event::QUEUE_IN:
+      return 1;
+    case CPlaybackTrace::Event::PRESENT:
+      return 3;
+    default:
+      return 2;
+  }
+}
+} // namespace
+
+CPlaybackTrace& CPlaybackTrace::GetInstance()
+{
+  static CPlaybackTrace trace;
+  return trace;
+}
+
+void CPlaybackTrace::Start(size_t events)
+{
+  m_enabled = false;
+
+  // threads of the previous playback may still be in Add, only allocate while
+  // nothing was ever recorded
+  if (m_events.empty())
+  {
+    // a power of two, so the ring index is a mask
+    size_t size = 1;
+    while (size < events)
+      size <<= 1;
+    m_events.resize(size);
+  }
+  m_next = 0;
+  m_start = Now();
+
+  m_enabled = true;
+}
+
+void CPlaybackTrace::Stop()
+{
+  m_enabled = false;
+}
+
+void CPlaybackTrace::Add(Event event, double pts, DropReason reason)
+{
+  SEvent& item = m_events[m_next++ & (m_events.size() - 1)];
+  item.time = Now() - m_start;
+  item.pts = pts;
+  item.event = event;
+  item.reason = reason;
+}
+
+void CPlaybackTrace::Add(Event event, const DemuxPacket* packet, DropReason reason)
+{
+  // decoders pass the packet pts on to the picture, dts for packets without
+  Add(event, packet->pts != DVD_NOPTS_VALUE ? packet->pts : packet->dts, reason);
+}
+
+bool CPlaybackTrace::Export(const std::string& path) const
+{
+  const uint64_t next = m_next;
+  const uint64_t count = std::min<uint64_t>(next, m_events.size());
+  if (count == 0)
+    return false;
+
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"demuxer\"}},\n";
+  json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"video\"}},\n";
+  json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,\"args\":{\"name\":\"render\"}}";
+
+  for (uint64_t i = next - count; i < next; i++)
+  {
+    const SEvent& item = m_events[i & (m_events.size() - 1)];
+
+    // a frame is an async span from the demuxer to the screen, keyed by its pts.
+    // Frames without a timestamp can't be tied together and show as instants.
+    std::string phase;
+    std::string name = EventName(item.event);
+    std::string id;
+    if (item.pts == DVD_NOPTS_VALUE)
+      phase = "\"ph\":\"i\",\"s\":\"t\"";
+    else
+    {
+      if (item.event == Event::DEMUX)
+        phase = "\"ph\":\"b\"";
+      else if (item.event == Event::PRESENT || item.event == Event::DROP)
+        phase = "\"ph\":\"e\"";
+      else
+        phase = "\"ph\":\"n\"";
+      if (item.event == Event::DEMUX || item.event == Event::PRESENT || item.event == Event::DROP)
+        name = "frame";
+      id = StringUtils::Format(",\"cat\":\"frame\",\"id\":\"%.0f\"", item.pts);
+    }
+
+    std::string args = StringUtils::Format("\"pts\":%.0f,\"event\":\"%s\"",
+                                           item.pts == DVD_NOPTS_VALUE ? -1.0 : item.pts,
+                                           EventName(item.event));
+    if (item.event == Event::DROP || item.event == Event::DROP_REQUEST)
+      args += StringUtils::Format(",\"reason\":\"%s\"", DropReasonName(item.reason));
+
+    json += StringUtils::Format(",\n{\"name\":\"%s\",%s%s,\"ts\":%" PRId64 ",\"pid\":1,\"tid\":%d,\"args\":{%s}}",
+                                name.c_str(), phase.c_str(), id.c_str(), item.time,
+                                EventThread(item.event), args.c_str());
+  }
+  json += "\n]}\n";
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true) ||
+      file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CPlaybackTrace::Export - failed to write %s", path.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGINFO, "CPlaybackTrace::Export - wrote %" PRIu64 " events to %s", count, path.c_str());
+  return true;
+}
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct DemuxPacket;
+
+/*!
+ \brief Records where each video frame is on its way from the demuxer to the
+ screen, for finding out where latency accumulates and why frames are dropped.
+
+ Events go to a fixed size ring of compact records, the oldest are overwritten
+ once it is full. Frames are identified by their pts. Recording is enabled by
+ the <video><playbacktrace> advanced setting, the number of events to keep, and
+ the trace of a playback is written in Chrome trace event format
+ (chrome://tracing, Perfetto) when it ends.
+ */
+class CPlaybackTrace
+{
+public:
+  enum class Event : uint8_t
+  {
+    DEMUX,
+    QUEUE_IN,
+    DECODE_START,
+    DECODE_END,
+    RENDER_QUEUE,
+    PRESENT,
+    DROP,
+    DROP_REQUEST //!< the frame is meant to be dropped, its DROP or PRESENT event follows
+  };
+
+  enum class DropReason : uint8_t
+  {
+    NONE,
+    LATE,         //!< the decoder was asked to drop to catch up, see DROP_REQUEST
+    DECODER,      //!< the decoder dropped the picture
+    SPEED,        //!< not shown at the current playback speed
+    RENDER_QUEUE, //!< the render queue didn't take the picture
+    RENDER_LATE   //!< skipped by the renderer, already too late to show
+  };
+
+  static CPlaybackTrace& GetInstance();
+
+  /*!
+   \brief Start recording, discarding what was recorded before. The ring of
+   events is allocated by the first call and kept, so it never changes under a
+   thread that is still recording, later calls keep its size.
+   */
+  void Start(size_t events);
+  void Stop();
+  bool IsEnabled() const { return m_enabled; }
+
+  void Record(Event event, double pts, DropReason reason = DropReason::NONE)
+  {
+    if (m_enabled)
+      Add(event, pts, reason);
+  }
+
+  void Record(Event event, const DemuxPacket* packet, DropReason reason = DropReason::NONE)
+  {
+    if (m_enabled)
+      Add(event, packet, reason);
+  }
+
+  /*!
+   \brief Write the recorded events as Chrome trace JSON. Call it after Stop,
+   events recorded while writing may be torn.
+   */
+  bool Export(const std::string& path) const;
+
+private:
+  CPlaybackTrace() = default;
+  CPlaybackTrace(const CPlaybackTrace&) = delete;
+  CPlaybackTrace& operator=(const CPlaybackTrace&) = delete;
+
+  struct SEvent
+  {
+    int64_t time; // us since Start
+    double pts;
+    Event event;
+    DropReason reason;
+  };
+
+  void Add(Event event, double pts, DropReason reason);
+  void Add(Event event, const DemuxPacket* packet, DropReason reason);
+
+  std::atomic<bool> m_enabled{false};
+  std::atomic<uint64_t> m_next{0};
+  std::vector<SEvent> m_events;
+  std::atomic<int64_t> m_start{0};
+};
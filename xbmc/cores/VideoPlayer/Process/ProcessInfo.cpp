@@ -437,6 +437,12 @@ void CProcessInfo::UpdateRenderInfo(CRenderInfo &info)
   }
 }
 
+std::shared_ptr<IVideoBufferPool> CProcessInfo::GetRenderBufferPool()
+{
+  CSingleLock lock(m_renderSection);
+  return m_renderInfo.videoBufferPool;
+}
+
 void CProcessInfo::UpdateRenderBuffers(int queued, int discard, int free)
 {
   CSingleLock lock(m_renderSection);
@@ -76,6 +76,9 @@ public:
   void SetRenderClockSync(bool enabled);
   bool IsRenderClockSync();
   void UpdateRenderInfo(CRenderInfo &info);
+  // buffers of the renderer software decoders can decode into, not registered
+  // with the video buffer manager so only decoders asking for them get them
+  std::shared_ptr<IVideoBufferPool> GetRenderBufferPool();
   void UpdateRenderBuffers(int queued, int discard, int free);
   void GetRenderBuffers(int &queued, int &discard, int &free);
   virtual std::vector<AVPixelFormat> GetRenderFormats();
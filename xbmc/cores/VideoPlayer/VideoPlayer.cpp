@@ -25,6 +25,7 @@
 #include "DVDDemuxers/DVDDemuxFFmpeg.h"
 
 #include "DVDFileInfo.h"
+#include "PlaybackTrace.h"
 
 #include "utils/LangCodeExpander.h"
 #include "input/Key.h"
@@ -600,7 +601,8 @@ CVideoPlayer::CVideoPlayer(IPlayerCallback& callback)
       m_CurrentTeletext(STREAM_TELETEXT, VideoPlayer_TELETEXT),
       m_CurrentRadioRDS(STREAM_RADIO_RDS, VideoPlayer_RDS),
       m_messenger("player"),
-      m_renderManager(m_clock, this)
+      m_renderManager(m_clock, this),
+      m_preload(this)
 {
   m_outboundEvents.reset(new CJobQueue(false, 1, CJob::PRIORITY_NORMAL));
   m_players_created = false;
@@ -620,6 +622,7 @@ CVideoPlayer::CVideoPlayer(IPlayerCallback& callback)
   m_HasVideo = false;
   m_HasAudio = false;
   m_UpdateStreamDetails = false;
+  m_preloadRequested = false;
 
   memset(&m_SpeedState, 0, sizeof(m_SpeedState));
 
@@ -705,6 +708,8 @@ bool CVideoPlayer::CloseFile(bool reopen)
   if(m_pInputStream)
     m_pInputStream->Abort();
 
+  m_preload.Cancel();
+
   m_renderManager.UnInit();
 
   CLog::Log(LOGINFO, "VideoPlayer: waiting for threads to exit");
@@ -727,6 +732,19 @@ bool CVideoPlayer::CloseFile(bool reopen)
   return true;
 }
 
+bool CVideoPlayer::QueueNextFile(const CFileItem &file)
+{
+  if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoPreloadNextItem <= 0)
+    return false;
+
+  // the item stays queued either way, it is opened at the end of the current
+  // one if it can't be preloaded
+  if (CVideoPlayerPreload::CanPreload(file))
+    m_preload.Open(file);
+
+  return true;
+}
+
 bool CVideoPlayer::IsPlaying() const
 {
   return !m_bStop;
@@ -772,6 +790,16 @@ bool CVideoPlayer::OpenInputStream()
     return false;
   }
 
+  OpenExternalSubtitles();
+
+  m_clock.Reset();
+  m_dvd.Clear();
+
+  return true;
+}
+
+void CVideoPlayer::OpenExternalSubtitles()
+{
   // find any available external subtitles for non dvd files
   if (!m_pInputStream->IsStreamType(DVDSTREAM_TYPE_DVD) &&
       !m_pInputStream->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER))
@@ -803,11 +831,6 @@ bool CVideoPlayer::OpenInputStream()
       }
     } // end loop over all subtitle files
   }
-
-  m_clock.Reset();
-  m_dvd.Clear();
-
-  return true;
 }
 
 bool CVideoPlayer::OpenDemuxStream()
@@ -838,6 +861,13 @@ bool CVideoPlayer::OpenDemuxStream()
     return false;
   }
 
+  InitDemuxStreams();
+
+  return true;
+}
+
+void CVideoPlayer::InitDemuxStreams()
+{
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_DEMUX);
   m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NAV);
   m_SelectionStreams.Update(m_pInputStream, m_pDemuxer);
@@ -852,8 +882,6 @@ bool CVideoPlayer::OpenDemuxStream()
     m_pInputStream->SetReadRate((unsigned int) (len * 1000 / tim));
 
   m_offset_pts = 0;
-
-  return true;
 }
 
 void CVideoPlayer::CloseDemuxer()
@@ -1056,6 +1084,8 @@ bool CVideoPlayer::ReadPacket(DemuxPacket*& packet, CDemuxStream*& stream)
         CLog::Log(LOGERROR, "%s - Error demux packet doesn't belong to a valid stream", __FUNCTION__);
         return false;
       }
+      if (stream->type == STREAM_VIDEO)
+        CPlaybackTrace::GetInstance().Record(CPlaybackTrace::Event::DEMUX, packet);
       if(stream->source == STREAM_SOURCE_NONE)
       {
         m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_DEMUX);
@@ -1194,6 +1224,7 @@ void CVideoPlayer::Prepare()
   m_offset_pts = 0;
   m_CurrentAudio.lastdts = DVD_NOPTS_VALUE;
   m_CurrentVideo.lastdts = DVD_NOPTS_VALUE;
+  m_preloadRequested = false;
 
   IPlayerCallback *cb = &m_callback;
   CFileItem fileItem = m_item;
@@ -1307,6 +1338,10 @@ void CVideoPlayer::Process()
 {
   CServiceBroker::GetWinSystem()->RegisterRenderLoop(this);
 
+  const int traceEvents = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoPlaybackTrace;
+  if (traceEvents > 0)
+    CPlaybackTrace::GetInstance().Start(traceEvents);
+
   Prepare();
 
   while (!m_bAbortRequest)
@@ -1367,6 +1402,8 @@ void CVideoPlayer::Process()
     // update player state
     UpdatePlayState(200);
 
+    CheckPreloadNext();
+
     // make sure we run subtitle process here
     m_VideoPlayerSubtitle->Process(m_clock.GetClock() + m_State.time_offset - m_VideoPlayerVideo->GetSubtitleDelay(), m_State.time_offset);
 
@@ -1473,6 +1510,10 @@ void CVideoPlayer::Process()
         continue;
       }
 
+      // continue with the next playlist item if it has been opened already
+      if (OpenPreloadedItem())
+        continue;
+
       if (m_CurrentVideo.inited)
       {
         m_VideoPlayerVideo->SendMessage(new CDVDMsg(CDVDMsg::VIDEO_DRAIN));
@@ -1661,6 +1702,7 @@ void CVideoPlayer::ProcessVideoData(CDemuxStream* pStream, DemuxPacket* pPacket)
   if (CheckSceneSkip(m_CurrentVideo))
     drop = true;
 
+  CPlaybackTrace::GetInstance().Record(CPlaybackTrace::Event::QUEUE_IN, pPacket);
   m_VideoPlayerVideo->SendMessage(new CDVDMsgDemuxerPacket(pPacket, drop));
   m_CurrentVideo.packets++;
 }
@@ -2411,25 +2453,16 @@ void CVideoPlayer::OnExit()
 
   CServiceBroker::GetWinSystem()->UnregisterRenderLoop(this);
 
-  IPlayerCallback *cb = &m_callback;
-  CVideoSettings vs = m_processInfo->GetVideoSettings();
-  m_outboundEvents->Submit([=]() {
-    cb->StoreVideoSettings(fileItem, vs);
-  });
+  m_preload.Cancel();
 
-  CBookmark bookmark;
-  bookmark.totalTimeInSeconds = 0;
-  bookmark.timeInSeconds = 0;
-  if (m_State.startTime == 0)
+  CPlaybackTrace& trace = CPlaybackTrace::GetInstance();
+  if (trace.IsEnabled())
   {
-    bookmark.totalTimeInSeconds = m_State.timeMax / 1000;
-    bookmark.timeInSeconds = m_State.time / 1000;
+    trace.Stop();
+    trace.Export("special://logpath/playbacktrace.json");
   }
-  bookmark.player = m_name;
-  bookmark.playerState = GetPlayerState();
-  m_outboundEvents->Submit([=]() {
-    cb->OnPlayerCloseFile(fileItem, bookmark);
-  });
+
+  StoreFileState(fileItem);
 
   // destroy objects
   SAFE_DELETE(m_pDemuxer);
@@ -2448,6 +2481,7 @@ void CVideoPlayer::OnExit()
   CFFmpegLog::ClearLogLevel();
   m_bStop = true;
 
+  IPlayerCallback *cb = &m_callback;
   bool error = m_error;
   bool close = m_bCloseRequest;
   m_outboundEvents->Submit([=]() {
@@ -2471,27 +2505,11 @@ void CVideoPlayer::HandleMessages()
     {
       CDVDMsgOpenFile &msg(*static_cast<CDVDMsgOpenFile*>(pMsg));
 
-      IPlayerCallback *cb = &m_callback;
       CFileItem fileItem(m_item);
       UpdateFileItemStreamDetails(fileItem);
-      CVideoSettings vs = m_processInfo->GetVideoSettings();
-      m_outboundEvents->Submit([=]() {
-        cb->StoreVideoSettings(fileItem, vs);
-      });
+      StoreFileState(fileItem);
 
-      CBookmark bookmark;
-      bookmark.totalTimeInSeconds = 0;
-      bookmark.timeInSeconds = 0;
-      if (m_State.startTime == 0)
-      {
-        bookmark.totalTimeInSeconds = m_State.timeMax / 1000;
-        bookmark.timeInSeconds = m_State.time / 1000;
-      }
-      bookmark.player = m_name;
-      bookmark.playerState = GetPlayerState();
-      m_outboundEvents->Submit([=]() {
-        cb->OnPlayerCloseFile(fileItem, bookmark);
-      });
+      m_preload.Cancel();
 
       m_item = msg.GetItem();
       m_playerOptions = msg.GetOptions();
@@ -3570,6 +3588,11 @@ bool CVideoPlayer::OpenVideoStream(CDVDStreamInfo& hint, bool reset)
     }
   }
 
+  // frames held back by the decoder delay channel switches
+  if (m_pInputStream && m_pInputStream->IsRealtime() &&
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoLowLatencyDecoding)
+    hint.codecOptions |= CODEC_LOW_LATENCY;
+
   std::shared_ptr<CDVDInputStream::IMenus> pMenus = std::dynamic_pointer_cast<CDVDInputStream::IMenus>(m_pInputStream);
   if(pMenus && pMenus->IsInMenu())
     hint.stills = true;
@@ -4902,6 +4925,135 @@ void CVideoPlayer::UpdateFileItemStreamDetails(CFileItem& item)
   item.GetVideoInfoTag()->m_streamDetails.SetStreams(videoInfo, m_processInfo->GetMaxTime()/1000, audioInfo, subtitleInfo);
 }
 
+void CVideoPlayer::StoreFileState(const CFileItem& fileItem)
+{
+  IPlayerCallback *cb = &m_callback;
+  CVideoSettings vs = m_processInfo->GetVideoSettings();
+  m_outboundEvents->Submit([=]() {
+    cb->StoreVideoSettings(fileItem, vs);
+  });
+
+  CBookmark bookmark;
+  bookmark.totalTimeInSeconds = 0;
+  bookmark.timeInSeconds = 0;
+  if (m_State.startTime == 0)
+  {
+    bookmark.totalTimeInSeconds = m_State.timeMax / 1000;
+    bookmark.timeInSeconds = m_State.time / 1000;
+  }
+  bookmark.player = m_name;
+  bookmark.playerState = GetPlayerState();
+  m_outboundEvents->Submit([=]() {
+    cb->OnPlayerCloseFile(fileItem, bookmark);
+  });
+}
+
+//------------------------------------------------------------------------------
+// preloading of the next playlist item
+//------------------------------------------------------------------------------
+
+void CVideoPlayer::CheckPreloadNext()
+{
+  if (m_preloadRequested)
+    return;
+
+  const int preloadTime = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoPreloadNextItem;
+  if (preloadTime <= 0)
+    return;
+
+  if (m_pInputStream->IsRealtime() ||
+      m_pInputStream->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER) ||
+      std::dynamic_pointer_cast<CDVDInputStream::IMenus>(m_pInputStream))
+    return;
+
+  if (m_State.timeMax <= 0 || m_State.timeMax - m_State.time > preloadTime * 1000)
+    return;
+
+  // the application answers with QueueNextFile if there is a next item
+  m_preloadRequested = true;
+
+  IPlayerCallback *cb = &m_callback;
+  m_outboundEvents->Submit([=]() {
+    cb->OnQueueNextItem();
+  });
+}
+
+bool CVideoPlayer::OpenPreloadedItem()
+{
+  if (!m_preload.IsReady())
+    return false;
+
+  CFileItem item;
+  std::shared_ptr<CDVDInputStream> inputStream;
+  CDVDDemux* demuxer = nullptr;
+  if (!m_preload.Take(item, inputStream, demuxer))
+    return false;
+
+  CLog::Log(LOGINFO, "VideoPlayer: continue with preloaded item %s", CURL::GetRedacted(item.GetPath()).c_str());
+
+  // let the current item play out, the stream players are opened again for
+  // the streams of the next one
+  SetCaching(CACHESTATE_DONE);
+
+  CFileItem fileItem(m_item);
+  UpdateFileItemStreamDetails(fileItem);
+
+  CloseStream(m_CurrentAudio, true);
+  CloseStream(m_CurrentVideo, true);
+  CloseStream(m_CurrentTeletext, false);
+  CloseStream(m_CurrentRadioRDS, false);
+  CloseStream(m_CurrentSubtitle, false);
+
+  StoreFileState(fileItem);
+
+  CloseDemuxer();
+  m_pSubtitleDemuxer.reset();
+  m_subtitleDemuxerMap.clear();
+  SAFE_DELETE(m_pCCDemuxer);
+  if (m_pInputStream.use_count() > 1)
+    throw std::runtime_error("m_pInputStream reference count is greater than 1");
+  m_pInputStream = inputStream;
+
+  m_SelectionStreams.Clear(STREAM_NONE, STREAM_SOURCE_NONE);
+
+  m_item = item;
+  m_playerOptions.starttime = 0;
+  m_playerOptions.startpercent = 0;
+  m_playerOptions.state.clear();
+  m_processInfo->SetPlayTimes(0,0,0,0);
+
+  m_Edl.Clear();
+  CServiceBroker::GetDataCacheCore().SetCutList(m_Edl.GetCutList());
+
+  m_State.Clear();
+  m_offset_pts = 0;
+  m_CurrentAudio.lastdts = DVD_NOPTS_VALUE;
+  m_CurrentVideo.lastdts = DVD_NOPTS_VALUE;
+  m_preloadRequested = false;
+
+  IPlayerCallback *cb = &m_callback;
+  CFileItem nextItem(m_item);
+  m_outboundEvents->Submit([=]() {
+    cb->RequestVideoSettings(nextItem);
+  });
+  m_outboundEvents->Submit([=]() {
+    cb->OnPlayBackStarted(nextItem);
+  });
+
+  OpenExternalSubtitles();
+  m_clock.Reset();
+  m_dvd.Clear();
+
+  m_pDemuxer = demuxer;
+  InitDemuxStreams();
+  OpenDefaultStreams();
+
+  UpdatePlayState(0);
+
+  SetCaching(CACHESTATE_FLUSH);
+  return true;
+}
+
 //------------------------------------------------------------------------------
 // content related methods
 //------------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 #include "Edl.h"
 #include "FileItem.h"
 #include "IVideoPlayer.h"
+#include "VideoPlayerPreload.h"
 #include "VideoPlayerRadioRDS.h"
 #include "VideoPlayerSubtitle.h"
 #include "VideoPlayerTeletext.h"
@@ -241,6 +242,7 @@ public:
   ~CVideoPlayer() override;
   bool OpenFile(const CFileItem& file, const CPlayerOptions &options) override;
   bool CloseFile(bool reopen = false) override;
+  bool QueueNextFile(const CFileItem &file) override;
   bool IsPlaying() const override;
   void Pause() override;
   bool HasVideo() const override;
@@ -422,7 +424,9 @@ protected:
   void CheckStreamChanges(CCurrentStream& current, CDemuxStream* stream);
 
   bool OpenInputStream();
+  void OpenExternalSubtitles();
   bool OpenDemuxStream();
+  void InitDemuxStreams();
   void CloseDemuxer();
   void OpenDefaultStreams(bool reset = true);
 
@@ -436,6 +440,14 @@ protected:
   void UpdateContentState();
 
   void UpdateFileItemStreamDetails(CFileItem& item);
+  void StoreFileState(const CFileItem& fileItem);
+
+  /*!
+   \brief Ask for the next playlist item once the end is near, see
+   advancedsettings <video><preloadnextitem>.
+   */
+  void CheckPreloadNext();
+  bool OpenPreloadedItem();
 
   bool m_players_created;
 
@@ -538,4 +550,7 @@ protected:
   bool m_UpdateStreamDetails;
 
   std::atomic<bool> m_displayLost;
+
+  CVideoPlayerPreload m_preload;
+  bool m_preloadRequested;
 };
@@ -0,0 +1,149 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoPlayerPreload.h"
+
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <utility>
+
+CVideoPlayerPreload::CVideoPlayerPreload(IVideoPlayer* player)
+  : CThread("VideoPlayerPreload"),
+    m_player(player)
+{
+}
+
+CVideoPlayerPreload::~CVideoPlayerPreload()
+{
+  Cancel();
+}
+
+bool CVideoPlayerPreload::CanPreload(const CFileItem& item)
+{
+  if (item.IsDiscImage() || item.IsOpticalMediaFile() || item.IsOnDVD() || item.IsDiscStub())
+    return false;
+
+  if (item.IsPVR() || item.IsLiveTV())
+    return false;
+
+  // CApplication::PlayFile resolves these and sets up the stack helper, which
+  // the switch to a preloaded item skips
+  if (item.IsStack() || item.IsPlugin() || URIUtils::IsPlugin(item.GetDynPath()) ||
+      URIUtils::IsUPnP(item.GetPath()) || URIUtils::IsUPnP(item.GetDynPath()))
+    return false;
+
+  // the preloaded item always starts at the beginning
+  if (item.m_lStartOffset != 0 || item.HasProperty("StartPercent"))
+    return false;
+
+  return true;
+}
+
+void CVideoPlayerPreload::Open(const CFileItem& item)
+{
+  Cancel();
+
+  {
+    CSingleLock lock(m_section);
+    m_item = item;
+    m_item.SetMimeTypeForInternetFile();
+  }
+
+  CLog::Log(LOGDEBUG, "CVideoPlayerPreload::%s - preloading %s", __FUNCTION__,
+            CURL::GetRedacted(item.GetDynPath()).c_str());
+  Create();
+}
+
+bool CVideoPlayerPreload::IsReady()
+{
+  CSingleLock lock(m_section);
+  return m_ready;
+}
+
+bool CVideoPlayerPreload::Take(CFileItem& item, std::shared_ptr<CDVDInputStream>& inputStream, CDVDDemux*& demuxer)
+{
+  {
+    CSingleLock lock(m_section);
+    if (!m_ready)
+      return false;
+  }
+
+  // the thread has nothing left to do, join it
+  StopThread();
+
+  CSingleLock lock(m_section);
+  item = m_item;
+  inputStream = std::move(m_inputStream);
+  demuxer = m_demuxer.release();
+  m_ready = false;
+  return true;
+}
+
+void CVideoPlayerPreload::Cancel()
+{
+  {
+    CSingleLock lock(m_section);
+    if (m_inputStream)
+      m_inputStream->Abort();
+  }
+
+  StopThread();
+
+  CSingleLock lock(m_section);
+  m_demuxer.reset();
+  m_inputStream.reset();
+  m_ready = false;
+}
+
+void CVideoPlayerPreload::Process()
+{
+  CFileItem item;
+  {
+    CSingleLock lock(m_section);
+    item = m_item;
+  }
+
+  std::shared_ptr<CDVDInputStream> inputStream = CDVDFactoryInputStream::CreateInputStream(m_player, item, true);
+  if (!inputStream)
+  {
+    CLog::Log(LOGDEBUG, "CVideoPlayerPreload::%s - unable to create input stream for %s", __FUNCTION__,
+              CURL::GetRedacted(item.GetDynPath()).c_str());
+    return;
+  }
+
+  // Cancel() aborts the stream while it is opening
+  {
+    CSingleLock lock(m_section);
+    m_inputStream = inputStream;
+  }
+
+  CDVDDemux* demuxer = nullptr;
+  if (!m_bStop && inputStream->Open() && !m_bStop)
+    demuxer = CDVDFactoryDemuxer::CreateDemuxer(inputStream);
+
+  CSingleLock lock(m_section);
+  if (!demuxer || m_bStop)
+  {
+    if (!m_bStop)
+      CLog::Log(LOGDEBUG, "CVideoPlayerPreload::%s - failed to open %s", __FUNCTION__,
+                CURL::GetRedacted(item.GetDynPath()).c_str());
+    delete demuxer;
+    m_inputStream.reset();
+    return;
+  }
+
+  m_demuxer.reset(demuxer);
+  m_ready = true;
+}
@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "FileItem.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <memory>
+
+class CDVDDemux;
+class CDVDInputStream;
+class IVideoPlayer;
+
+/*!
+ \brief Opens the input stream and the demuxer of the next playlist item
+ while the current one is still playing.
+
+ The player hands the item over once it has been queued, the expensive part
+ of opening it (connecting, probing the container) runs on a thread of its
+ own. When the current item reaches its end the player takes both and
+ continues without the gap of opening the file. Items which need more than
+ an input stream and a demuxer to start (discs, live tv, stacks, plugins,
+ UPnP) or don't start at the beginning are not preloaded.
+ */
+class CVideoPlayerPreload : private CThread
+{
+public:
+  explicit CVideoPlayerPreload(IVideoPlayer* player);
+  ~CVideoPlayerPreload() override;
+
+  static bool CanPreload(const CFileItem& item);
+
+  /*!
+   \brief Start opening the item, cancels an earlier one.
+   */
+  void Open(const CFileItem& item);
+
+  /*!
+   \brief True once the input stream and the demuxer are open.
+   */
+  bool IsReady();
+
+  /*!
+   \brief Hand over the opened item, the preload is empty afterwards.
+   \return false if nothing is ready
+   */
+  bool Take(CFileItem& item, std::shared_ptr<CDVDInputStream>& inputStream, CDVDDemux*& demuxer);
+
+  /*!
+   \brief Abort opening and close what was opened already.
+   */
+  void Cancel();
+
+protected:
+  void Process() override;
+
+  IVideoPlayer* m_player;
+  CCriticalSection m_section;
+  CFileItem m_item;
+  std::shared_ptr<CDVDInputStream> m_inputStream;
+  std::unique_ptr<CDVDDemux> m_demuxer;
+  bool m_ready = false;
+};
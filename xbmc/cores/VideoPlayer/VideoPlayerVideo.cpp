@@ -11,6 +11,7 @@
 #include "DVDCodecs/DVDCodecUtils.h"
 #include "DVDCodecs/DVDFactoryCodec.h"
 #include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "PlaybackTrace.h"
 #include "ServiceBroker.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
@@ -559,6 +560,11 @@ void CVideoPlayerVideo::Process()
         codecControl |= DVD_CODEC_CTRL_ROTATE;
       m_pVideoCodec->SetCodecControl(codecControl);
 
+      CPlaybackTrace& trace = CPlaybackTrace::GetInstance();
+      trace.Record(CPlaybackTrace::Event::DECODE_START, pPacket);
+      if (bRequestDrop)
+        trace.Record(CPlaybackTrace::Event::DROP_REQUEST, pPacket, CPlaybackTrace::DropReason::LATE);
+
       if (m_pVideoCodec->AddData(*pPacket))
       {
         // buffer packets so we can recover should decoder flush for some reason
@@ -671,6 +677,8 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
     else if (m_picture.pts == DVD_NOPTS_VALUE)
       m_picture.pts = m_picture.dts;
 
+    CPlaybackTrace::GetInstance().Record(CPlaybackTrace::Event::DECODE_END, m_picture.pts);
+
     // use forced aspect if any
     if (m_fForcedAspectRatio != 0.0f)
     {
@@ -886,10 +894,12 @@ CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPict
         m_rewindStalled = true;
         CThread::Sleep(50);
       }
+      CPlaybackTrace::GetInstance().Record(CPlaybackTrace::Event::DROP, pPicture->pts, CPlaybackTrace::DropReason::SPEED);
       return OUTPUT_DROPPED;
     }
     else if (pPicture->pts < iPlayingClock)
     {
+      CPlaybackTrace::GetInstance().Record(CPlaybackTrace::Event::DROP, pPicture->pts, CPlaybackTrace::DropReason::SPEED);
       return OUTPUT_DROPPED;
     }
   }
@@ -897,6 +907,7 @@ CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPict
   if ((pPicture->iFlags & DVP_FLAG_DROPPED))
   {
     m_droppingStats.AddOutputDropGain(pPicture->pts, 1);
+    CPlaybackTrace::GetInstance().Record(CPlaybackTrace::Event::DROP, pPicture->pts, CPlaybackTrace::DropReason::DECODER);
     CLog::Log(LOGDEBUG,"%s - dropped in output", __FUNCTION__);
     return OUTPUT_DROPPED;
   }
@@ -924,8 +935,10 @@ CVideoPlayerVideo::EOutputState CVideoPlayerVideo::OutputPicture(const VideoPict
   if (!m_renderManager.AddVideoPicture(*pPicture, m_bAbortOutput, deintMethod, (m_syncState == ESyncState::SYNC_STARTING)))
   {
     m_droppingStats.AddOutputDropGain(pPicture->pts, 1);
+    CPlaybackTrace::GetInstance().Record(CPlaybackTrace::Event::DROP, pPicture->pts, CPlaybackTrace::DropReason::RENDER_QUEUE);
     return OUTPUT_DROPPED;
   }
+  CPlaybackTrace::GetInstance().Record(CPlaybackTrace::Event::RENDER_QUEUE, pPicture->pts);
 
   return OUTPUT_NORMAL;
 }
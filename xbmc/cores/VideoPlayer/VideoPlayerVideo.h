@@ -20,6 +20,7 @@
 #include "utils/BitstreamStats.h"
 
 #include <atomic>
+#include <list>
 
 #define DROP_DROPPED 1
 #define DROP_VERYLATE 2
@@ -27,6 +28,31 @@
 
 class CDemuxStreamVideo;
 
+struct DVDMessageListItem
+{
+  DVDMessageListItem(CDVDMsg* msg, int prio)
+  {
+    message = msg->Acquire();
+    priority = prio;
+  }
+  DVDMessageListItem()
+  {
+    message = NULL;
+    priority = 0;
+  }
+  DVDMessageListItem(const DVDMessageListItem&) = delete;
+ ~DVDMessageListItem()
+  {
+    if(message)
+      message->Release();
+  }
+
+  DVDMessageListItem& operator=(const DVDMessageListItem&) = delete;
+
+  CDVDMsg* message;
+  int priority;
+};
+
 class CDroppingStats
 {
 public:
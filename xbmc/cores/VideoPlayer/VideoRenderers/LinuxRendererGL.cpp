@@ -96,6 +96,7 @@ CLinuxRendererGL::CPictureBuffer::CPictureBuffer()
   memset(&pbo   , 0, sizeof(pbo));
   videoBuffer = nullptr;
   loaded = false;
+  fence = nullptr;
 }
 
 CLinuxRendererGL::CPictureBuffer::~CPictureBuffer() = default;
@@ -238,6 +239,17 @@ bool CLinuxRendererGL::Configure(const VideoPicture &picture, float fps, unsigne
 
   m_pboSupported = CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_pixel_buffer_object");
 
+  // software decoders write into buffers the textures are uploaded from
+  if (m_videoBufferPool)
+  {
+    m_videoBufferPool->Dispose();
+    m_videoBufferPool.reset();
+  }
+  CVideoBufferPoolPBO::DeleteDisposed();
+  if (m_pboSupported && CVideoBufferPoolPBO::IsSupported(m_format) &&
+      CServiceBroker::GetRenderSystem()->IsExtSupported("GL_ARB_buffer_storage"))
+    m_videoBufferPool = std::make_shared<CVideoBufferPoolPBO>(m_format, m_sourceWidth, m_sourceHeight);
+
   // setup the background colour
   m_clearColour = CServiceBroker::GetWinSystem()->UseLimitedColor() ? (16.0f / 0xff) : 0.0f;
 
@@ -294,6 +306,16 @@ void CLinuxRendererGL::AddVideoPicture(const VideoPicture &picture, int index)
 void CLinuxRendererGL::ReleaseBuffer(int idx)
 {
   CPictureBuffer &buf = m_buffers[idx];
+  if (buf.fence)
+  {
+    // the buffer is also released while the GPU may still read it, e.g. when the
+    // GUI isn't rendered. Don't hand it back to the decoder before the upload is done.
+    if (glClientWaitSync(buf.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000) == GL_TIMEOUT_EXPIRED)
+      CLog::Log(LOGWARNING, "CLinuxRendererGL::%s - timed out waiting for the upload of buffer %d",
+                __FUNCTION__, idx);
+    glDeleteSync(buf.fence);
+    buf.fence = nullptr;
+  }
   if (buf.videoBuffer)
   {
     buf.videoBuffer->Release();
@@ -301,6 +323,24 @@ void CLinuxRendererGL::ReleaseBuffer(int idx)
   }
 }
 
+bool CLinuxRendererGL::NeedBuffer(int idx)
+{
+  CPictureBuffer &buf = m_buffers[idx];
+  if (buf.fence)
+  {
+    GLint state;
+    GLsizei length;
+    glGetSynciv(buf.fence, GL_SYNC_STATUS, 1, &length, &state);
+    if (state != GL_SIGNALED)
+      return true;
+
+    glDeleteSync(buf.fence);
+    buf.fence = nullptr;
+  }
+
+  return false;
+}
+
 void CLinuxRendererGL::GetPlaneTextureSize(CYuvPlane& plane)
 {
   /* texture is assumed to be bound */
@@ -967,6 +1007,13 @@ void CLinuxRendererGL::UnInit()
 
   DeleteCLUT();
 
+  if (m_videoBufferPool)
+  {
+    m_videoBufferPool->Dispose();
+    m_videoBufferPool.reset();
+  }
+  CVideoBufferPoolPBO::DeleteDisposed();
+
   // cleanup framebuffer object if it was in use
   m_fbo.fbo.Cleanup();
   m_bValidated = false;
@@ -1769,6 +1816,9 @@ bool CLinuxRendererGL::UploadTexture(int index)
 
   bool ret = true;
 
+  if (m_videoBufferPool)
+    m_videoBufferPool->Allocate();
+
   if (!m_buffers[index].loaded)
   {
     ret = false;
@@ -1778,9 +1828,15 @@ bool CLinuxRendererGL::UploadTexture(int index)
     m_buffers[index].videoBuffer->GetPlanes(src.plane);
     m_buffers[index].videoBuffer->GetStrides(src.stride);
 
-    UnBindPbo(m_buffers[index]);
+    CVideoBufferPBO* pbo = m_videoBufferPool ? m_videoBufferPool->Find(src.plane[0]) : nullptr;
+    if (!pbo)
+      UnBindPbo(m_buffers[index]);
 
-    if (m_format == AV_PIX_FMT_NV12)
+    if (pbo)
+    {
+      ret = UploadPboTexture(index, *pbo, src);
+    }
+    else if (m_format == AV_PIX_FMT_NV12)
     {
       CVideoBuffer::CopyNV12Picture(&dst, &src);
       BindPbo(m_buffers[index]);
@@ -1797,7 +1853,7 @@ bool CLinuxRendererGL::UploadTexture(int index)
     {
       CVideoBuffer::CopyPicture(&dst, &src);
       BindPbo(m_buffers[index]);
-      ret = UploadYV12Texture(index);
+      ret = UploadYV12Texture(index, dst);
     }
 
     if (ret)
@@ -1810,6 +1866,39 @@ bool CLinuxRendererGL::UploadTexture(int index)
   return ret;
 }
 
+bool CLinuxRendererGL::UploadPboTexture(int index, CVideoBufferPBO& pbo, const YuvImage& src)
+{
+  // the frame was decoded into one of our buffer objects, the planes are
+  // uploaded from there and the frame is kept until the GPU has read it
+  CPictureBuffer& buf = m_buffers[index];
+  YuvImage im = buf.image;
+  for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+  {
+    im.plane[p] = reinterpret_cast<uint8_t*>(src.plane[p] - pbo.GetMemPtr());
+    im.stride[p] = src.stride[p];
+  }
+
+  for (int f = 0; f < MAX_FIELDS; f++)
+  {
+    for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+      buf.fields[f][p].pbo = pbo.GetPbo();
+  }
+
+  bool ret = UploadYV12Texture(index, im);
+
+  for (int f = 0; f < MAX_FIELDS; f++)
+  {
+    for (int p = 0; p < YuvImage::MAX_PLANES; p++)
+      buf.fields[f][p].pbo = buf.pbo[p];
+  }
+
+  if (buf.fence)
+    glDeleteSync(buf.fence);
+  buf.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  return ret;
+}
+
 //********************************************************************************************************
 // YV12 Texture creation, deletion, copying + clearing
 //********************************************************************************************************
@@ -1964,10 +2053,10 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
   return true;
 }
 
-bool CLinuxRendererGL::UploadYV12Texture(int source)
+bool CLinuxRendererGL::UploadYV12Texture(int source, const YuvImage& image)
 {
   CPictureBuffer& buf = m_buffers[source];
-  YuvImage* im = &buf.image;
+  const YuvImage* im = &image;
 
   bool deinterlacing;
   if (m_currentField == FIELD_FULL)
@@ -2652,6 +2741,7 @@ CRenderInfo CLinuxRendererGL::GetRenderInfo()
 {
   CRenderInfo info;
   info.max_buffer_size = NUM_BUFFERS;
+  info.videoBufferPool = m_videoBufferPool;
   return info;
 }
 
@@ -20,6 +20,7 @@
 #include "windowing/GraphicContext.h"
 #include "BaseRenderer.h"
 #include "ColorManager.h"
+#include "VideoBufferPBO.h"
 #include "threads/Event.h"
 #include "VideoShaders/ShaderFormats.h"
 #include "utils/Geometry.h"
@@ -81,6 +82,7 @@ public:
   bool Flush(bool saveBuffers) override;
   void SetBufferSize(int numBuffers) override { m_NumYV12Buffers = numBuffers; }
   void ReleaseBuffer(int idx) override;
+  bool NeedBuffer(int idx) override;
   void RenderUpdate(int index, int index2, bool clear, unsigned int flags, unsigned int alpha) override;
   void Update() override;
   bool RenderCapture(CRenderCapture* capture) override;
@@ -110,7 +112,8 @@ protected:
   virtual void DeleteTexture(int index);
   virtual bool CreateTexture(int index);
 
-  bool UploadYV12Texture(int index);
+  bool UploadYV12Texture(int index, const YuvImage& image);
+  bool UploadPboTexture(int index, CVideoBufferPBO& pbo, const YuvImage& src);
   void DeleteYV12Texture(int index);
   bool CreateYV12Texture(int index);
 
@@ -193,6 +196,7 @@ protected:
 
     CVideoBuffer *videoBuffer;
     bool loaded;
+    GLsync fence; // uploaded from a buffer of the decoder, pending until signalled
 
     AVColorPrimaries m_srcPrimaries;
     AVColorSpace m_srcColSpace;
@@ -222,6 +226,7 @@ protected:
   float m_clearColour = 0.0f;
   bool m_pboSupported = true;
   bool m_pboUsed = false;
+  std::shared_ptr<CVideoBufferPoolPBO> m_videoBufferPool;
   bool m_nonLinStretch = false;
   bool m_nonLinStretchGui = false;
   float m_pixelRatio = 0.0f;
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
 #include <vector>
 #include "cores/IPlayer.h"
 
@@ -16,6 +17,8 @@ extern "C" {
 #include <libavutil/pixfmt.h>
 }
 
+class IVideoBufferPool;
+
 struct CRenderInfo
 {
   CRenderInfo()
@@ -27,6 +30,7 @@ struct CRenderInfo
     optimal_buffer_size = 0;
     max_buffer_size = 0;
     opaque_pointer = nullptr;
+    videoBufferPool.reset();
     m_deintMethods.clear();
     formats.clear();
   }
@@ -37,4 +41,6 @@ struct CRenderInfo
   std::vector<EINTERLACEMETHOD> m_deintMethods;
   // Can be used for initialising video codec with information from renderer (e.g. a shared image pool)
   void *opaque_pointer;
+  // Buffers owned by the renderer which software decoders can decode into
+  std::shared_ptr<IVideoBufferPool> videoBufferPool;
 };
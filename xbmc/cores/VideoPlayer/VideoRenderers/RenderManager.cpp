@@ -14,6 +14,7 @@
 #include "RenderFlags.h"
 #include "ServiceBroker.h"
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "cores/VideoPlayer/PlaybackTrace.h"
 #include "messaging/ApplicationMessenger.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/MediaSettings.h"
@@ -1145,6 +1146,7 @@ void CRenderManager::PrepareNextRender()
     }
 
     // skip late frames
+    CPlaybackTrace& trace = CPlaybackTrace::GetInstance();
     while (m_queued.front() != idx)
     {
       if (m_presentsourcePast >= 0)
@@ -1152,6 +1154,7 @@ void CRenderManager::PrepareNextRender()
         m_discard.push_back(m_presentsourcePast);
         m_QueueSkip++;
       }
+      trace.Record(CPlaybackTrace::Event::DROP, m_Queue[m_queued.front()].pts, CPlaybackTrace::DropReason::RENDER_LATE);
       m_presentsourcePast = m_queued.front();
       m_queued.pop_front();
     }
@@ -1167,6 +1170,7 @@ void CRenderManager::PrepareNextRender()
     m_presentsource = idx;
     m_queued.pop_front();
     m_presentpts = m_Queue[idx].pts - m_displayLatency;
+    trace.Record(CPlaybackTrace::Event::PRESENT, m_Queue[idx].pts);
     m_presentevent.notifyAll();
 
     m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
@@ -1179,6 +1183,7 @@ void CRenderManager::PrepareNextRender()
     m_presentsource = m_queued.front();
     m_queued.pop_front();
     m_presentpts = m_Queue[m_presentsource].pts - m_displayLatency - frametime / 2;
+    CPlaybackTrace::GetInstance().Record(CPlaybackTrace::Event::PRESENT, m_Queue[m_presentsource].pts);
     m_presentevent.notifyAll();
   }
 }
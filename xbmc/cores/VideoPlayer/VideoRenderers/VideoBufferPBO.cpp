@@ -0,0 +1,289 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoBufferPBO.h"
+
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+// CVideoBufferPBO
+//-----------------------------------------------------------------------------
+
+CVideoBufferPBO::CVideoBufferPBO(int id, AVPixelFormat format, int size)
+  : CVideoBuffer(id)
+{
+  m_pixFormat = format;
+  m_size = size;
+  memset(&m_image, 0, sizeof(m_image));
+}
+
+CVideoBufferPBO::~CVideoBufferPBO()
+{
+  if (m_pbo)
+    CLog::Log(LOGERROR, "CVideoBufferPBO::%s - buffer object %u not deleted", __FUNCTION__, m_pbo);
+}
+
+uint8_t* CVideoBufferPBO::GetMemPtr()
+{
+  return m_data;
+}
+
+void CVideoBufferPBO::GetPlanes(uint8_t*(&planes)[YuvImage::MAX_PLANES])
+{
+  planes[0] = m_image.plane[0];
+  planes[1] = m_image.plane[1];
+  planes[2] = m_image.plane[2];
+}
+
+void CVideoBufferPBO::GetStrides(int(&strides)[YuvImage::MAX_PLANES])
+{
+  strides[0] = m_image.stride[0];
+  strides[1] = m_image.stride[1];
+  strides[2] = m_image.stride[2];
+}
+
+void CVideoBufferPBO::SetDimensions(int width, int height, const int (&strides)[YuvImage::MAX_PLANES])
+{
+  m_width = width;
+  m_height = height;
+
+  m_image.width = m_width;
+  m_image.height = m_height;
+  m_image.stride[0] = strides[0];
+  m_image.stride[1] = strides[1];
+  m_image.stride[2] = strides[2];
+  m_image.cshift_x = 1;
+  m_image.cshift_y = 1;
+  m_image.bpp = m_pixFormat == AV_PIX_FMT_YUV420P ? 1 : 2;
+
+  m_image.planesize[0] = m_image.stride[0] * m_image.height;
+  m_image.planesize[1] = m_image.stride[1] * (m_image.height >> m_image.cshift_y);
+  m_image.planesize[2] = m_image.stride[2] * (m_image.height >> m_image.cshift_y);
+
+  m_image.plane[0] = m_data;
+  m_image.plane[1] = m_data + m_image.planesize[0];
+  m_image.plane[2] = m_image.plane[1] + m_image.planesize[1];
+}
+
+void CVideoBufferPBO::SetDimensions(int width, int height, const int (&strides)[YuvImage::MAX_PLANES], const int (&planeOffsets)[YuvImage::MAX_PLANES])
+{
+  SetDimensions(width, height, strides);
+
+  m_image.plane[0] = m_data + planeOffsets[0];
+  m_image.plane[1] = m_data + planeOffsets[1];
+  m_image.plane[2] = m_data + planeOffsets[2];
+}
+
+bool CVideoBufferPBO::Alloc()
+{
+#if defined(GL_ARB_buffer_storage)
+  // the decoder reads its reference frames back from the mapping, ask for
+  // cached client memory rather than write combined video memory
+  const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+  glGenBuffers(1, &m_pbo);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+  glBufferStorage(GL_PIXEL_UNPACK_BUFFER, m_size, nullptr, flags | GL_CLIENT_STORAGE_BIT);
+  m_data = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_size, flags));
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  if (!m_data)
+  {
+    CLog::Log(LOGWARNING, "CVideoBufferPBO::%s - failed to map buffer object of %d bytes",
+              __FUNCTION__, m_size);
+    glDeleteBuffers(1, &m_pbo);
+    m_pbo = 0;
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CVideoBufferPBO::Free()
+{
+  if (!m_pbo)
+    return;
+
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+  glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  glDeleteBuffers(1, &m_pbo);
+  m_pbo = 0;
+  m_data = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// CVideoBufferPoolPBO
+//-----------------------------------------------------------------------------
+
+CCriticalSection CVideoBufferPoolPBO::m_disposedSection;
+std::vector<std::shared_ptr<CVideoBufferPoolPBO>> CVideoBufferPoolPBO::m_disposedPools;
+
+CVideoBufferPoolPBO::CVideoBufferPoolPBO(AVPixelFormat format, int width, int height)
+  : m_pixFormat(format)
+{
+  // room for the alignment of the decoders: lines padded to 128 bytes, a few
+  // extra rows of blocks and the padding behind the last plane
+  const int bpp = format == AV_PIX_FMT_YUV420P ? 1 : 2;
+  const int stride = ((width * bpp + 127) & ~127) + 128;
+  const int lines = ((height + 63) & ~63) + 64;
+  m_size = stride * lines * 3 / 2 + 4 * 64;
+}
+
+CVideoBufferPoolPBO::~CVideoBufferPoolPBO()
+{
+  CSingleLock lock(m_critSection);
+
+  for (auto buf : m_all)
+  {
+    delete buf;
+  }
+}
+
+CVideoBuffer* CVideoBufferPoolPBO::Get()
+{
+  CSingleLock lock(m_critSection);
+
+  if (m_disposed)
+    return nullptr;
+
+  if (m_free.empty())
+  {
+    m_missed++;
+    return nullptr;
+  }
+
+  int idx = m_free.front();
+  m_free.pop_front();
+  m_used.push_back(idx);
+
+  CVideoBufferPBO* buf = m_all[idx];
+  buf->Acquire(GetPtr());
+  return buf;
+}
+
+void CVideoBufferPoolPBO::Return(int id)
+{
+  CSingleLock lock(m_critSection);
+
+  auto it = std::find(m_used.begin(), m_used.end(), id);
+  if (it != m_used.end())
+    m_used.erase(it);
+  m_free.push_back(id);
+}
+
+bool CVideoBufferPoolPBO::IsCompatible(AVPixelFormat format, int size)
+{
+  CSingleLock lock(m_critSection);
+
+  return !m_disposed && m_pixFormat == format && size <= m_size;
+}
+
+CVideoBufferPBO* CVideoBufferPoolPBO::Find(const uint8_t* ptr)
+{
+  CSingleLock lock(m_critSection);
+
+  for (int idx : m_used)
+  {
+    if (m_all[idx]->Contains(ptr))
+      return m_all[idx];
+  }
+  return nullptr;
+}
+
+void CVideoBufferPoolPBO::Allocate()
+{
+  CSingleLock lock(m_critSection);
+
+  if (m_disposed)
+    return;
+
+  while (m_missed > 0 && m_all.size() < MAX_BUFFERS)
+  {
+    int id = m_all.size();
+    CVideoBufferPBO* buf = new CVideoBufferPBO(id, m_pixFormat, m_size);
+    if (!buf->Alloc())
+    {
+      delete buf;
+      // the decoder keeps to its own buffers
+      m_missed = 0;
+      m_disposed = true;
+      return;
+    }
+    m_all.push_back(buf);
+    m_free.push_back(id);
+    m_missed--;
+  }
+  m_missed = 0;
+}
+
+void CVideoBufferPoolPBO::Dispose()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_disposed = true;
+    if (FreeReturned())
+      return;
+  }
+
+  CSingleLock lock(m_disposedSection);
+  m_disposedPools.push_back(std::static_pointer_cast<CVideoBufferPoolPBO>(GetPtr()));
+}
+
+void CVideoBufferPoolPBO::DeleteDisposed()
+{
+  CSingleLock lock(m_disposedSection);
+
+  auto it = m_disposedPools.begin();
+  while (it != m_disposedPools.end())
+  {
+    bool returned;
+    {
+      CSingleLock poolLock((*it)->m_critSection);
+      returned = (*it)->FreeReturned();
+    }
+    if (returned)
+      it = m_disposedPools.erase(it);
+    else
+      ++it;
+  }
+}
+
+bool CVideoBufferPoolPBO::IsSupported(AVPixelFormat format)
+{
+#if defined(GL_ARB_buffer_storage)
+  switch (format)
+  {
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUV420P9:
+    case AV_PIX_FMT_YUV420P10:
+    case AV_PIX_FMT_YUV420P12:
+    case AV_PIX_FMT_YUV420P14:
+    case AV_PIX_FMT_YUV420P16:
+      return true;
+    default:
+      return false;
+  }
+#else
+  return false;
+#endif
+}
+
+bool CVideoBufferPoolPBO::FreeReturned()
+{
+  for (int idx : m_free)
+    m_all[idx]->Free();
+
+  return m_used.empty();
+}
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/VideoPlayer/Buffers/VideoBuffer.h"
+#include "threads/CriticalSection.h"
+
+#include "system_gl.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+/*!
+ \brief Video buffer in a persistently mapped pixel buffer object.
+
+ Software decoders write the planes straight into the mapping, the renderer
+ uploads the textures from the buffer object without copying the frame.
+ */
+class CVideoBufferPBO : public CVideoBuffer
+{
+public:
+  CVideoBufferPBO(int id, AVPixelFormat format, int size);
+  ~CVideoBufferPBO() override;
+  uint8_t* GetMemPtr() override;
+  void GetPlanes(uint8_t*(&planes)[YuvImage::MAX_PLANES]) override;
+  void GetStrides(int(&strides)[YuvImage::MAX_PLANES]) override;
+  void SetDimensions(int width, int height, const int (&strides)[YuvImage::MAX_PLANES]) override;
+  void SetDimensions(int width, int height, const int (&strides)[YuvImage::MAX_PLANES], const int (&planeOffsets)[YuvImage::MAX_PLANES]) override;
+
+  GLuint GetPbo() const { return m_pbo; }
+  bool Contains(const uint8_t* ptr) const { return m_data && ptr >= m_data && ptr < m_data + m_size; }
+
+  // GL thread only
+  bool Alloc();
+  void Free();
+
+protected:
+  GLuint m_pbo = 0;
+  int m_width = 0;
+  int m_height = 0;
+  int m_size = 0;
+  uint8_t* m_data = nullptr;
+  YuvImage m_image;
+};
+
+/*!
+ \brief Pool of pixel buffer objects owned by the GL renderer.
+
+ The renderer hands the pool to the player with its render info, the ffmpeg
+ decoder takes buffers from it directly. It isn't registered with the video
+ buffer manager, other users of the manager would get nothing when it's
+ empty. Buffer objects can only be created and deleted on the GL thread, so
+ Get() never blocks or allocates: it returns nullptr if no buffer is free and
+ the decoder falls back to its own buffers. The renderer adds buffers for the
+ misses on its next upload, up to a limit.
+ */
+class CVideoBufferPoolPBO : public IVideoBufferPool
+{
+public:
+  CVideoBufferPoolPBO(AVPixelFormat format, int width, int height);
+  ~CVideoBufferPoolPBO() override;
+  CVideoBuffer* Get() override;
+  void Return(int id) override;
+  bool IsCompatible(AVPixelFormat format, int size) override;
+
+  /*!
+   \brief Find the buffer a decoded plane lies in, holds while the caller
+   holds a reference to the frame.
+   */
+  CVideoBufferPBO* Find(const uint8_t* ptr);
+
+  /*!
+   \brief Create buffers for the requests which found the pool empty.
+   GL thread only.
+   */
+  void Allocate();
+
+  /*!
+   \brief Stop handing out buffers and delete the free ones. Buffers still
+   held by the decoder stay mapped until they come back. GL thread only.
+   */
+  void Dispose();
+
+  /*!
+   \brief Delete the buffers of disposed pools which have come back since.
+   GL thread only.
+   */
+  static void DeleteDisposed();
+
+  static bool IsSupported(AVPixelFormat format);
+
+protected:
+  static const size_t MAX_BUFFERS = 32;
+
+  bool FreeReturned();
+
+  AVPixelFormat m_pixFormat;
+  int m_size;
+  bool m_disposed = false;
+  int m_missed = 0;
+  CCriticalSection m_critSection;
+
+  std::vector<CVideoBufferPBO*> m_all;
+  std::deque<int> m_used;
+  std::deque<int> m_free;
+
+  static CCriticalSection m_disposedSection;
+  static std::vector<std::shared_ptr<CVideoBufferPoolPBO>> m_disposedPools;
+};
@@ -0,0 +1,52 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/Buffers/VideoBuffer.h"
+#include "cores/VideoPlayer/VideoRenderers/VideoBufferPBO.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+constexpr int WIDTH = 1920;
+constexpr int HEIGHT = 1080;
+constexpr int SIZE = WIDTH * HEIGHT * 3 / 2;
+} // namespace
+
+// buffer objects are only created on the GL thread, without one the pool stays empty
+TEST(TestVideoBufferPBO, ExhaustedPool)
+{
+  auto pool = std::make_shared<CVideoBufferPoolPBO>(AV_PIX_FMT_YUV420P, WIDTH, HEIGHT);
+  EXPECT_TRUE(pool->IsCompatible(AV_PIX_FMT_YUV420P, SIZE));
+  EXPECT_FALSE(pool->IsCompatible(AV_PIX_FMT_NV12, SIZE));
+  EXPECT_EQ(nullptr, pool->Get());
+}
+
+// a compatible pool that's exhausted mustn't starve other users of the manager
+TEST(TestVideoBufferPBO, ManagerSkipsExhaustedPool)
+{
+  CVideoBufferManager manager;
+  auto pool = std::make_shared<CVideoBufferPoolPBO>(AV_PIX_FMT_YUV420P, WIDTH, HEIGHT);
+  manager.RegisterPool(pool);
+
+  IVideoBufferPool* created = nullptr;
+  CVideoBuffer* buffer = manager.Get(AV_PIX_FMT_YUV420P, SIZE, &created);
+  ASSERT_NE(nullptr, buffer);
+  EXPECT_EQ(nullptr, dynamic_cast<CVideoBufferPBO*>(buffer));
+  EXPECT_NE(nullptr, created);
+  EXPECT_NE(nullptr, buffer->GetMemPtr());
+  buffer->Release();
+
+  // frames larger than the mapped size go to the other pools as well
+  buffer = manager.Get(AV_PIX_FMT_YUV420P, 4 * SIZE, nullptr);
+  ASSERT_NE(nullptr, buffer);
+  EXPECT_EQ(nullptr, dynamic_cast<CVideoBufferPBO*>(buffer));
+  buffer->Release();
+}
@@ -0,0 +1,203 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "cores/VideoPlayer/DVDCodecs/Audio/DVDAudioCodecFFmpeg.h"
+#include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemux.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDFactoryDemuxer.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStream.h"
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include "cores/VideoPlayer/Process/ProcessInfo.h"
+#include "test/Benchmark.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <map>
+#include <memory>
+
+namespace
+{
+struct SVideoDecoder
+{
+  std::unique_ptr<CDVDVideoCodecFFmpeg> codec;
+  VideoPicture picture = {};
+  uint64_t frames = 0;
+};
+
+struct SAudioDecoder
+{
+  std::unique_ptr<CDVDAudioCodecFFmpeg> codec;
+  uint64_t frames = 0;
+};
+
+void ReadPictures(SVideoDecoder& decoder)
+{
+  while (true)
+  {
+    const CDVDVideoCodec::VCReturn ret = decoder.codec->GetPicture(&decoder.picture);
+    if (ret == CDVDVideoCodec::VC_PICTURE)
+      decoder.frames++;
+    else if (ret != CDVDVideoCodec::VC_NONE)
+      break;
+  }
+}
+
+void ReadAudio(SAudioDecoder& decoder)
+{
+  DVDAudioFrame frame;
+  while (true)
+  {
+    decoder.codec->GetData(frame);
+    if (frame.nb_frames == 0)
+      break;
+    decoder.frames += frame.nb_frames;
+  }
+}
+
+/*!
+ \brief Demux a file and decode all of its audio and video streams with the
+ software decoders, as fast as they go.
+ */
+int DemuxDecode(const std::vector<std::string>& args)
+{
+  if (args.empty())
+  {
+    fprintf(stderr, "demuxdecode: missing file\n");
+    return 1;
+  }
+
+  CFileItem item(args[0], false);
+  std::shared_ptr<CDVDInputStream> input = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+  if (!input || !input->Open())
+  {
+    fprintf(stderr, "demuxdecode: can't open %s\n", args[0].c_str());
+    return 1;
+  }
+
+  std::unique_ptr<CDVDDemux> demuxer(CDVDFactoryDemuxer::CreateDemuxer(input));
+  if (!demuxer)
+  {
+    fprintf(stderr, "demuxdecode: no demuxer for %s\n", args[0].c_str());
+    return 1;
+  }
+
+  std::unique_ptr<CProcessInfo> processInfo(CProcessInfo::CreateInstance());
+  std::vector<AVPixelFormat> pixFmts;
+  pixFmts.push_back(AV_PIX_FMT_YUV420P);
+  processInfo->SetPixFormats(pixFmts);
+
+  std::map<int, SVideoDecoder> videoDecoders;
+  std::map<int, SAudioDecoder> audioDecoders;
+  for (CDemuxStream* stream : demuxer->GetStreams())
+  {
+    CDVDStreamInfo hints(*stream, true);
+    hints.codecOptions = CODEC_FORCE_SOFTWARE;
+    CDVDCodecOptions options;
+
+    if (stream->type == STREAM_VIDEO)
+    {
+      SVideoDecoder& decoder = videoDecoders[stream->uniqueId];
+      // C++14 - Replace with std::make_unique
+      decoder.codec.reset(new CDVDVideoCodecFFmpeg(*processInfo));
+      if (!decoder.codec->Open(hints, options))
+        videoDecoders.erase(stream->uniqueId);
+    }
+    else if (stream->type == STREAM_AUDIO)
+    {
+      SAudioDecoder& decoder = audioDecoders[stream->uniqueId];
+      // C++14 - Replace with std::make_unique
+      decoder.codec.reset(new CDVDAudioCodecFFmpeg(*processInfo));
+      if (!decoder.codec->Open(hints, options))
+        audioDecoders.erase(stream->uniqueId);
+    }
+    else
+      demuxer->EnableStream(stream->demuxerId, stream->uniqueId, false);
+  }
+
+  CBenchmark::CStage demux("demux");
+  CBenchmark::CStage videoDecode("video decode");
+  CBenchmark::CStage audioDecode("audio decode");
+  uint64_t packets = 0;
+  uint64_t bytes = 0;
+
+  const uint64_t allocationsStart = CBenchmark::GetAllocations();
+  const auto start = std::chrono::steady_clock::now();
+
+  while (true)
+  {
+    demux.Begin();
+    DemuxPacket* packet = demuxer->Read();
+    demux.End();
+    if (!packet)
+      break;
+
+    packets++;
+    bytes += packet->iSize;
+
+    auto video = videoDecoders.find(packet->iStreamId);
+    auto audio = audioDecoders.find(packet->iStreamId);
+    if (video != videoDecoders.end())
+    {
+      videoDecode.Begin();
+      // a full decoder takes the packet once its pictures are out
+      while (!video->second.codec->AddData(*packet))
+        ReadPictures(video->second);
+      ReadPictures(video->second);
+      videoDecode.End();
+    }
+    else if (audio != audioDecoders.end())
+    {
+      audioDecode.Begin();
+      // same for audio, the decoder refuses input until its frames are read
+      while (!audio->second.codec->AddData(*packet))
+        ReadAudio(audio->second);
+      ReadAudio(audio->second);
+      audioDecode.End();
+    }
+
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+
+  // pictures still held back by the decoders
+  for (auto& video : videoDecoders)
+  {
+    videoDecode.Begin();
+    video.second.codec->SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+    ReadPictures(video.second);
+    videoDecode.End();
+    video.second.picture.Reset();
+  }
+
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("file: %s\n", args[0].c_str());
+  printf("time: %.3f s, packets: %" PRIu64 " (%.1f/s), %.1f MiB/s, operator new allocations: %" PRIu64 "\n",
+         seconds, packets, seconds > 0 ? packets / seconds : 0.0,
+         seconds > 0 ? bytes / seconds / (1024 * 1024) : 0.0,
+         CBenchmark::GetAllocations() - allocationsStart);
+  for (const auto& video : videoDecoders)
+    printf("video stream %d: %" PRIu64 " frames, %.1f fps\n", video.first, video.second.frames,
+           seconds > 0 ? video.second.frames / seconds : 0.0);
+  for (const auto& audio : audioDecoders)
+    printf("audio stream %d: %" PRIu64 " samples, %.1f x realtime\n", audio.first, audio.second.frames,
+           seconds > 0 && audio.second.codec->GetFormat().m_sampleRate
+               ? audio.second.frames / seconds / audio.second.codec->GetFormat().m_sampleRate
+               : 0.0);
+  printf("\n");
+  CBenchmark::PrintStages({&demux, &videoDecode, &audioDecode});
+
+  return 0;
+}
+} // namespace
+
+BENCHMARK_REGISTER("demuxdecode", "<file>", DemuxDecode);
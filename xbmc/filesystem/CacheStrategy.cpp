@@ -27,6 +27,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <iterator>
 
 using namespace XFILE;
 
@@ -46,6 +47,11 @@ void CCacheStrategy::ClearEndOfInput()
   m_bEndOfInput = false;
 }
 
+void CCacheStrategy::GetHitStats(uint64_t& hits, uint64_t& misses, uint64_t& hitBytes)
+{
+  hits = misses = hitBytes = 0;
+}
+
 CSimpleFileCache::CSimpleFileCache()
   : m_cacheFileRead(new CacheLocalFile())
   , m_cacheFileWrite(new CacheLocalFile())
@@ -393,3 +399,136 @@ CCacheStrategy *CDoubleCache::CreateNew()
   return new CDoubleCache(m_pCache->CreateNew());
 }
 
+
+
+CSegmentedCache::CSegmentedCache(CCacheStrategy *impl, size_t maxSegments)
+  : m_maxSegments(std::max(maxSegments, static_cast<size_t>(1)))
+{
+  assert(NULL != impl);
+  m_segments.emplace_back(impl);
+}
+
+CSegmentedCache::~CSegmentedCache() = default;
+
+int CSegmentedCache::Open()
+{
+  return m_segments.front()->Open();
+}
+
+void CSegmentedCache::Close()
+{
+  m_segments.front()->Close();
+  m_segments.resize(1);
+}
+
+size_t CSegmentedCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  return m_segments.front()->GetMaxWriteSize(iRequestSize); // NOTE: Check the active segment only
+}
+
+int CSegmentedCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  return m_segments.front()->WriteToCache(pBuffer, iSize);
+}
+
+int CSegmentedCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  return m_segments.front()->ReadFromCache(pBuffer, iMaxSize);
+}
+
+int64_t CSegmentedCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  return m_segments.front()->WaitForData(iMinAvail, iMillis);
+}
+
+CSegmentedCache::SegmentList::iterator CSegmentedCache::FindSegment(int64_t iFilePosition)
+{
+  SegmentList::iterator best = m_segments.end();
+  for (auto it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    if ((*it)->IsCachedPosition(iFilePosition) &&
+        (best == m_segments.end() || (*it)->CachedDataEndPos() > (*best)->CachedDataEndPos()))
+      best = it;
+  }
+  return best;
+}
+
+int64_t CSegmentedCache::Seek(int64_t iFilePosition)
+{
+  /* Same as CDoubleCache: if the position is only held by an inactive segment,
+   * request a seek event so Reset() can switch segments
+   */
+  if (!m_segments.front()->IsCachedPosition(iFilePosition) &&
+      FindSegment(iFilePosition) != m_segments.end())
+  {
+    return CACHE_RC_ERROR;
+  }
+
+  return m_segments.front()->Seek(iFilePosition); // Normal seek
+}
+
+bool CSegmentedCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  if (!clearAnyway)
+  {
+    auto it = FindSegment(iSourcePosition);
+    if (it != m_segments.end())
+    {
+      m_segments.splice(m_segments.begin(), m_segments, it);
+      return m_segments.front()->Reset(iSourcePosition, clearAnyway);
+    }
+  }
+
+  if (m_segments.size() < m_maxSegments)
+  {
+    std::unique_ptr<CCacheStrategy> pCacheNew(m_segments.front()->CreateNew());
+    if (pCacheNew->Open() == CACHE_RC_OK)
+    {
+      bool bRes = pCacheNew->Reset(iSourcePosition, clearAnyway);
+      m_segments.push_front(std::move(pCacheNew));
+      return bRes;
+    }
+  }
+
+  // recycle the least recently used segment
+  m_segments.splice(m_segments.begin(), m_segments, std::prev(m_segments.end()));
+  return m_segments.front()->Reset(iSourcePosition, true);
+}
+
+void CSegmentedCache::EndOfInput()
+{
+  m_segments.front()->EndOfInput();
+}
+
+bool CSegmentedCache::IsEndOfInput()
+{
+  return m_segments.front()->IsEndOfInput();
+}
+
+void CSegmentedCache::ClearEndOfInput()
+{
+  m_segments.front()->ClearEndOfInput();
+}
+
+int64_t CSegmentedCache::CachedDataEndPos()
+{
+  return m_segments.front()->CachedDataEndPos();
+}
+
+int64_t CSegmentedCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  int64_t ret = iFilePosition;
+  for (const auto& segment : m_segments)
+    ret = std::max(ret, segment->CachedDataEndPosIfSeekTo(iFilePosition));
+  return ret;
+}
+
+bool CSegmentedCache::IsCachedPosition(int64_t iFilePosition)
+{
+  return FindSegment(iFilePosition) != m_segments.end();
+}
+
+CCacheStrategy *CSegmentedCache::CreateNew()
+{
+  return new CSegmentedCache(m_segments.front()->CreateNew(), m_maxSegments);
+}
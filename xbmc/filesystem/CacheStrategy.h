@@ -10,6 +10,8 @@
 
 #include "threads/Event.h"
 
+#include <list>
+#include <memory>
 #include <stdint.h>
 #include <string>
 
@@ -53,6 +55,15 @@ public:
   virtual int64_t CachedDataEndPos() = 0;
   virtual bool IsCachedPosition(int64_t iFilePosition) = 0;
 
+  /*!
+   \brief Reads served from data cached by an earlier session, only strategies
+   that keep data across sessions have any
+   \param hits reads served completely from earlier cached data
+   \param misses reads that needed data fetched from the source
+   \param hitBytes bytes served from earlier cached data
+   */
+  virtual void GetHitStats(uint64_t& hits, uint64_t& misses, uint64_t& hitBytes);
+
   virtual CCacheStrategy *CreateNew() = 0;
 
   CEvent m_space;
@@ -127,5 +138,50 @@ protected:
   CCacheStrategy *m_pCacheOld;
 };
 
+/*!
+ \brief Keeps up to a fixed number of non-contiguous cached segments.
+
+ Generalisation of CDoubleCache: the most recently used segment is the active
+ one that is read from and filled. A seek into any other cached segment makes
+ that segment active again, a seek outside all segments recycles the least
+ recently used one. This keeps e.g. container index data and recent seek
+ targets cached while playback continues elsewhere in the file.
+ */
+class CSegmentedCache : public CCacheStrategy
+{
+public:
+  CSegmentedCache(CCacheStrategy *impl, size_t maxSegments);
+  ~CSegmentedCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+  void EndOfInput() override;
+  bool IsEndOfInput() override;
+  void ClearEndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+protected:
+  typedef std::list<std::unique_ptr<CCacheStrategy>> SegmentList;
+
+  /*! \brief Find the segment holding the given position with the most data after it */
+  SegmentList::iterator FindSegment(int64_t iFilePosition);
+
+  SegmentList m_segments; /**< most recently used first, front is the active segment */
+  size_t m_maxSegments;
+};
+
 }
 
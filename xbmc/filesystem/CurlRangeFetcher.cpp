@@ -0,0 +1,235 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "CurlRangeFetcher.h"
+
+#include "CurlFile.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <string.h>
+
+using namespace XFILE;
+
+namespace
+{
+// number of attempts for a single chunk before giving up
+constexpr int CHUNK_ATTEMPTS = 2;
+}
+
+CCurlRangeFetcher::CCurlRangeFetcher(const CURL& url,
+                                     int64_t fileSize,
+                                     unsigned int connections,
+                                     unsigned int chunkSize)
+  : m_url(url),
+    m_fileSize(fileSize),
+    m_connections(std::max(connections, 1u)),
+    m_chunkSize(std::max(chunkSize, 1u))
+{
+}
+
+CCurlRangeFetcher::~CCurlRangeFetcher()
+{
+  Close();
+}
+
+bool CCurlRangeFetcher::Open(int64_t pos /* = 0 */)
+{
+  Close();
+
+  if (m_fileSize <= 0)
+    return false;
+
+  {
+    CSingleLock lock(m_critSection);
+    m_stop = false;
+    m_cancelled = false;
+    m_chunks.clear();
+    m_readPos = pos;
+    m_nextChunk = pos / m_chunkSize;
+  }
+
+  CLog::Log(LOGDEBUG, "CCurlRangeFetcher::Open - fetching <%s> with %u connections, chunk size %u",
+            m_url.GetRedacted().c_str(), m_connections, m_chunkSize);
+
+  for (unsigned int i = 0; i < m_connections; i++)
+  {
+    m_workers.emplace_back(new CThread(this, "CurlRangeFetcher"));
+    m_workers.back()->Create(false);
+  }
+
+  return true;
+}
+
+void CCurlRangeFetcher::Close()
+{
+  {
+    CSingleLock lock(m_critSection);
+    m_stop = true;
+    m_cancelled = true;
+    m_chunkChanged.notifyAll();
+  }
+
+  for (auto& worker : m_workers)
+    worker->StopThread(true);
+  m_workers.clear();
+  m_chunks.clear();
+}
+
+int64_t CCurlRangeFetcher::Seek(int64_t pos)
+{
+  if (pos < 0 || pos > m_fileSize)
+    return -1;
+
+  CSingleLock lock(m_critSection);
+  const int64_t index = pos / m_chunkSize;
+  if (m_chunks.find(index) != m_chunks.end())
+  {
+    // target is already fetched or in flight, only drop what we skip
+    m_chunks.erase(m_chunks.begin(), m_chunks.find(index));
+  }
+  else
+  {
+    // chunks still in flight for the old position are dropped once they finish
+    m_generation++;
+    m_chunks.clear();
+    m_nextChunk = index;
+  }
+  m_readPos = pos;
+  m_chunkChanged.notifyAll();
+
+  return pos;
+}
+
+ssize_t CCurlRangeFetcher::Read(void* lpBuf, size_t uiBufSize)
+{
+  CSingleLock lock(m_critSection);
+
+  if (m_readPos >= m_fileSize)
+    return 0;
+
+  const int64_t index = m_readPos / m_chunkSize;
+  auto it = m_chunks.find(index);
+  while (!m_cancelled && (it == m_chunks.end() || it->second.state == Chunk::PENDING))
+  {
+    m_chunkChanged.wait(lock);
+    it = m_chunks.find(index);
+  }
+
+  if (m_cancelled)
+    return -1;
+
+  if (it->second.state == Chunk::FAILED)
+  {
+    CLog::Log(LOGERROR, "CCurlRangeFetcher::Read - failed to fetch chunk at %" PRId64,
+              index * m_chunkSize);
+    return -1;
+  }
+
+  const std::vector<char>& data = it->second.data;
+  const size_t offset = static_cast<size_t>(m_readPos - index * m_chunkSize);
+  const size_t size = std::min(uiBufSize, data.size() - offset);
+  memcpy(lpBuf, data.data() + offset, size);
+  m_readPos += size;
+
+  if (offset + size == data.size())
+  {
+    // chunk fully consumed, make room for the next one
+    m_chunks.erase(it);
+    m_chunkChanged.notifyAll();
+  }
+
+  return size;
+}
+
+void CCurlRangeFetcher::Cancel()
+{
+  CSingleLock lock(m_critSection);
+  m_cancelled = true;
+  m_chunkChanged.notifyAll();
+}
+
+bool CCurlRangeFetcher::CanFetch() const
+{
+  // keep at most two chunks per connection between read position and fetch position
+  return m_nextChunk * m_chunkSize < m_fileSize &&
+         m_nextChunk - m_readPos / m_chunkSize < static_cast<int64_t>(m_connections) * 2;
+}
+
+void CCurlRangeFetcher::Run()
+{
+  CSingleLock lock(m_critSection);
+  while (!m_stop)
+  {
+    if (!CanFetch())
+    {
+      m_chunkChanged.wait(lock);
+      continue;
+    }
+
+    const int64_t index = m_nextChunk++;
+    const unsigned int generation = m_generation;
+    m_chunks[index];
+
+    const int64_t offset = index * m_chunkSize;
+    const size_t length = static_cast<size_t>(std::min<int64_t>(m_chunkSize, m_fileSize - offset));
+
+    std::vector<char> data;
+    bool ok = false;
+    {
+      CSingleExit exit(m_critSection);
+      for (int attempt = 0; !ok && attempt < CHUNK_ATTEMPTS; attempt++)
+        ok = FetchChunk(offset, length, data);
+    }
+
+    if (generation != m_generation)
+      continue;
+
+    auto it = m_chunks.find(index);
+    if (it != m_chunks.end())
+    {
+      it->second.state = ok ? Chunk::DONE : Chunk::FAILED;
+      it->second.data.swap(data);
+    }
+    m_chunkChanged.notifyAll();
+  }
+}
+
+bool CCurlRangeFetcher::FetchChunk(int64_t offset, size_t length, std::vector<char>& data)
+{
+  CCurlFile file;
+  file.SetRequestHeader("Range", StringUtils::Format("bytes=%" PRId64 "-%" PRId64, offset,
+                                                     offset + static_cast<int64_t>(length) - 1));
+  if (!file.Open(m_url))
+    return false;
+
+  // servers ignoring the range would send the file from the start
+  const std::string contentRange = file.GetHttpHeader().GetValue("Content-Range");
+  if (!StringUtils::StartsWith(contentRange, StringUtils::Format("bytes %" PRId64 "-", offset)))
+  {
+    CLog::Log(LOGERROR, "CCurlRangeFetcher::FetchChunk - range request not honoured by server (%s)",
+              contentRange.c_str());
+    return false;
+  }
+
+  data.resize(length);
+  size_t total = 0;
+  while (total < length && !m_stop)
+  {
+    const ssize_t read = file.Read(data.data() + total, length - total);
+    if (read <= 0)
+      break;
+    total += read;
+  }
+  file.Close();
+
+  return total == length;
+}
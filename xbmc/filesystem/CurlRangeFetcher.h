@@ -0,0 +1,95 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "PlatformDefs.h" // for ssize_t
+#include "URL.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+#include "threads/Thread.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace XFILE
+{
+
+/*!
+ \brief Reads a HTTP(S) resource through several concurrent range requests.
+
+ The file is split into fixed size chunks. A number of worker threads fetch
+ consecutive chunks ahead of the read position with bounded "Range:"
+ requests, Read() hands them out in file order. This gets around the per
+ connection throughput limit of high latency links.
+ */
+class CCurlRangeFetcher : private IRunnable
+{
+public:
+  CCurlRangeFetcher(const CURL& url, int64_t fileSize, unsigned int connections, unsigned int chunkSize);
+  ~CCurlRangeFetcher() override;
+
+  bool Open(int64_t pos = 0);
+  void Close();
+
+  /*!
+   \brief Drop all fetched data and continue fetching from the given position
+   \return the new position or -1 on error
+   */
+  int64_t Seek(int64_t pos);
+
+  /*!
+   \brief Blocking read of the next data in file order
+   \return number of bytes read, 0 on end of file, -1 if a chunk could not be fetched or
+           the fetcher was cancelled
+   */
+  ssize_t Read(void* lpBuf, size_t uiBufSize);
+
+  /*!
+   \brief Abort a blocking Read()
+   */
+  void Cancel() override;
+
+private:
+  struct Chunk
+  {
+    enum State
+    {
+      PENDING,
+      DONE,
+      FAILED,
+    } state = PENDING;
+    std::vector<char> data;
+  };
+
+  void Run() override;
+  bool FetchChunk(int64_t offset, size_t length, std::vector<char>& data);
+  bool CanFetch() const;
+
+  CURL m_url;
+  int64_t m_fileSize;
+  unsigned int m_connections;
+  unsigned int m_chunkSize;
+
+  std::vector<std::unique_ptr<CThread>> m_workers;
+  std::map<int64_t, Chunk> m_chunks; /**< chunk index -> chunk, fetched or in flight */
+  int64_t m_readPos = 0;
+  int64_t m_nextChunk = 0;
+  unsigned int m_generation = 0;
+  std::atomic<bool> m_stop{false};
+  bool m_cancelled = false;
+
+  CCriticalSection m_critSection;
+  XbmcThreads::ConditionVariable m_chunkChanged;
+};
+
+}
@@ -10,24 +10,29 @@
 
 #include "Directory.h"
 #include "FileItem.h"
+#include "ServiceBroker.h"
 #include "URL.h"
+#include "music/tags/MusicInfoTag.h"
+#include "pictures/PictureInfoTag.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/log.h"
+#include "video/VideoInfoTag.h"
 
 #include <algorithm>
-#include <climits>
+#include <functional>
 
-// Maximum number of directories to keep in our cache
-#define MAX_CACHED_DIRS 50
+// Memory budget for the cache until the advanced settings are available
+#define DEFAULT_CACHE_MEMORY (32 * 1024 * 1024)
 
 using namespace XFILE;
 
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
-  m_lastAccess = 0;
   m_Items = new CFileItemList;
   m_Items->SetIgnoreURLOptions(true);
   m_Items->SetFastLookup(true);
@@ -38,45 +43,71 @@ CDirectoryCache::CDir::~CDir()
   delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+void CDirectoryCache::CDir::UpdateMemoryUsage()
 {
-  m_lastAccess = accessCounter++;
+  // rough estimate: the items, their most common strings and attached tags
+  m_memoryUsage = sizeof(CFileItemList);
+  for (const auto& item : *m_Items)
+  {
+    m_memoryUsage += sizeof(CFileItem) + item->GetPath().capacity() +
+                     item->GetLabel().capacity() + item->GetLabel2().capacity();
+    if (item->HasVideoInfoTag())
+      m_memoryUsage += sizeof(CVideoInfoTag);
+    if (item->HasMusicInfoTag())
+      m_memoryUsage += sizeof(MUSIC_INFO::CMusicInfoTag);
+    if (item->HasPictureInfoTag())
+      m_memoryUsage += sizeof(CPictureInfoTag);
+  }
 }
 
 CDirectoryCache::CDirectoryCache(void)
+  : m_memoryUsage(0)
+  , m_accessCounter(0)
+  , m_cacheHits(0)
+  , m_cacheMisses(0)
+  , m_evictions(0)
 {
-  m_accessCounter = 0;
-#ifdef _DEBUG
-  m_cacheHits = 0;
-  m_cacheMisses = 0;
-#endif
 }
 
 CDirectoryCache::~CDirectoryCache(void) = default;
 
-bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+CDirectoryCache::CShard& CDirectoryCache::GetShard(const std::string& storedPath)
+{
+  return m_shards[std::hash<std::string>()(storedPath) % NUM_SHARDS];
+}
+
+void CDirectoryCache::Touch(CShard& shard, CDir& dir)
 {
-  CSingleLock lock (m_cs);
+  dir.m_lastAccess = m_accessCounter++;
 
+  // dirs that are always cached aren't in the LRU list
+  if (dir.m_cacheType != DIR_CACHE_ALWAYS)
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, dir.m_lruPos);
+}
+
+bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+{
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  auto i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
-    CDir* dir = i->second;
+    CDir* dir = i->second.get();
     if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
        (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
     {
       items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
+      Touch(shard, *dir);
+      m_cacheHits++;
       return true;
     }
   }
+  m_cacheMisses++;
   return false;
 }
 
@@ -96,20 +127,37 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
 
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ClearDirectory(storedPath);
+  // copy outside of the lock, this is the expensive part
+  std::unique_ptr<CDir> dir(new CDir(cacheType));
+  dir->m_Items->Copy(items);
+  dir->UpdateMemoryUsage();
 
-  CheckIfFull();
+  {
+    CShard& shard = GetShard(storedPath);
+    CSingleLock lock(shard.m_cs);
 
-  CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+    auto i = shard.m_cache.find(storedPath);
+    if (i != shard.m_cache.end())
+      Delete(shard, i);
+
+    if (cacheType != DIR_CACHE_ALWAYS)
+    {
+      shard.m_lru.push_front(storedPath);
+      dir->m_lruPos = shard.m_lru.begin();
+    }
+    dir->m_lastAccess = m_accessCounter++;
+    shard.m_memoryUsage += dir->GetMemoryUsage();
+    m_memoryUsage += dir->GetMemoryUsage();
+    shard.m_cache.emplace(storedPath, std::move(dir));
+  }
+
+  // the shard lock is released, eviction locks the shards one at a time
+  CheckIfFull();
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -123,55 +171,64 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  auto i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (CShard& shard : m_shards)
   {
-    if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock(shard.m_cs);
+
+    auto i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+    {
+      if (URIUtils::PathHasParent(i->first, storedPath))
+        Delete(shard, i++);
+      else
+        i++;
+    }
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  CShard& shard = GetShard(strPath);
+  CSingleLock lock(shard.m_cs);
+
+  auto i = shard.m_cache.find(strPath);
+  if (i != shard.m_cache.end())
   {
-    CDir *dir = i->second;
+    CDir *dir = i->second.get();
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+    shard.m_memoryUsage -= dir->GetMemoryUsage();
+    m_memoryUsage -= dir->GetMemoryUsage();
+    dir->UpdateMemoryUsage();
+    shard.m_memoryUsage += dir->GetMemoryUsage();
+    m_memoryUsage += dir->GetMemoryUsage();
+    Touch(shard, *dir);
   }
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
-  CSingleLock lock (m_cs);
   bInCache = false;
 
   // Get rid of any URL options, else the compare may be wrong
@@ -180,31 +237,33 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  auto i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
     bInCache = true;
-    CDir *dir = i->second;
-    dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
+    CDir *dir = i->second.get();
+    Touch(shard, *dir);
     m_cacheHits++;
-#endif
     return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
   }
-#ifdef _DEBUG
   m_cacheMisses++;
-#endif
   return false;
 }
 
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  CSingleLock lock (m_cs);
-
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+  for (CShard& shard : m_shards)
+  {
+    CSingleLock lock(shard.m_cs);
+    shard.m_cache.clear();
+    shard.m_lru.clear();
+    m_memoryUsage -= shard.m_memoryUsage;
+    shard.m_memoryUsage = 0;
+  }
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -219,60 +278,89 @@ void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 
 void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
-  {
-    if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
-    else
-      i++;
-  }
+  for (const std::string& strDir : dirs)
+    ClearDirectory(strDir);
+}
+
+size_t CDirectoryCache::GetMemoryBudget()
+{
+  const auto settingsComponent = CServiceBroker::GetSettingsComponent();
+  if (settingsComponent && settingsComponent->GetAdvancedSettings())
+    return static_cast<size_t>(settingsComponent->GetAdvancedSettings()->m_directoryCacheMemSize);
+  return DEFAULT_CACHE_MEMORY;
 }
 
 void CDirectoryCache::CheckIfFull()
 {
-  CSingleLock lock (m_cs);
+  const size_t budget = GetMemoryBudget();
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // remove the least recently accessed folders of the whole cache until it is within its
+  // memory budget, but always keep the most recent one so a single huge folder still gets cached
+  unsigned int evicted = 0;
+  while (m_memoryUsage > budget)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    // the oldest folder is at the back of one of the shard's LRU lists. Only one shard is locked
+    // at a time, so it may have been accessed by the time it's removed, which is harmless.
+    CShard* oldestShard = nullptr;
+    unsigned int oldestAccess = 0;
+    size_t evictable = 0;
+    for (CShard& shard : m_shards)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      CSingleLock lock(shard.m_cs);
+      if (shard.m_lru.empty())
+        continue;
+      evictable += shard.m_lru.size();
+      unsigned int lastAccess = shard.m_cache.find(shard.m_lru.back())->second->m_lastAccess;
+      if (!oldestShard || lastAccess < oldestAccess)
+      {
+        oldestShard = &shard;
+        oldestAccess = lastAccess;
+      }
+    }
+    if (evictable <= 1)
+      break;
+
+    CSingleLock lock(oldestShard->m_cs);
+    if (!oldestShard->m_lru.empty())
+    {
+      Delete(*oldestShard, oldestShard->m_cache.find(oldestShard->m_lru.back()));
+      evicted++;
+      m_evictions++;
     }
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    Delete(lastAccessed);
+
+  if (evicted)
+    CLog::Log(LOGDEBUG, "CDirectoryCache::%s - evicted %u folders, %zu KiB in use", __FUNCTION__,
+              evicted, m_memoryUsage.load() / 1024);
 }
 
-void CDirectoryCache::Delete(iCache it)
+void CDirectoryCache::Delete(CShard& shard, std::unordered_map<std::string, std::unique_ptr<CDir>>::iterator it)
 {
-  CDir* dir = it->second;
-  delete dir;
-  m_cache.erase(it);
+  CDir* dir = it->second.get();
+  if (dir->m_cacheType != DIR_CACHE_ALWAYS)
+    shard.m_lru.erase(dir->m_lruPos);
+  shard.m_memoryUsage -= dir->GetMemoryUsage();
+  m_memoryUsage -= dir->GetMemoryUsage();
+  shard.m_cache.erase(it);
 }
 
-#ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
-  CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
+  const unsigned int hits = m_cacheHits;
+  const unsigned int misses = m_cacheMisses;
+  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, %u cache misses (%.1f%% hits) and %u evictions",
+            __FUNCTION__, hits, misses, hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0,
+            m_evictions.load());
+
   unsigned int numItems = 0;
   unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
+  for (const CShard& shard : m_shards)
   {
-    CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
+    CSingleLock lock(shard.m_cs);
+    for (const auto& i : shard.m_cache)
+      numItems += i.second->m_Items->Size();
+    numDirs += shard.m_cache.size();
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total using about %zu of %zu KiB",
+            __FUNCTION__, numDirs, numItems, m_memoryUsage.load() / 1024, GetMemoryBudget() / 1024);
 }
-#endif
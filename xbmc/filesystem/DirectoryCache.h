@@ -11,8 +11,12 @@
 #include "IDirectory.h"
 #include "threads/CriticalSection.h"
 
-#include <map>
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
 #include <set>
+#include <unordered_map>
 
 class CFileItem;
 
@@ -26,16 +30,35 @@ namespace XFILE
       explicit CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; };
+      /*! \brief Estimated memory used by the cached items, in bytes */
+      size_t GetMemoryUsage() const { return m_memoryUsage; }
+      void UpdateMemoryUsage();
 
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      std::list<std::string>::iterator m_lruPos; /**< position in the shard's LRU list, if evictable */
+      unsigned int m_lastAccess = 0;
     private:
       CDir(const CDir&) = delete;
       CDir& operator=(const CDir&) = delete;
-      unsigned int m_lastAccess;
+      size_t m_memoryUsage = 0;
     };
+
+    /*!
+     \brief Independently locked part of the cache.
+
+     Directories are assigned to a shard by the hash of their path. Directories
+     that may be evicted are kept in an LRU list, most recently used first. The
+     memory budget applies to the whole cache, not to each shard.
+     */
+    struct CShard
+    {
+      std::unordered_map<std::string, std::unique_ptr<CDir>> m_cache;
+      std::list<std::string> m_lru;
+      size_t m_memoryUsage = 0;
+      mutable CCriticalSection m_cs;
+    };
+
   public:
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
@@ -47,27 +70,28 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
-#ifdef _DEBUG
+
+    /*! \brief Log the hits, misses and evictions and the memory use against the budget */
     void PrintStats() const;
-#endif
   protected:
+    static constexpr size_t NUM_SHARDS = 16;
+
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
+    static size_t GetMemoryBudget();
 
-    std::map<std::string, CDir*> m_cache;
-    typedef std::map<std::string, CDir*>::iterator iCache;
-    typedef std::map<std::string, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
-
-    mutable CCriticalSection m_cs;
+    CShard& GetShard(const std::string& storedPath);
+    void Touch(CShard& shard, CDir& dir);
+    void Delete(CShard& shard, std::unordered_map<std::string, std::unique_ptr<CDir>>::iterator it);
 
-    unsigned int m_accessCounter;
+    std::array<CShard, NUM_SHARDS> m_shards;
 
-#ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
-#endif
+    std::atomic<size_t> m_memoryUsage;
+    std::atomic<unsigned int> m_accessCounter;
+    std::atomic<unsigned int> m_cacheHits;
+    std::atomic<unsigned int> m_cacheMisses;
+    std::atomic<unsigned int> m_evictions;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
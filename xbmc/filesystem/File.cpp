@@ -16,6 +16,7 @@
 #include "FileCache.h"
 #include "FileFactory.h"
 #include "IFile.h"
+#include "IOStatsFile.h"
 #include "PasswordManager.h"
 #include "Util.h"
 #include "commons/Exception.h"
@@ -292,6 +293,8 @@ bool CFile::Open(const CURL& file, const unsigned int flags)
       {
         // for internet stream, if it contains multiple stream, file cache need handle it specially.
         m_pFile = new CFileCache(m_flags);
+        if (CIOStats::IsEnabled())
+          m_pFile = new CIOStatsFile(m_pFile, "cache");
 
         if (!m_pFile)
           return false;
@@ -357,6 +360,13 @@ bool CFile::Open(const CURL& file, const unsigned int flags)
       return false;
     }
 
+    if (m_flags & READ_MMAP)
+    {
+      // only supported by local files, everything else keeps using Read()
+      if (m_pFile->IoControl(IOCTRL_MMAP, &m_mapping) != 0)
+        m_mapping = SFileMapping();
+    }
+
     if (m_pFile->GetChunkSize() && !(m_flags & READ_CHUNKED))
     {
       m_pBuffer = new CFileStreamBuffer(0);
@@ -664,6 +674,7 @@ void CFile::Close()
 
     SAFE_DELETE(m_pBuffer);
     SAFE_DELETE(m_pFile);
+    m_mapping = SFileMapping();
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch(...)
@@ -672,6 +683,15 @@ void CFile::Close()
   }
 }
 
+const uint8_t* CFile::GetSpan(int64_t offset, size_t size) const
+{
+  if (!m_mapping.data || offset < 0 || offset > m_mapping.size ||
+      size > static_cast<uint64_t>(m_mapping.size - offset))
+    return nullptr;
+
+  return m_mapping.data + offset;
+}
+
 void CFile::Flush()
 {
   try
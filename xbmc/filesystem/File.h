@@ -80,6 +80,17 @@ public:
    *         or undetectable error occur, -1 in case of any explicit error
    */
   ssize_t Read(void* bufPtr, size_t bufSize);
+  /**
+   * Get direct access to the file data without copying it. Only available if the file
+   * was opened with READ_MMAP and the implementation could map it (local files).
+   * Does not change the read position.
+   * @param offset position of the data in the file
+   * @param size   number of bytes wanted
+   * @return pointer to the data, valid until the file is closed, or nullptr if the
+   *         file isn't mapped or the range is not within the mapped length
+   */
+  const uint8_t* GetSpan(int64_t offset, size_t size) const;
+  bool IsMapped() const { return m_mapping.data != nullptr; }
   bool ReadString(char *szLine, int iLineLength);
   /**
    * Attempt to write bufSize bytes from buffer bufPtr into currently opened file.
@@ -168,6 +179,7 @@ private:
   IFile*              m_pFile;
   CFileStreamBuffer*  m_pBuffer;
   BitstreamStats*     m_bitStreamStats;
+  SFileMapping        m_mapping;
 };
 
 // streambuf for file io, only supports buffered input currently
@@ -14,6 +14,9 @@
 #include "ServiceBroker.h"
 
 #include "CircularCache.h"
+#include "CurlRangeFetcher.h"
+#include "PersistentFileCache.h"
+#include "LockFreeCircularCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "settings/AdvancedSettings.h"
@@ -96,6 +99,8 @@ CFileCache::CFileCache(const unsigned int flags)
   , m_fileSize(0)
   , m_flags(flags)
 {
+  if (CIOStats::IsEnabled())
+    m_ioStats = &CIOStats::GetInstance().Get("cache");
 }
 
 CFileCache::~CFileCache()
@@ -143,8 +148,51 @@ bool CFileCache::Open(const CURL& url)
 
   m_fileSize = m_source.GetLength();
 
+  // fetch consecutive chunks over several connections, if configured
+  const unsigned int rangeConnections = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_curlRangeConnections;
+  if (rangeConnections > 1 && m_seekPossible > 0 && m_fileSize > 0 &&
+      (url.IsProtocol("http") || url.IsProtocol("https")))
+  {
+    m_rangeFetcher.reset(new CCurlRangeFetcher(url, m_fileSize, rangeConnections,
+                                               CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_curlRangeChunkSize));
+    if (!m_rangeFetcher->Open())
+      m_rangeFetcher.reset();
+  }
+  m_rangeFetchFailed = false;
+
+  // a persistent cache is tied to the file it was opened for
+  if (m_persistentCache)
+  {
+    m_pCache.reset();
+    m_persistentCache = false;
+  }
+
+  const unsigned int persistentSize = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cachePersistentSize;
+  if (!m_pCache && persistentSize > 0 && m_seekPossible > 0 && m_fileSize > 0)
+  {
+    struct __stat64 st = {};
+    const int64_t mtime = m_source.Stat(&st) == 0 ? st.st_mtime : 0;
+    std::unique_ptr<CPersistentFileCache> cache(new CPersistentFileCache(m_sourcePath, m_fileSize, mtime,
+                                                                         static_cast<uint64_t>(persistentSize) * 1024 * 1024));
+    if (cache->Open() == CACHE_RC_OK)
+    {
+      CLog::Log(LOGDEBUG, "CFileCache::Open - Using persistent disk cache");
+      m_pCache = std::move(cache);
+      m_forwardCacheSize = 0;
+      m_persistentCache = true;
+    }
+  }
+
   if (!m_pCache)
   {
+    unsigned int segments = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheSegments;
+    // NOTE: READ_MULTI_STREAM is only used with READ_AUDIO_VIDEO
+    if (m_flags & READ_MULTI_STREAM)
+    {
+      // READ_MULTI_STREAM requires (at least) double buffering
+      segments = std::max(segments, 2u);
+    }
+
     if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
     {
       // Use cache on disk
@@ -160,6 +208,9 @@ bool CFileCache::Open(const CURL& url)
         // We don't need to take into account READ_MULTI_STREAM here as that's only used for audio/video
         cacheSize = m_fileSize;
 
+        // The whole file fits, so there's nothing to gain from multiple segments
+        segments = 1;
+
         // Cap chunk size by cache size
         if (m_chunkSize > cacheSize)
           m_chunkSize = cacheSize;
@@ -168,33 +219,38 @@ bool CFileCache::Open(const CURL& url)
       {
         cacheSize = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize;
 
-        // NOTE: READ_MULTI_STREAM is only used with READ_AUDIO_VIDEO
-        if (m_flags & READ_MULTI_STREAM)
-        {
-          // READ_MULTI_STREAM requires double buffering, so use half the amount of memory for each buffer
-          cacheSize /= 2;
-        }
+        // Each segment gets an equal share of the memory
+        cacheSize /= segments;
 
         // Make sure cache can at least hold 2 chunks
         if (cacheSize < m_chunkSize * 2)
           cacheSize = m_chunkSize * 2;
       }
 
-      if (m_flags & READ_MULTI_STREAM)
-        CLog::Log(LOGDEBUG, "CFileCache::Open - Using double memory cache each sized %i bytes",
-                  cacheSize);
+      if (segments > 1)
+        CLog::Log(LOGDEBUG, "CFileCache::Open - Using %u memory caches each sized %i bytes",
+                  segments, cacheSize);
       else
-        CLog::Log(LOGDEBUG, "CFileCache::Open - Using single memory cache sized %i bytes",
+        CLog::Log(LOGDEBUG, "CFileCache::Open - Using single %smemory cache sized %i bytes",
+                  CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheLockFree ? "lock-free " : "",
                   cacheSize);
 
       const size_t back = cacheSize / 4;
       const size_t front = cacheSize - back;
 
-      m_pCache = std::unique_ptr<CCircularCache>(new CCircularCache(front, back)); // C++14 - Replace with std::make_unique
+      if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheLockFree)
+        m_pCache = std::unique_ptr<CLockFreeCircularCache>(new CLockFreeCircularCache(front, back)); // C++14 - Replace with std::make_unique
+      else
+        m_pCache = std::unique_ptr<CCircularCache>(new CCircularCache(front, back)); // C++14 - Replace with std::make_unique
       m_forwardCacheSize = front;
     }
 
-    if (m_flags & READ_MULTI_STREAM)
+    if (segments > 2)
+    {
+      // Keep several non-contiguous ranges of the file cached, evicting the least recently used
+      m_pCache = std::unique_ptr<CSegmentedCache>(new CSegmentedCache(m_pCache.release(), segments)); // C++14 - Replace with std::make_unique
+    }
+    else if (segments == 2)
     {
       // If READ_MULTI_STREAM flag is set: Double buffering is required
       m_pCache = std::unique_ptr<CDoubleCache>(new CDoubleCache(m_pCache.release())); // C++14 - Replace with std::make_unique
@@ -202,7 +258,7 @@ bool CFileCache::Open(const CURL& url)
   }
 
   // open cache strategy
-  if (!m_pCache || m_pCache->Open() != CACHE_RC_OK)
+  if (!m_pCache || (!m_persistentCache && m_pCache->Open() != CACHE_RC_OK))
   {
     CLog::Log(LOGERROR,"CFileCache::Open - failed to open cache");
     Close();
@@ -211,6 +267,15 @@ bool CFileCache::Open(const CURL& url)
 
   m_readPos = 0;
   m_writePos = 0;
+
+  // continue filling after the data the cache already holds from an earlier session
+  const int64_t cachedEnd = m_pCache->CachedDataEndPosIfSeekTo(0);
+  if (cachedEnd > 0 && (cachedEnd >= m_fileSize || SeekSource(cachedEnd) == cachedEnd))
+  {
+    m_pCache->Reset(0, false);
+    m_writePos = m_pCache->CachedDataEndPos();
+    CLog::Log(LOGDEBUG, "CFileCache::Open - %" PRId64 " bytes already cached", m_writePos);
+  }
   m_writeRate = 1024 * 1024;
   m_writeRateActual = 0;
   m_bFilling = true;
@@ -256,7 +321,7 @@ void CFileCache::Process()
       bool sourceSeekFailed = false;
       if (!cacheReachEOF)
       {
-        m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
+        m_nSeekResult = SeekSource(cacheMaxPos);
         if (m_nSeekResult != cacheMaxPos)
         {
           CLog::Log(LOGERROR, "CFileCache::Process - Error %d seeking. Seek returned %" PRId64,
@@ -324,7 +389,7 @@ void CFileCache::Process()
 
     ssize_t iRead = 0;
     if (maxSourceRead > 0)
-      iRead = m_source.Read(buffer.get(), maxSourceRead);
+      iRead = ReadSource(buffer.get(), maxSourceRead);
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -437,6 +502,32 @@ void CFileCache::Process()
   }
 }
 
+ssize_t CFileCache::ReadSource(char* buffer, size_t size)
+{
+  if (!m_rangeFetcher || m_rangeFetchFailed)
+    return m_source.Read(buffer, size);
+
+  ssize_t iRead = m_rangeFetcher->Read(buffer, size);
+  if (iRead < 0 && !m_bStop)
+  {
+    // StopThread may cancel the fetcher at any time, it is only released by
+    // Close after the thread has ended
+    CLog::Log(LOGWARNING, "CFileCache::ReadSource - range fetching failed, falling back to single connection");
+    m_rangeFetchFailed = true;
+    if (m_source.Seek(m_writePos, SEEK_SET) != m_writePos)
+      return -1;
+    iRead = m_source.Read(buffer, size);
+  }
+  return iRead;
+}
+
+int64_t CFileCache::SeekSource(int64_t pos)
+{
+  if (m_rangeFetcher && !m_rangeFetchFailed)
+    return m_rangeFetcher->Seek(pos);
+  return m_source.Seek(pos, SEEK_SET);
+}
+
 void CFileCache::OnExit()
 {
   m_bStop = true;
@@ -472,17 +563,27 @@ ssize_t CFileCache::Read(void* lpBuf, size_t uiBufSize)
   if (uiBufSize > SSIZE_MAX)
     uiBufSize = SSIZE_MAX;
 
+  bool waited = false;
+
 retry:
   // attempt to read
   iRc = m_pCache->ReadFromCache((char *)lpBuf, uiBufSize);
   if (iRc > 0)
   {
+    if (m_ioStats)
+    {
+      if (waited)
+        m_ioStats->cacheMisses++;
+      else
+        m_ioStats->cacheHits++;
+    }
     m_readPos += iRc;
     return (int)iRc;
   }
 
   if (iRc == CACHE_RC_WOULD_BLOCK)
   {
+    waited = true;
     // just wait for some data to show up
     iRc = m_pCache->WaitForData(1, 10000);
     if (iRc > 0)
@@ -569,6 +670,7 @@ void CFileCache::Close()
   if (m_pCache)
     m_pCache->Close();
 
+  m_rangeFetcher.reset();
   m_source.Close();
 }
 
@@ -587,6 +689,9 @@ void CFileCache::StopThread(bool bWait /*= true*/)
   m_bStop = true;
   //Process could be waiting for seekEvent
   m_seekEvent.Set();
+  //or for the next chunk of a range fetch
+  if (m_rangeFetcher)
+    m_rangeFetcher->Cancel();
   CThread::StopThread(bWait);
 }
 
@@ -608,6 +713,7 @@ int CFileCache::IoControl(EIoControl request, void* param)
     status->currate = m_writeRateActual;
     status->lowspeed = m_bLowSpeedDetected;
     m_bLowSpeedDetected = false; // Reset flag
+    m_pCache->GetHitStats(status->hits, status->misses, status->hitbytes);
     return 0;
   }
 
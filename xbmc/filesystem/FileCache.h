@@ -11,6 +11,7 @@
 #include "CacheStrategy.h"
 #include "File.h"
 #include "IFile.h"
+#include "IOStats.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 
@@ -20,6 +21,8 @@
 namespace XFILE
 {
 
+  class CCurlRangeFetcher;
+
   class CFileCache : public IFile, public CThread
   {
   public:
@@ -55,7 +58,13 @@ namespace XFILE
     }
 
   private:
+    ssize_t ReadSource(char* buffer, size_t size);
+    int64_t SeekSource(int64_t pos);
+
     std::unique_ptr<CCacheStrategy> m_pCache;
+    std::unique_ptr<CCurlRangeFetcher> m_rangeFetcher;
+    bool m_rangeFetchFailed = false;
+    bool m_persistentCache = false;
     int m_seekPossible;
     CFile m_source;
     std::string m_sourcePath;
@@ -73,6 +82,7 @@ namespace XFILE
     bool m_bLowSpeedDetected;
     std::atomic<int64_t> m_fileSize;
     unsigned int m_flags;
+    CIOStats::SProtocolStats* m_ioStats = nullptr;
     CCriticalSection m_sync;
   };
 
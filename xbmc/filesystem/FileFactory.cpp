@@ -60,6 +60,7 @@
 #include "UDFFile.h"
 #endif
 #include "ImageFile.h"
+#include "IOStatsFile.h"
 #include "ResourceFile.h"
 #include "URL.h"
 #include "utils/log.h"
@@ -82,6 +83,19 @@ IFile* CFileFactory::CreateLoader(const std::string& strFileName)
 }
 
 IFile* CFileFactory::CreateLoader(const CURL& url)
+{
+  IFile* file = CreateImplementation(url);
+  if (!file || !CIOStats::IsEnabled())
+    return file;
+
+  std::string protocol = url.GetProtocol();
+  if (protocol.empty())
+    protocol = "file";
+  StringUtils::ToLower(protocol);
+  return new CIOStatsFile(file, protocol);
+}
+
+IFile* CFileFactory::CreateImplementation(const CURL& url)
 {
   if (!CWakeOnAccess::GetInstance().WakeUpHost(url))
     return NULL;
@@ -25,5 +25,8 @@ public:
   virtual ~CFileFactory();
   static IFile* CreateLoader(const std::string& strFileName);
   static IFile* CreateLoader(const CURL& url);
+
+private:
+  static IFile* CreateImplementation(const CURL& url);
 };
 }
@@ -14,6 +14,8 @@
 #include "URL.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "threads/IRunnable.h"
+#include "threads/Thread.h"
 #include "utils/CharsetConverter.h"
 #include "utils/HTMLUtil.h"
 #include "utils/RegExp.h"
@@ -21,10 +23,69 @@
 #include "utils/URIUtils.h"
 #include "utils/log.h"
 
+#include <algorithm>
+#include <atomic>
 #include <climits>
+#include <memory>
+#include <vector>
 
 using namespace XFILE;
 
+namespace
+{
+// number of concurrent HEAD requests used to get the size of listed files
+constexpr size_t MAX_STAT_CONNECTIONS = 8;
+
+/*!
+ \brief Stats a list of files over several connections at once.
+
+ The calling thread takes part in the work, so a single file doesn't spawn a
+ thread at all.
+ */
+class CHTTPStatFetcher : private IRunnable
+{
+public:
+  explicit CHTTPStatFetcher(std::vector<CFileItemPtr>& items) : m_items(items) {}
+
+  void Fetch()
+  {
+    const size_t connections = std::min(m_items.size(), MAX_STAT_CONNECTIONS);
+    std::vector<std::unique_ptr<CThread>> workers;
+    for (size_t i = 1; i < connections; i++)
+    {
+      workers.emplace_back(new CThread(this, "HTTPDirectoryStat"));
+      workers.back()->Create(false);
+    }
+
+    Run();
+
+    for (auto& worker : workers)
+      worker->StopThread(true);
+  }
+
+private:
+  void Run() override
+  {
+    size_t i;
+    while ((i = m_next++) < m_items.size())
+    {
+      CFileItem& item = *m_items[i];
+      CCurlFile file;
+      struct __stat64 buffer;
+      if (file.Stat(item.GetURL(), &buffer) != 0)
+        continue;
+
+      item.m_dwSize = buffer.st_size;
+      if (!item.m_dateTime.IsValid() && buffer.st_mtime != 0)
+        item.m_dateTime = static_cast<time_t>(buffer.st_mtime);
+    }
+  }
+
+  std::vector<CFileItemPtr>& m_items;
+  std::atomic<size_t> m_next{0};
+};
+} // namespace
+
 CHTTPDirectory::CHTTPDirectory(void) = default;
 CHTTPDirectory::~CHTTPDirectory(void) = default;
 
@@ -67,6 +128,8 @@ bool CHTTPDirectory::GetDirectory(const CURL& url, CFileItemList &items)
   CRegExp reSize(true);
   reSize.RegComp(" +([0-9]+)(B|K|M|G)?(?=\\s|<|$)");
 
+  std::vector<CFileItemPtr> statItems;
+
   /* read response from server into string buffer */
   std::string strBuffer;
   if (http.ReadData(strBuffer) && strBuffer.length() > 0)
@@ -251,10 +314,7 @@ bool CHTTPDirectory::GetDirectory(const CURL& url, CFileItemList &items)
           else
           if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bHTTPDirectoryStatFilesize) // As a fallback get the size by stat-ing the file (slow)
           {
-            CCurlFile file;
-            file.Open(url);
-            pItem->m_dwSize=file.GetLength();
-            file.Close();
+            statItems.push_back(pItem);
           }
         }
         items.Add(pItem);
@@ -263,6 +323,12 @@ bool CHTTPDirectory::GetDirectory(const CURL& url, CFileItemList &items)
   }
   http.Close();
 
+  if (!statItems.empty())
+  {
+    CHTTPStatFetcher fetcher(statItems);
+    fetcher.Fetch();
+  }
+
   items.SetProperty("IsHTTPDirectory", true);
 
   return true;
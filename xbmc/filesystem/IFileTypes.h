@@ -40,18 +40,32 @@ namespace XFILE
 /* indicate that caller want to reopen a file if its already open  */
   static const unsigned int READ_REOPEN = 0x100;
 
+/* indicate that the file should be memory mapped if possible (local files), see CFile::GetSpan.
+   Accessing the mapping of a file that is truncated or whose mount goes away raises SIGBUS,
+   so only use it for files that are not expected to change while they are open */
+  static const unsigned int READ_MMAP = 0x200;
+
 struct SNativeIoControl
 {
   unsigned long int   request;
   void*               param;
 };
 
+struct SFileMapping
+{
+  const uint8_t* data = nullptr; /**< start of the mapped file, valid until the file is closed */
+  int64_t size = 0;              /**< size of the mapping, the file length when it was mapped */
+};
+
 struct SCacheStatus
 {
   uint64_t forward;  /**< number of bytes cached forward of current position */
   unsigned maxrate;  /**< maximum number of bytes per second cache is allowed to fill */
   unsigned currate;  /**< average read rate from source file since last position change */
   bool     lowspeed; /**< cache low speed condition detected? */
+  uint64_t hits;     /**< reads served from data cached by an earlier session (persistent cache) */
+  uint64_t misses;   /**< reads that needed data fetched from the source (persistent cache) */
+  uint64_t hitbytes; /**< bytes served from data cached by an earlier session (persistent cache) */
 };
 
 typedef enum {
@@ -62,6 +76,7 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_MMAP          = 32, /**< SFileMapping structure, map the whole file read only (if supported) */
 } EIoControl;
 
 enum CURLOPTIONTYPE
@@ -0,0 +1,187 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "IOStats.h"
+
+#include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "utils/Variant.h"
+#include "utils/log.h"
+
+#include <inttypes.h>
+
+using namespace XFILE;
+
+namespace
+{
+void ResetHistogram(CIOStats::Histogram& histogram)
+{
+  for (auto& bucket : histogram)
+    bucket = 0;
+}
+
+void ResetStats(CIOStats::SProtocolStats& stats)
+{
+  stats.opens = 0;
+  stats.openFailures = 0;
+  stats.stats = 0;
+  stats.reads = 0;
+  stats.readErrors = 0;
+  stats.bytesRead = 0;
+  stats.writes = 0;
+  stats.bytesWritten = 0;
+  stats.seeks = 0;
+  stats.cacheHits = 0;
+  stats.cacheMisses = 0;
+  stats.openTime = 0;
+  stats.readTime = 0;
+  stats.seekTime = 0;
+  ResetHistogram(stats.readSizes);
+  ResetHistogram(stats.readLatency);
+  ResetHistogram(stats.seekLatency);
+}
+
+void SerializeLatency(const CIOStats::Histogram& histogram, CVariant& value)
+{
+  value["p50"] = CIOStats::Percentile(histogram, 0.5);
+  value["p90"] = CIOStats::Percentile(histogram, 0.9);
+  value["p99"] = CIOStats::Percentile(histogram, 0.99);
+}
+} // namespace
+
+CIOStats& CIOStats::GetInstance()
+{
+  static CIOStats ioStats;
+  return ioStats;
+}
+
+bool CIOStats::IsEnabled()
+{
+  // files are created before the settings are loaded and after they're gone
+  const auto settingsComponent = CServiceBroker::GetSettingsComponent();
+  if (!settingsComponent || !settingsComponent->GetAdvancedSettings())
+    return false;
+  return settingsComponent->GetAdvancedSettings()->m_ioStats;
+}
+
+CIOStats::SProtocolStats& CIOStats::Get(const std::string& protocol)
+{
+  CSingleLock lock(m_lock);
+  auto& stats = m_protocols[protocol];
+  if (!stats)
+  {
+    // C++14 - Replace with std::make_unique
+    stats.reset(new SProtocolStats());
+    ResetStats(*stats);
+  }
+  return *stats;
+}
+
+void CIOStats::Reset()
+{
+  CSingleLock lock(m_lock);
+  for (auto& protocol : m_protocols)
+    ResetStats(*protocol.second);
+}
+
+void CIOStats::Record(Histogram& histogram, uint64_t value)
+{
+  size_t bucket = 0;
+  while (value > 1 && bucket < HISTOGRAM_BUCKETS - 1)
+  {
+    value >>= 1;
+    bucket++;
+  }
+  histogram[bucket]++;
+}
+
+uint64_t CIOStats::Percentile(const Histogram& histogram, double fraction)
+{
+  uint64_t total = 0;
+  for (const auto& bucket : histogram)
+    total += bucket;
+  if (total == 0)
+    return 0;
+
+  const uint64_t target = static_cast<uint64_t>(fraction * total);
+  uint64_t count = 0;
+  for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+  {
+    count += histogram[i];
+    if (count > target)
+      return uint64_t(2) << i;
+  }
+  return uint64_t(2) << (HISTOGRAM_BUCKETS - 1);
+}
+
+void CIOStats::Serialize(CVariant& value) const
+{
+  value = CVariant(CVariant::VariantTypeArray);
+
+  CSingleLock lock(m_lock);
+  for (const auto& protocol : m_protocols)
+  {
+    const SProtocolStats& stats = *protocol.second;
+    CVariant item(CVariant::VariantTypeObject);
+    item["protocol"] = protocol.first;
+    item["opens"] = stats.opens.load();
+    item["openfailures"] = stats.openFailures.load();
+    item["stats"] = stats.stats.load();
+    item["reads"] = stats.reads.load();
+    item["readerrors"] = stats.readErrors.load();
+    item["bytesread"] = stats.bytesRead.load();
+    item["writes"] = stats.writes.load();
+    item["byteswritten"] = stats.bytesWritten.load();
+    item["seeks"] = stats.seeks.load();
+    item["cachehits"] = stats.cacheHits.load();
+    item["cachemisses"] = stats.cacheMisses.load();
+    item["opentime"] = stats.openTime.load() / 1000;
+    item["readtime"] = stats.readTime.load() / 1000;
+    item["seektime"] = stats.seekTime.load() / 1000;
+
+    const uint64_t lookups = stats.cacheHits + stats.cacheMisses;
+    item["cachehitratio"] = lookups ? static_cast<double>(stats.cacheHits) / lookups : 0.0;
+    item["throughput"] = stats.readTime ? stats.bytesRead * 1000000 / stats.readTime : 0;
+
+    SerializeLatency(stats.readLatency, item["readlatency"]);
+    SerializeLatency(stats.seekLatency, item["seeklatency"]);
+
+    CVariant& readSizes = item["readsizes"];
+    readSizes = CVariant(CVariant::VariantTypeArray);
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+      if (stats.readSizes[i] == 0)
+        continue;
+
+      CVariant bucket(CVariant::VariantTypeObject);
+      bucket["size"] = uint64_t(2) << i;
+      bucket["count"] = stats.readSizes[i].load();
+      readSizes.push_back(bucket);
+    }
+    value.push_back(item);
+  }
+}
+
+void CIOStats::Log() const
+{
+  CSingleLock lock(m_lock);
+  for (const auto& protocol : m_protocols)
+  {
+    const SProtocolStats& stats = *protocol.second;
+    CLog::Log(LOGINFO, "CIOStats::Log - %s: %" PRIu64 " opens (%" PRIu64 " failed), %" PRIu64 " stats, %" PRIu64 " reads, %" PRIu64 " bytes, %" PRIu64 " seeks, %" PRIu64 " cache hits, %" PRIu64 " cache misses",
+              protocol.first.c_str(), stats.opens.load(), stats.openFailures.load(), stats.stats.load(),
+              stats.reads.load(), stats.bytesRead.load(), stats.seeks.load(),
+              stats.cacheHits.load(), stats.cacheMisses.load());
+    CLog::Log(LOGINFO, "CIOStats::Log - %s: read latency p50 %" PRIu64 " us, p90 %" PRIu64 " us, p99 %" PRIu64 " us, seek latency p50 %" PRIu64 " us, p99 %" PRIu64 " us",
+              protocol.first.c_str(), Percentile(stats.readLatency, 0.5), Percentile(stats.readLatency, 0.9),
+              Percentile(stats.readLatency, 0.99), Percentile(stats.seekLatency, 0.5),
+              Percentile(stats.seekLatency, 0.99));
+  }
+}
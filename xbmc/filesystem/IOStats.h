@@ -0,0 +1,90 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+class CVariant;
+
+namespace XFILE
+{
+/*!
+ \brief I/O counters of the VFS, per protocol.
+
+ The counters are updated by CIOStatsFile, which wraps every IFile created by
+ CFileFactory, and by CFileCache for its hit ratio. Once a protocol has been
+ seen, recording only touches atomics. Nothing is wrapped or recorded unless
+ enabled with <iostats> in advancedsettings.xml.
+ */
+class CIOStats
+{
+public:
+  /*! \brief Power of two buckets, the last one also counts everything larger */
+  static const size_t HISTOGRAM_BUCKETS = 24;
+  using Histogram = std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS>;
+
+  struct SProtocolStats
+  {
+    std::atomic<uint64_t> opens;
+    std::atomic<uint64_t> openFailures;
+    std::atomic<uint64_t> stats;
+    std::atomic<uint64_t> reads;
+    std::atomic<uint64_t> readErrors;
+    std::atomic<uint64_t> bytesRead;
+    std::atomic<uint64_t> writes;
+    std::atomic<uint64_t> bytesWritten;
+    std::atomic<uint64_t> seeks;
+    std::atomic<uint64_t> cacheHits;
+    std::atomic<uint64_t> cacheMisses;
+    std::atomic<uint64_t> openTime; // microseconds
+    std::atomic<uint64_t> readTime; // microseconds
+    std::atomic<uint64_t> seekTime; // microseconds
+    Histogram readSizes;   // bytes
+    Histogram readLatency; // microseconds
+    Histogram seekLatency; // microseconds
+  };
+
+  static CIOStats& GetInstance();
+
+  /*! \brief Whether files opened from now on should be recorded */
+  static bool IsEnabled();
+
+  /*!
+   \brief Counters of a protocol, created on first use.
+   \return reference that stays valid for the lifetime of the application.
+   */
+  SProtocolStats& Get(const std::string& protocol);
+
+  void Reset();
+  void Serialize(CVariant& value) const;
+  void Log() const;
+
+  static void Record(Histogram& histogram, uint64_t value);
+
+  /*!
+   \brief Upper bound of the bucket holding the given fraction of the recorded values.
+   */
+  static uint64_t Percentile(const Histogram& histogram, double fraction);
+
+private:
+  CIOStats() = default;
+  CIOStats(const CIOStats&) = delete;
+  CIOStats& operator=(const CIOStats&) = delete;
+
+  mutable CCriticalSection m_lock;
+  std::map<std::string, std::unique_ptr<SProtocolStats>> m_protocols;
+};
+}
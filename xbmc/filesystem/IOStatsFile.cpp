@@ -0,0 +1,204 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "IOStatsFile.h"
+
+#include <chrono>
+#include <string.h>
+
+using namespace XFILE;
+
+namespace
+{
+class CElapsed
+{
+public:
+  CElapsed() : m_start(std::chrono::steady_clock::now()) {}
+
+  uint64_t Microseconds() const
+  {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - m_start).count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point m_start;
+};
+} // namespace
+
+CIOStatsFile::CIOStatsFile(IFile* file, const std::string& protocol)
+  : m_file(file),
+    m_stats(CIOStats::GetInstance().Get(protocol))
+{
+}
+
+bool CIOStatsFile::Open(const CURL& url)
+{
+  CElapsed elapsed;
+  const bool result = m_file->Open(url);
+  m_stats.openTime += elapsed.Microseconds();
+  m_stats.opens++;
+  if (!result)
+    m_stats.openFailures++;
+  return result;
+}
+
+bool CIOStatsFile::OpenForWrite(const CURL& url, bool bOverWrite)
+{
+  const bool result = m_file->OpenForWrite(url, bOverWrite);
+  m_stats.opens++;
+  if (!result)
+    m_stats.openFailures++;
+  return result;
+}
+
+bool CIOStatsFile::ReOpen(const CURL& url)
+{
+  return m_file->ReOpen(url);
+}
+
+bool CIOStatsFile::Exists(const CURL& url)
+{
+  m_stats.stats++;
+  return m_file->Exists(url);
+}
+
+int CIOStatsFile::Stat(const CURL& url, struct __stat64* buffer)
+{
+  m_stats.stats++;
+  return m_file->Stat(url, buffer);
+}
+
+int CIOStatsFile::Stat(struct __stat64* buffer)
+{
+  m_stats.stats++;
+  return m_file->Stat(buffer);
+}
+
+ssize_t CIOStatsFile::Read(void* lpBuf, size_t uiBufSize)
+{
+  CElapsed elapsed;
+  const ssize_t result = m_file->Read(lpBuf, uiBufSize);
+  const uint64_t time = elapsed.Microseconds();
+
+  m_stats.reads++;
+  m_stats.readTime += time;
+  CIOStats::Record(m_stats.readLatency, time);
+  if (result < 0)
+    m_stats.readErrors++;
+  else
+  {
+    m_stats.bytesRead += result;
+    CIOStats::Record(m_stats.readSizes, result);
+  }
+  return result;
+}
+
+ssize_t CIOStatsFile::Write(const void* lpBuf, size_t uiBufSize)
+{
+  const ssize_t result = m_file->Write(lpBuf, uiBufSize);
+  m_stats.writes++;
+  if (result > 0)
+    m_stats.bytesWritten += result;
+  return result;
+}
+
+bool CIOStatsFile::ReadString(char* szLine, int iLineLength)
+{
+  CElapsed elapsed;
+  const bool result = m_file->ReadString(szLine, iLineLength);
+  const uint64_t time = elapsed.Microseconds();
+
+  m_stats.reads++;
+  m_stats.readTime += time;
+  CIOStats::Record(m_stats.readLatency, time);
+  if (result)
+  {
+    const size_t length = strlen(szLine);
+    m_stats.bytesRead += length;
+    CIOStats::Record(m_stats.readSizes, length);
+  }
+  return result;
+}
+
+int64_t CIOStatsFile::Seek(int64_t iFilePosition, int iWhence)
+{
+  CElapsed elapsed;
+  const int64_t result = m_file->Seek(iFilePosition, iWhence);
+  const uint64_t time = elapsed.Microseconds();
+
+  m_stats.seeks++;
+  m_stats.seekTime += time;
+  CIOStats::Record(m_stats.seekLatency, time);
+  return result;
+}
+
+void CIOStatsFile::Close()
+{
+  m_file->Close();
+}
+
+int64_t CIOStatsFile::GetPosition()
+{
+  return m_file->GetPosition();
+}
+
+int64_t CIOStatsFile::GetLength()
+{
+  return m_file->GetLength();
+}
+
+void CIOStatsFile::Flush()
+{
+  m_file->Flush();
+}
+
+int CIOStatsFile::Truncate(int64_t size)
+{
+  return m_file->Truncate(size);
+}
+
+int CIOStatsFile::GetChunkSize()
+{
+  return m_file->GetChunkSize();
+}
+
+double CIOStatsFile::GetDownloadSpeed()
+{
+  return m_file->GetDownloadSpeed();
+}
+
+bool CIOStatsFile::Delete(const CURL& url)
+{
+  return m_file->Delete(url);
+}
+
+bool CIOStatsFile::Rename(const CURL& url, const CURL& urlnew)
+{
+  return m_file->Rename(url, urlnew);
+}
+
+bool CIOStatsFile::SetHidden(const CURL& url, bool hidden)
+{
+  return m_file->SetHidden(url, hidden);
+}
+
+int CIOStatsFile::IoControl(EIoControl request, void* param)
+{
+  return m_file->IoControl(request, param);
+}
+
+const std::string CIOStatsFile::GetProperty(XFILE::FileProperty type, const std::string& name) const
+{
+  return m_file->GetProperty(type, name);
+}
+
+const std::vector<std::string> CIOStatsFile::GetPropertyValues(XFILE::FileProperty type, const std::string& name) const
+{
+  return m_file->GetPropertyValues(type, name);
+}
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "IFile.h"
+#include "IOStats.h"
+
+#include <memory>
+#include <string>
+
+namespace XFILE
+{
+/*!
+ \brief Forwards everything to the wrapped IFile, recording calls, sizes and
+ latencies in the CIOStats counters of the given protocol.
+ */
+class CIOStatsFile : public IFile
+{
+public:
+  CIOStatsFile(IFile* file, const std::string& protocol);
+  ~CIOStatsFile() override = default;
+
+  bool Open(const CURL& url) override;
+  bool OpenForWrite(const CURL& url, bool bOverWrite = false) override;
+  bool ReOpen(const CURL& url) override;
+  bool Exists(const CURL& url) override;
+  int Stat(const CURL& url, struct __stat64* buffer) override;
+  int Stat(struct __stat64* buffer) override;
+  ssize_t Read(void* lpBuf, size_t uiBufSize) override;
+  ssize_t Write(const void* lpBuf, size_t uiBufSize) override;
+  bool ReadString(char* szLine, int iLineLength) override;
+  int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET) override;
+  void Close() override;
+  int64_t GetPosition() override;
+  int64_t GetLength() override;
+  void Flush() override;
+  int Truncate(int64_t size) override;
+  int GetChunkSize() override;
+  double GetDownloadSpeed() override;
+  bool Delete(const CURL& url) override;
+  bool Rename(const CURL& url, const CURL& urlnew) override;
+  bool SetHidden(const CURL& url, bool hidden) override;
+  int IoControl(EIoControl request, void* param) override;
+  const std::string GetProperty(XFILE::FileProperty type, const std::string& name = "") const override;
+  const std::vector<std::string> GetPropertyValues(XFILE::FileProperty type, const std::string& name = "") const override;
+
+private:
+  std::unique_ptr<IFile> m_file;
+  CIOStats::SProtocolStats& m_stats;
+};
+}
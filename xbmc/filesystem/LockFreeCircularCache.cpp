@@ -0,0 +1,288 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LockFreeCircularCache.h"
+
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace XFILE;
+
+CLockFreeCircularCache::CLockFreeCircularCache(size_t front, size_t back)
+  : CCacheStrategy()
+  , m_beg(0)
+  , m_end(0)
+  , m_cur(0)
+  , m_size(front + back)
+  , m_size_back(back)
+  , m_endOfInput(false)
+  , m_readerWaiting(false)
+  , m_writerWaiting(false)
+{
+}
+
+CLockFreeCircularCache::~CLockFreeCircularCache()
+{
+  Close();
+}
+
+int CLockFreeCircularCache::Open()
+{
+  m_buf.reset(new uint8_t[m_size]);
+  if (!m_buf)
+    return CACHE_RC_ERROR;
+  m_beg = 0;
+  m_end = 0;
+  m_cur = 0;
+  return CACHE_RC_OK;
+}
+
+void CLockFreeCircularCache::Close()
+{
+  m_buf.reset();
+}
+
+size_t CLockFreeCircularCache::GetWriteLimit(int64_t cur, int64_t beg, int64_t end) const
+{
+  size_t back  = (size_t)(cur - beg); // Backbuffer size
+  size_t front = (size_t)(end - cur); // Frontbuffer size
+  return m_size - std::min(back, m_size_back) - front;
+}
+
+size_t CLockFreeCircularCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  const int64_t end = m_end.load(std::memory_order_relaxed);
+  const int64_t beg = m_beg.load(std::memory_order_relaxed);
+  const int64_t cur = m_cur.load(std::memory_order_acquire);
+
+  const size_t limit = GetWriteLimit(cur, beg, end);
+  if (limit < iRequestSize)
+    m_writerWaiting.store(true);
+
+  // Never return more than limit and size requested by caller
+  return std::min(iRequestSize, limit);
+}
+
+/**
+ * Same write rules as CCircularCache::WriteToCache, only called from the
+ * fill thread.
+ *
+ * The reader may move m_cur backwards (Seek) at any time. Before the memcpy
+ * overwrites old history we publish the new m_beg and then re-check m_cur,
+ * while Seek publishes m_cur and then re-checks m_beg. With sequentially
+ * consistent ordering on both sides at least one of them notices the other,
+ * so the reader never gets pointed at data that is being overwritten.
+ */
+int CLockFreeCircularCache::WriteToCache(const char *buf, size_t len)
+{
+  if (!m_buf)
+    return 0;
+
+  const int64_t end = m_end.load(std::memory_order_relaxed);
+  const int64_t oldBeg = m_beg.load(std::memory_order_relaxed);
+
+  // where are we in the buffer
+  const size_t pos  = end % m_size;
+  const size_t wrap = m_size - pos;
+
+  int64_t cur = m_cur.load(std::memory_order_seq_cst);
+  size_t count;
+  while (true)
+  {
+    count = std::min(len, GetWriteLimit(cur, oldBeg, end));
+
+    // limit to wrap point
+    if (count > wrap)
+      count = wrap;
+
+    if (count == 0)
+    {
+      m_beg.store(oldBeg, std::memory_order_seq_cst);
+      m_writerWaiting.store(true);
+      return 0;
+    }
+
+    // drop history that is about to be overwritten
+    m_beg.store(std::max(oldBeg, end + (int64_t)count - (int64_t)m_size), std::memory_order_seq_cst);
+
+    const int64_t recheck = m_cur.load(std::memory_order_seq_cst);
+    if (recheck >= cur)
+      break;
+
+    // reader seeked backwards in the meantime, recalculate with its new position
+    cur = recheck;
+  }
+
+  // write the data
+  memcpy(m_buf.get() + pos, buf, count);
+  m_end.store(end + count, std::memory_order_release);
+
+  if (m_readerWaiting.load(std::memory_order_seq_cst))
+    m_written.Set();
+
+  return count;
+}
+
+/**
+ * Reads data from cache. Will only read up till the buffer wrap point,
+ * only called from the reading thread.
+ */
+int CLockFreeCircularCache::ReadFromCache(char *buf, size_t len)
+{
+  if (!m_buf)
+    return 0;
+
+  const int64_t cur = m_cur.load(std::memory_order_relaxed);
+  const int64_t end = m_end.load(std::memory_order_acquire);
+
+  size_t pos   = cur % m_size;
+  size_t front = (size_t)(end - cur);
+  size_t avail = std::min(m_size - pos, front);
+
+  if (avail == 0)
+  {
+    if (IsEndOfInput())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  if (len > avail)
+    len = avail;
+
+  if (len == 0)
+    return 0;
+
+  memcpy(buf, m_buf.get() + pos, len);
+  m_cur.store(cur + len, std::memory_order_release);
+
+  if (m_writerWaiting.exchange(false))
+    m_space.Set();
+
+  return len;
+}
+
+/* Wait "millis" milliseconds for "minimum" amount of data to come in.
+ * Note that caller needs to make sure there's sufficient space in the forward
+ * buffer for "minimum" bytes else we may block the full timeout time
+ */
+int64_t CLockFreeCircularCache::WaitForData(unsigned int minimum, unsigned int millis)
+{
+  int64_t avail = m_end.load(std::memory_order_acquire) - m_cur.load(std::memory_order_relaxed);
+
+  if (millis == 0 || IsEndOfInput())
+    return avail;
+
+  if (minimum > m_size - m_size_back)
+    minimum = m_size - m_size_back;
+
+  XbmcThreads::EndTime endtime(millis);
+  while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast())
+  {
+    m_readerWaiting.store(true, std::memory_order_seq_cst);
+
+    // re-check after announcing ourselves, the writer may have just missed the flag
+    avail = m_end.load(std::memory_order_seq_cst) - m_cur.load(std::memory_order_relaxed);
+    if (avail < minimum && !IsEndOfInput())
+      m_written.WaitMSec(std::min(endtime.MillisLeft(), 50u)); // may miss the deadline. shouldn't be a problem.
+
+    m_readerWaiting.store(false, std::memory_order_relaxed);
+    avail = m_end.load(std::memory_order_acquire) - m_cur.load(std::memory_order_relaxed);
+  }
+
+  return avail;
+}
+
+int64_t CLockFreeCircularCache::Seek(int64_t pos)
+{
+  // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  int64_t end = m_end.load(std::memory_order_acquire);
+  if (pos >= end && pos < end + 100000)
+  {
+    /* Make everything in the cache (back & forward) back-cache, to make sure
+     * there's sufficient forward space. Increasing it with only 100000 may not be
+     * sufficient due to variable filesystem chunksize
+     */
+    m_cur.store(end, std::memory_order_seq_cst);
+    WaitForData((size_t)(pos - end), 5000);
+    end = m_end.load(std::memory_order_acquire);
+  }
+
+  if (pos < m_beg.load(std::memory_order_acquire) || pos > end)
+    return CACHE_RC_ERROR;
+
+  const int64_t old = m_cur.exchange(pos, std::memory_order_seq_cst);
+  if (pos < m_beg.load(std::memory_order_seq_cst))
+  {
+    // the writer started overwriting this region before it could see us
+    m_cur.store(old, std::memory_order_seq_cst);
+    return CACHE_RC_ERROR;
+  }
+
+  if (m_writerWaiting.exchange(false))
+    m_space.Set();
+
+  return pos;
+}
+
+bool CLockFreeCircularCache::Reset(int64_t pos, bool clearAnyway)
+{
+  if (!clearAnyway && IsCachedPosition(pos))
+  {
+    m_cur.store(pos, std::memory_order_seq_cst);
+    return false;
+  }
+  m_end.store(pos, std::memory_order_seq_cst);
+  m_beg.store(pos, std::memory_order_seq_cst);
+  m_cur.store(pos, std::memory_order_seq_cst);
+
+  return true;
+}
+
+void CLockFreeCircularCache::EndOfInput()
+{
+  m_endOfInput.store(true, std::memory_order_seq_cst);
+  if (m_readerWaiting.load(std::memory_order_seq_cst))
+    m_written.Set();
+}
+
+bool CLockFreeCircularCache::IsEndOfInput()
+{
+  return m_endOfInput.load(std::memory_order_seq_cst);
+}
+
+void CLockFreeCircularCache::ClearEndOfInput()
+{
+  m_endOfInput.store(false, std::memory_order_seq_cst);
+}
+
+int64_t CLockFreeCircularCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  if (IsCachedPosition(iFilePosition))
+    return m_end.load(std::memory_order_acquire);
+  return iFilePosition;
+}
+
+int64_t CLockFreeCircularCache::CachedDataEndPos()
+{
+  return m_end.load(std::memory_order_acquire);
+}
+
+bool CLockFreeCircularCache::IsCachedPosition(int64_t iFilePosition)
+{
+  return iFilePosition >= m_beg.load(std::memory_order_acquire) &&
+         iFilePosition <= m_end.load(std::memory_order_acquire);
+}
+
+CCacheStrategy *CLockFreeCircularCache::CreateNew()
+{
+  return new CLockFreeCircularCache(m_size - m_size_back, m_size_back);
+}
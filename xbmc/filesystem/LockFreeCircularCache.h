@@ -0,0 +1,72 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/Event.h"
+
+#include <atomic>
+#include <memory>
+
+namespace XFILE {
+
+/*!
+ \brief Single-producer/single-consumer variant of CCircularCache.
+
+ Behaves like CCircularCache (same front/back buffer semantics), but the fill
+ thread and the reading thread never share a lock. The writer owns m_end and
+ m_beg, the reader owns m_cur. Events are only signalled when the other side
+ is actually waiting for them.
+
+ Reset() must only be called by the writer while the reader is blocked (as
+ CFileCache does while serving a seek request).
+ */
+class CLockFreeCircularCache : public CCacheStrategy
+{
+public:
+  CLockFreeCircularCache(size_t front, size_t back);
+  ~CLockFreeCircularCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *buf, size_t len) override;
+  int ReadFromCache(char *buf, size_t len) override;
+  int64_t WaitForData(unsigned int minimum, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t pos) override;
+  bool Reset(int64_t pos, bool clearAnyway=true) override;
+
+  void EndOfInput() override;
+  bool IsEndOfInput() override;
+  void ClearEndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+protected:
+  size_t GetWriteLimit(int64_t cur, int64_t beg, int64_t end) const;
+
+  std::atomic<int64_t> m_beg;   /**< index in file (not buffer) of beginning of valid data, owned by writer */
+  std::atomic<int64_t> m_end;   /**< index in file (not buffer) of end of valid data, owned by writer */
+  std::atomic<int64_t> m_cur;   /**< current reading index in file, owned by reader */
+  std::unique_ptr<uint8_t[]> m_buf; /**< buffer holding data */
+  size_t m_size;                /**< size of data buffer used (m_buf) */
+  size_t m_size_back;           /**< guaranteed size of back buffer */
+  std::atomic<bool> m_endOfInput;
+  std::atomic<bool> m_readerWaiting; /**< reader is blocked in WaitForData */
+  std::atomic<bool> m_writerWaiting; /**< writer found no space on last attempt */
+  CEvent m_written;
+};
+
+} // namespace XFILE
@@ -12,6 +12,9 @@
 
 #include "FileItem.h"
 #include "NFSDirectory.h"
+#include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -24,6 +27,7 @@
 
 using namespace XFILE;
 #include <limits.h>
+#include <memory>
 #include <nfsc/libnfs.h>
 #include <nfsc/libnfs-raw-nfs.h>
 
@@ -36,8 +40,93 @@ using namespace XFILE;
 #define S_ISDIR(m) ((m & _S_IFDIR) != 0)
 #define S_ISFIFO(m) ((m & _S_IFIFO) != 0)
 #define S_ISREG(m) ((m & _S_IFREG) != 0)
+#define poll WSAPoll
+#else
+#include <poll.h>
 #endif
 
+namespace
+{
+// readlink/stat requests kept in flight while resolving the symlinks of a folder
+constexpr size_t MAX_PENDING_REQUESTS = 64;
+
+struct SymlinkBatch;
+
+struct SymlinkRequest
+{
+  SymlinkBatch* batch = nullptr;
+  size_t index = 0;     // index of the link in the listing
+  std::string linkPath; // path of the link
+  std::string target;   // link target, empty if readlink failed
+  NFSSTAT stat = {};
+  bool resolved = false; // stat of a relative target succeeded
+};
+
+struct SymlinkBatch
+{
+  std::string dirName;
+  std::vector<SymlinkRequest> requests;
+  size_t pending = 0;
+  bool abandoned = false; // the listing gave up, the last callback frees the batch
+};
+
+void FinishRequest(SymlinkBatch* batch)
+{
+  if (--batch->pending == 0 && batch->abandoned)
+    delete batch;
+}
+
+void StatCallback(int err, struct nfs_context* nfs, void* data, void* privateData)
+{
+  SymlinkRequest* request = static_cast<SymlinkRequest*>(privateData);
+  if (err != 0)
+    CLog::Log(LOGERROR, "NFS: Failed to stat(%s) on link resolve %s", request->target.c_str(),
+              static_cast<const char*>(data));
+  else if (!request->batch->abandoned)
+  {
+    request->stat = *static_cast<NFSSTAT*>(data);
+    request->resolved = true;
+  }
+  FinishRequest(request->batch);
+}
+
+void ReadlinkCallback(int err, struct nfs_context* nfs, void* data, void* privateData)
+{
+  SymlinkRequest* request = static_cast<SymlinkRequest*>(privateData);
+  SymlinkBatch* batch = request->batch;
+  if (err != 0)
+    CLog::Log(LOGERROR, "Failed to readlink(%s) %s", request->linkPath.c_str(),
+              static_cast<const char*>(data));
+  else if (!batch->abandoned)
+  {
+    request->target = static_cast<const char*>(data);
+    // absolute targets may be on another export, they are resolved afterwards
+    if (!request->target.empty() && request->target[0] != '/')
+    {
+      std::string fullpath = batch->dirName;
+      URIUtils::AddSlashAtEnd(fullpath);
+      fullpath.append(request->target);
+      if (nfs_stat_async(nfs, fullpath.c_str(), StatCallback, request) == 0)
+        return; // the stat completes the request
+    }
+  }
+  FinishRequest(batch);
+}
+
+bool ServiceContext(struct nfs_context* nfs, int timeoutMs)
+{
+  struct pollfd pfd;
+  pfd.fd = nfs_get_fd(nfs);
+  pfd.events = nfs_which_events(nfs);
+  pfd.revents = 0;
+
+  if (poll(&pfd, 1, timeoutMs) <= 0)
+    return false;
+
+  return nfs_service(nfs, pfd.revents) == 0;
+}
+} // namespace
+
 CNFSDirectory::CNFSDirectory(void)
 {
   gNfsConnection.AddActiveConnection();
@@ -99,81 +188,123 @@ bool CNFSDirectory::GetServerList(CFileItemList &items)
   return ret;
 }
 
-bool CNFSDirectory::ResolveSymlink( const std::string &dirName, struct nfsdirent *dirent, CURL &resolvedUrl)
+void CNFSDirectory::SetDirentStat(struct nfsdirent* dirent, const NFSSTAT& stat)
 {
-  CSingleLock lock(gNfsConnection);
-  int ret = 0;
-  bool retVal = true;
-  std::string fullpath = dirName;
-  char resolvedLink[MAX_PATH];
+  dirent->inode = stat.st_ino;
+  dirent->mode = stat.st_mode;
+  dirent->size = stat.st_size;
+  dirent->atime.tv_sec = static_cast<long>(stat.st_atime);
+  dirent->mtime.tv_sec = static_cast<long>(stat.st_mtime);
+  dirent->ctime.tv_sec = static_cast<long>(stat.st_ctime);
+
+  //map stat mode to nf3type
+  if(S_ISBLK(stat.st_mode)){ dirent->type = NF3BLK; }
+  else if(S_ISCHR(stat.st_mode)){ dirent->type = NF3CHR; }
+  else if(S_ISDIR(stat.st_mode)){ dirent->type = NF3DIR; }
+  else if(S_ISFIFO(stat.st_mode)){ dirent->type = NF3FIFO; }
+  else if(S_ISREG(stat.st_mode)){ dirent->type = NF3REG; }
+  else if(S_ISLNK(stat.st_mode)){ dirent->type = NF3LNK; }
+  else if(S_ISSOCK(stat.st_mode)){ dirent->type = NF3SOCK; }
+}
+
+void CNFSDirectory::ResolveSymlinks(const std::string& dirName,
+                                    std::vector<struct nfsdirent>& dirents,
+                                    std::vector<CURL>& resolvedUrls,
+                                    std::vector<bool>& resolved)
+{
+  std::unique_ptr<SymlinkBatch> batch(new SymlinkBatch);
+  batch->dirName = dirName;
+  for (size_t i = 0; i < dirents.size(); i++)
+  {
+    if (dirents[i].type != NF3LNK)
+      continue;
+
+    SymlinkRequest request;
+    request.batch = batch.get();
+    request.index = i;
+    request.linkPath = dirName;
+    URIUtils::AddSlashAtEnd(request.linkPath);
+    request.linkPath.append(dirents[i].name);
+    batch->requests.push_back(request);
+    resolved[i] = false;
+  }
 
-  URIUtils::AddSlashAtEnd(fullpath);
-  fullpath.append(dirent->name);
+  if (batch->requests.empty())
+    return;
 
-  resolvedUrl.Reset();
-  resolvedUrl.SetPort(2049);
-  resolvedUrl.SetProtocol("nfs");
-  resolvedUrl.SetHostName(gNfsConnection.GetConnectedIp());
+  CSingleLock lock(gNfsConnection);
+  struct nfs_context* nfs = gNfsConnection.GetNfsContext();
+  const uint32_t timeout = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_nfsTimeout;
+  const int timeoutMs = timeout > 0 ? static_cast<int>(timeout * 1000) : -1;
+
+  // pipeline the readlink (and the chained stat) requests instead of doing
+  // a round trip for every single link
+  size_t next = 0;
+  while (next < batch->requests.size() || batch->pending > 0)
+  {
+    while (next < batch->requests.size() && batch->pending < MAX_PENDING_REQUESTS)
+    {
+      SymlinkRequest& request = batch->requests[next++];
+      if (nfs_readlink_async(nfs, request.linkPath.c_str(), ReadlinkCallback, &request) == 0)
+        batch->pending++;
+      else
+        CLog::Log(LOGERROR, "NFS: Failed to readlink(%s) %s", request.linkPath.c_str(),
+                  nfs_get_error(nfs));
+    }
 
-  ret = nfs_readlink(gNfsConnection.GetNfsContext(), fullpath.c_str(), resolvedLink, MAX_PATH);
+    if (batch->pending > 0 && !ServiceContext(nfs, timeoutMs))
+    {
+      CLog::Log(LOGERROR, "NFS: Failed to resolve symlinks in %s %s", dirName.c_str(),
+                nfs_get_error(nfs));
+      // requests may still complete on a later service of the context,
+      // the last callback frees the batch
+      batch->abandoned = true;
+      batch.release();
+      return;
+    }
+  }
 
-  if(ret == 0)
+  for (SymlinkRequest& request : batch->requests)
   {
-    NFSSTAT tmpBuffer = {0};
-    fullpath = dirName;
-    URIUtils::AddSlashAtEnd(fullpath);
-    fullpath.append(resolvedLink);
+    CURL& resolvedUrl = resolvedUrls[request.index];
+    resolvedUrl.Reset();
+    resolvedUrl.SetPort(2049);
+    resolvedUrl.SetProtocol("nfs");
+    resolvedUrl.SetHostName(gNfsConnection.GetConnectedIp());
+
+    if (request.target.empty())
+      continue; // readlink failed
 
     //special case - if link target is absolute it could be even another export
     //intervolume symlinks baby ...
-    if(resolvedLink[0] == '/')
+    if (request.target[0] == '/')
     {
       //use the special stat function for using an extra context
       //because we are inside of a dir traversal
       //and just can't change the global nfs context here
       //without destroying something...
-      fullpath = resolvedLink;
-      resolvedUrl.SetFileName(fullpath);
-      ret = gNfsConnection.stat(resolvedUrl, &tmpBuffer);
+      resolvedUrl.SetFileName(request.target);
+      if (gNfsConnection.stat(resolvedUrl, &request.stat) != 0)
+      {
+        CLog::Log(LOGERROR, "NFS: Failed to stat(%s) on link resolve %s", request.target.c_str(),
+                  nfs_get_error(nfs));
+        continue;
+      }
     }
     else
     {
-      ret = nfs_stat(gNfsConnection.GetNfsContext(), fullpath.c_str(), &tmpBuffer);
+      if (!request.resolved)
+        continue; // stat failed, already logged
+
+      std::string fullpath = dirName;
+      URIUtils::AddSlashAtEnd(fullpath);
+      fullpath.append(request.target);
       resolvedUrl.SetFileName(gNfsConnection.GetConnectedExport() + fullpath);
     }
 
-    if (ret != 0)
-    {
-      CLog::Log(LOGERROR, "NFS: Failed to stat(%s) on link resolve %s", fullpath.c_str(),
-                nfs_get_error(gNfsConnection.GetNfsContext()));
-      retVal = false;
-    }
-    else
-    {
-      dirent->inode = tmpBuffer.st_ino;
-      dirent->mode = tmpBuffer.st_mode;
-      dirent->size = tmpBuffer.st_size;
-      dirent->atime.tv_sec = static_cast<long>(tmpBuffer.st_atime);
-      dirent->mtime.tv_sec = static_cast<long>(tmpBuffer.st_mtime);
-      dirent->ctime.tv_sec = static_cast<long>(tmpBuffer.st_ctime);
-
-      //map stat mode to nf3type
-      if(S_ISBLK(tmpBuffer.st_mode)){ dirent->type = NF3BLK; }
-      else if(S_ISCHR(tmpBuffer.st_mode)){ dirent->type = NF3CHR; }
-      else if(S_ISDIR(tmpBuffer.st_mode)){ dirent->type = NF3DIR; }
-      else if(S_ISFIFO(tmpBuffer.st_mode)){ dirent->type = NF3FIFO; }
-      else if(S_ISREG(tmpBuffer.st_mode)){ dirent->type = NF3REG; }
-      else if(S_ISLNK(tmpBuffer.st_mode)){ dirent->type = NF3LNK; }
-      else if(S_ISSOCK(tmpBuffer.st_mode)){ dirent->type = NF3SOCK; }
-    }
+    SetDirentStat(&dirents[request.index], request.stat);
+    resolved[request.index] = true;
   }
-  else
-  {
-    CLog::Log(LOGERROR, "Failed to readlink(%s) %s", fullpath.c_str(),
-              nfs_get_error(gNfsConnection.GetNfsContext()));
-    retVal = false;
-  }
-  return retVal;
 }
 
 bool CNFSDirectory::GetDirectory(const CURL& url, CFileItemList &items)
@@ -219,27 +350,30 @@ bool CNFSDirectory::GetDirectory(const CURL& url, CFileItemList &items)
   }
   lock.Leave();
 
+  // the attributes come with the listing (readdirplus), only symlinks need extra requests
+  std::vector<struct nfsdirent> dirents;
   while((nfsdirent = nfs_readdir(gNfsConnection.GetNfsContext(), nfsdir)) != NULL)
+    dirents.push_back(*nfsdirent);
+
+  std::vector<CURL> linkUrls(dirents.size());
+  std::vector<bool> resolved(dirents.size(), true);
+  ResolveSymlinks(strDirName, dirents, linkUrls, resolved);
+
+  for (size_t i = 0; i < dirents.size(); i++)
   {
-    struct nfsdirent tmpDirent = *nfsdirent;
+    //skip symlinks that couldn't be resolved
+    if (!resolved[i])
+      continue;
+
+    struct nfsdirent& tmpDirent = dirents[i];
     std::string strName = tmpDirent.name;
     std::string path(myStrPath + strName);
     int64_t iSize = 0;
     bool bIsDir = false;
     int64_t lTimeDate = 0;
 
-    //reslove symlinks
-    if(tmpDirent.type == NF3LNK)
-    {
-      CURL linkUrl;
-      //resolve symlink changes tmpDirent and strName
-      if(!ResolveSymlink(strDirName,&tmpDirent,linkUrl))
-      {
-        continue;
-      }
-
-      path = linkUrl.Get();
-    }
+    if (!linkUrls[i].GetProtocol().empty())
+      path = linkUrls[i].Get();
 
     iSize = tmpDirent.size;
     bIsDir = tmpDirent.type == NF3DIR;
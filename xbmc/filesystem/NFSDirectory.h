@@ -11,6 +11,9 @@
 #include "IDirectory.h"
 #include "NFSFile.h"
 
+#include <string>
+#include <vector>
+
 struct nfsdirent;
 
 namespace XFILE
@@ -28,7 +31,11 @@ namespace XFILE
     private:
       bool GetServerList(CFileItemList &items);
       bool GetDirectoryFromExportList(const std::string& strPath, CFileItemList &items);
-      bool ResolveSymlink( const std::string &dirName, struct nfsdirent *dirent, CURL &resolvedUrl);
+      void ResolveSymlinks(const std::string& dirName,
+                           std::vector<struct nfsdirent>& dirents,
+                           std::vector<CURL>& resolvedUrls,
+                           std::vector<bool>& resolved);
+      static void SetDirentStat(struct nfsdirent* dirent, const NFSSTAT& stat);
   };
 }
 
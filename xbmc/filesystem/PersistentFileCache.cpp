@@ -0,0 +1,625 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PersistentFileCache.h"
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "IFile.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Digest.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#if defined(TARGET_POSIX)
+#include "platform/posix/filesystem/PosixFile.h"
+#define CacheLocalFile CPosixFile
+#elif defined(TARGET_WINDOWS)
+#include "platform/win32/filesystem/Win32File.h"
+#define CacheLocalFile CWin32File
+#endif // TARGET_WINDOWS
+
+#include <algorithm>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+namespace
+{
+constexpr int64_t BLOCK_SIZE = 256 * 1024;
+constexpr uint32_t INDEX_MAGIC = 0x4B424331; // "KBC1"
+// a full cache is evicted to this fraction of the budget (in eighths), so a
+// growing entry doesn't rescan the folder for every completed block
+constexpr uint64_t EVICT_TARGET_EIGHTHS = 7;
+
+struct IndexHeader
+{
+  uint32_t magic;
+  uint32_t blockSize;
+  int64_t fileSize;
+  int64_t mtime;
+  int64_t lastAccess;
+  uint64_t cachedBytes;
+};
+
+std::string GetDefaultCacheFolder()
+{
+  return URIUtils::AddFileToFolder(
+      CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cachePath, "blockcache/");
+}
+
+bool ReadIndexHeader(const std::string& path, IndexHeader& header)
+{
+  CacheLocalFile file;
+  if (!file.Open(CURL(path)))
+    return false;
+  bool ok = file.Read(&header, sizeof(header)) == sizeof(header) && header.magic == INDEX_MAGIC &&
+            header.blockSize == BLOCK_SIZE;
+  file.Close();
+  return ok;
+}
+}
+
+CCriticalSection CPersistentFileCache::m_globalSync;
+std::map<std::string, uint64_t> CPersistentFileCache::m_openEntries;
+std::map<std::string, uint64_t> CPersistentFileCache::m_cacheSizes;
+
+CPersistentFileCache::CPersistentFileCache(const std::string& url,
+                                           int64_t fileSize,
+                                           int64_t mtime,
+                                           uint64_t maxCacheSize,
+                                           const std::string& cacheFolder)
+  : m_url(url),
+    m_fileSize(fileSize),
+    m_mtime(mtime),
+    m_maxCacheSize(maxCacheSize),
+    m_folder(cacheFolder.empty() ? GetDefaultCacheFolder() : URIUtils::AddFileToFolder(cacheFolder, "")),
+    m_cacheFileRead(new CacheLocalFile()),
+    m_cacheFileWrite(new CacheLocalFile())
+{
+  m_key = CDigest::Calculate(CDigest::Type::MD5,
+                             StringUtils::Format("%s|%" PRId64 "|%" PRId64, m_url.c_str(),
+                                                 m_fileSize, m_mtime));
+  m_entry = m_folder + m_key;
+}
+
+CPersistentFileCache::~CPersistentFileCache()
+{
+  Close();
+  delete m_cacheFileRead;
+  delete m_cacheFileWrite;
+}
+
+int CPersistentFileCache::Open()
+{
+  Close();
+
+  if (m_fileSize <= 0)
+    return CACHE_RC_ERROR;
+
+  bool scan;
+  {
+    // the same entry can't be filled by two caches at the same time
+    CSingleLock lock(m_globalSync);
+    if (!m_openEntries.emplace(m_entry, 0).second)
+    {
+      CLog::Log(LOGDEBUG, "CPersistentFileCache::Open - entry for <%s> already in use",
+                CURL::GetRedacted(m_url).c_str());
+      return CACHE_RC_ERROR;
+    }
+    scan = m_cacheSizes.find(m_folder) == m_cacheSizes.end();
+  }
+  m_opened = true;
+  m_discard = false;
+  m_indexFile.clear();
+  m_openedBytes = m_hits = m_misses = m_hitBytes = m_missBytes = 0;
+
+  if (!CDirectory::Exists(m_folder) && !CDirectory::Create(m_folder))
+  {
+    CLog::Log(LOGERROR, "CPersistentFileCache::Open - unable to create %s", m_folder.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  m_dataFile = m_entry + ".cache";
+  m_indexFile = m_entry + ".idx";
+
+  m_blocks.assign(static_cast<size_t>((m_fileSize + BLOCK_SIZE - 1) / BLOCK_SIZE), false);
+  if (!LoadIndex())
+    std::fill(m_blocks.begin(), m_blocks.end(), false);
+  m_persisted = m_blocks;
+  m_openedBytes = GetCachedBytes();
+
+  {
+    CSingleLock lock(m_globalSync);
+    m_openEntries[m_entry] = m_openedBytes;
+  }
+  // the folder is scanned once, after that its running size is kept up to date
+  if (scan)
+    Evict(m_folder, m_maxCacheSize);
+
+  if (!m_cacheFileWrite->OpenForWrite(CURL(m_dataFile), false))
+  {
+    CLog::Log(LOGERROR, "CPersistentFileCache::Open - failed to open \"%s\" for writing",
+              m_dataFile.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  if (!m_cacheFileRead->Open(CURL(m_dataFile)))
+  {
+    CLog::Log(LOGERROR, "CPersistentFileCache::Open - failed to open \"%s\" for reading",
+              m_dataFile.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  m_segmentStart = m_writePos = m_readPos = 0;
+
+  CLog::Log(LOGDEBUG, "CPersistentFileCache::Open - <%s> has %u of %u blocks cached",
+            CURL::GetRedacted(m_url).c_str(),
+            static_cast<unsigned int>(std::count(m_blocks.begin(), m_blocks.end(), true)),
+            static_cast<unsigned int>(m_blocks.size()));
+
+  return CACHE_RC_OK;
+}
+
+void CPersistentFileCache::Close()
+{
+  if (!m_opened)
+    return;
+
+  m_cacheFileWrite->Close();
+  m_cacheFileRead->Close();
+
+  if (m_discard)
+  {
+    CFile::Delete(m_indexFile);
+    CFile::Delete(m_dataFile);
+  }
+  else if (!m_indexFile.empty() && !SaveIndex(GetCachedBytes()))
+  {
+    CLog::Log(LOGWARNING, "CPersistentFileCache::Close - failed to write index \"%s\"",
+              m_indexFile.c_str());
+  }
+
+  if (!m_indexFile.empty())
+    CLog::Log(LOGDEBUG,
+              "CPersistentFileCache::Close - <%s> read %" PRIu64 " bytes from the cache and %" PRIu64
+              " bytes from the source",
+              CURL::GetRedacted(m_url).c_str(), m_hitBytes, m_missBytes);
+
+  bool evict;
+  {
+    CSingleLock lock(m_globalSync);
+    m_openEntries.erase(m_entry);
+    evict = m_cacheSizes[m_folder] > m_maxCacheSize;
+  }
+  m_opened = false;
+
+  if (evict)
+    Evict(m_folder, m_maxCacheSize);
+}
+
+bool CPersistentFileCache::LoadIndex()
+{
+  CacheLocalFile file;
+  if (!file.Open(CURL(m_indexFile)))
+    return false;
+
+  IndexHeader header;
+  bool ok = file.Read(&header, sizeof(header)) == sizeof(header) && header.magic == INDEX_MAGIC &&
+            header.blockSize == BLOCK_SIZE && header.fileSize == m_fileSize &&
+            header.mtime == m_mtime;
+
+  std::vector<uint8_t> bitmap((m_blocks.size() + 7) / 8);
+  if (ok)
+    ok = file.Read(bitmap.data(), bitmap.size()) == static_cast<ssize_t>(bitmap.size());
+  file.Close();
+
+  if (!ok)
+    return false;
+
+  for (size_t i = 0; i < m_blocks.size(); i++)
+    m_blocks[i] = (bitmap[i / 8] & (1 << (i % 8))) != 0;
+
+  return true;
+}
+
+uint64_t CPersistentFileCache::GetCachedBytes() const
+{
+  uint64_t bytes = 0;
+  for (size_t i = 0; i < m_blocks.size(); i++)
+  {
+    if (m_blocks[i])
+      bytes += std::min(BLOCK_SIZE, m_fileSize - static_cast<int64_t>(i) * BLOCK_SIZE);
+  }
+  return bytes;
+}
+
+bool CPersistentFileCache::SaveIndex(uint64_t cachedBytes)
+{
+  IndexHeader header;
+  header.magic = INDEX_MAGIC;
+  header.blockSize = BLOCK_SIZE;
+  header.fileSize = m_fileSize;
+  header.mtime = m_mtime;
+  header.lastAccess = time(nullptr);
+  header.cachedBytes = cachedBytes;
+
+  std::vector<uint8_t> bitmap((m_blocks.size() + 7) / 8, 0);
+  for (size_t i = 0; i < m_blocks.size(); i++)
+  {
+    if (m_blocks[i])
+      bitmap[i / 8] |= 1 << (i % 8);
+  }
+
+  CacheLocalFile file;
+  if (!file.OpenForWrite(CURL(m_indexFile), true))
+    return false;
+  bool ok = file.Write(&header, sizeof(header)) == sizeof(header) &&
+            file.Write(bitmap.data(), bitmap.size()) == static_cast<ssize_t>(bitmap.size());
+  file.Close();
+
+  return ok;
+}
+
+bool CPersistentFileCache::IsValid(int64_t iFilePosition) const
+{
+  if (iFilePosition >= m_segmentStart && iFilePosition < m_writePos)
+    return true;
+  const size_t block = static_cast<size_t>(iFilePosition / BLOCK_SIZE);
+  return block < m_blocks.size() && m_blocks[block];
+}
+
+int64_t CPersistentFileCache::GetRunEnd(int64_t iFilePosition) const
+{
+  // end of the contiguous valid data starting at iFilePosition
+  int64_t pos = iFilePosition;
+  while (pos < m_fileSize)
+  {
+    if (pos >= m_segmentStart && pos < m_writePos)
+      pos = m_writePos;
+    else if (m_blocks[static_cast<size_t>(pos / BLOCK_SIZE)])
+      pos = std::min((pos / BLOCK_SIZE + 1) * BLOCK_SIZE, m_fileSize);
+    else
+      break;
+  }
+  return std::max(pos, iFilePosition);
+}
+
+size_t CPersistentFileCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  return iRequestSize; // Can always write since it's on disk
+}
+
+int CPersistentFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  int64_t writePos;
+  {
+    CSingleLock lock(m_sync);
+    writePos = m_writePos;
+  }
+
+  if (m_cacheFileWrite->Seek(writePos, SEEK_SET) != writePos)
+  {
+    CLog::Log(LOGERROR, "CPersistentFileCache::WriteToCache - failed to seek in cache file");
+    return CACHE_RC_ERROR;
+  }
+
+  size_t written = 0;
+  while (written < iSize)
+  {
+    const ssize_t lastWritten = m_cacheFileWrite->Write(
+        pBuffer + written, std::min(iSize - written, static_cast<size_t>(SSIZE_MAX)));
+    if (lastWritten <= 0)
+    {
+      CLog::Log(LOGERROR, "CPersistentFileCache::WriteToCache - failed to write to cache file");
+      return CACHE_RC_ERROR;
+    }
+    written += lastWritten;
+  }
+
+  uint64_t completed = 0;
+  {
+    CSingleLock lock(m_sync);
+    m_writePos += written;
+
+    // mark the blocks that are now completely written in this session
+    for (int64_t block = writePos / BLOCK_SIZE; block * BLOCK_SIZE < m_writePos; block++)
+    {
+      const int64_t blockEnd = std::min((block + 1) * BLOCK_SIZE, m_fileSize);
+      if (block * BLOCK_SIZE >= m_segmentStart && blockEnd <= m_writePos &&
+          !m_blocks[static_cast<size_t>(block)])
+      {
+        m_blocks[static_cast<size_t>(block)] = true;
+        completed += blockEnd - block * BLOCK_SIZE;
+      }
+    }
+  }
+
+  // when reader waits for data it will wait on the event.
+  m_dataAvail.Set();
+
+  if (completed > 0)
+    AddCompletedBytes(completed);
+
+  return written;
+}
+
+void CPersistentFileCache::AddCompletedBytes(uint64_t bytes)
+{
+  if (m_discard)
+    return;
+
+  bool full;
+  {
+    CSingleLock lock(m_globalSync);
+    m_openEntries[m_entry] += bytes;
+    uint64_t& size = m_cacheSizes[m_folder];
+    size += bytes;
+    full = size > m_maxCacheSize;
+  }
+  if (!full)
+    return;
+
+  if (Evict(m_folder, m_maxCacheSize / 8 * EVICT_TARGET_EIGHTHS) <= m_maxCacheSize)
+    return;
+
+  // the open entries alone exceed the budget, stop counting this one and drop it on close
+  CLog::Log(LOGDEBUG,
+            "CPersistentFileCache::AddCompletedBytes - <%s> exceeds the cache size, not keeping it",
+            CURL::GetRedacted(m_url).c_str());
+  m_discard = true;
+
+  CSingleLock lock(m_globalSync);
+  uint64_t& entrySize = m_openEntries[m_entry];
+  uint64_t& size = m_cacheSizes[m_folder];
+  size = size >= entrySize ? size - entrySize : 0;
+  entrySize = 0;
+}
+
+int CPersistentFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  int64_t readPos;
+  size_t toRead;
+  {
+    CSingleLock lock(m_sync);
+    readPos = m_readPos;
+    toRead = static_cast<size_t>(std::min<int64_t>(iMaxSize, GetRunEnd(readPos) - readPos));
+  }
+
+  if (toRead == 0)
+    return IsEndOfInput() ? 0 : CACHE_RC_WOULD_BLOCK;
+
+  if (m_cacheFileRead->Seek(readPos, SEEK_SET) != readPos)
+  {
+    CLog::Log(LOGERROR, "CPersistentFileCache::ReadFromCache - failed to seek in cache file");
+    return CACHE_RC_ERROR;
+  }
+
+  size_t readBytes = 0;
+  while (readBytes < toRead)
+  {
+    const ssize_t lastRead = m_cacheFileRead->Read(pBuffer + readBytes, toRead - readBytes);
+    if (lastRead <= 0)
+    {
+      CLog::Log(LOGERROR, "CPersistentFileCache::ReadFromCache - failed to read from cache file");
+      return CACHE_RC_ERROR;
+    }
+    readBytes += lastRead;
+  }
+
+  uint64_t hits = 0;
+  {
+    CSingleLock lock(m_sync);
+    for (int64_t pos = readPos; pos < readPos + static_cast<int64_t>(readBytes);)
+    {
+      const int64_t next = std::min((pos / BLOCK_SIZE + 1) * BLOCK_SIZE, readPos + static_cast<int64_t>(readBytes));
+      if (m_persisted[static_cast<size_t>(pos / BLOCK_SIZE)])
+        hits += next - pos;
+      pos = next;
+    }
+    m_readPos += readBytes;
+    if (hits == readBytes)
+      m_hits++;
+    else
+      m_misses++;
+    m_hitBytes += hits;
+    m_missBytes += readBytes - hits;
+  }
+
+  return readBytes;
+}
+
+int64_t CPersistentFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  XbmcThreads::EndTime endTime(iMillis);
+  while (true)
+  {
+    int64_t avail;
+    {
+      CSingleLock lock(m_sync);
+      avail = GetRunEnd(m_readPos) - m_readPos;
+    }
+    if (iMillis == 0 || IsEndOfInput() || avail >= iMinAvail)
+      return avail;
+
+    if (!m_dataAvail.WaitMSec(endTime.MillisLeft()))
+      return CACHE_RC_TIMEOUT;
+  }
+}
+
+int64_t CPersistentFileCache::Seek(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+
+  /* Only positions connected to the data that is currently being written can
+   * be served directly, anything else needs a seek event so the source gets
+   * repositioned by Reset()
+   */
+  const bool connected = iFilePosition <= m_writePos ? GetRunEnd(iFilePosition) >= m_writePos
+                                                     : GetRunEnd(m_writePos) >= iFilePosition;
+  if (!connected)
+    return CACHE_RC_ERROR;
+
+  m_readPos = iFilePosition;
+  return iFilePosition;
+}
+
+bool CPersistentFileCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  // completed blocks stay valid, so even a full reset keeps them
+  const bool cached = !clearAnyway && IsCachedPosition(iSourcePosition);
+
+  m_readPos = iSourcePosition;
+  m_segmentStart = iSourcePosition;
+  m_writePos = GetRunEnd(iSourcePosition);
+
+  return !cached;
+}
+
+void CPersistentFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_dataAvail.Set();
+}
+
+int64_t CPersistentFileCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return GetRunEnd(iFilePosition);
+}
+
+int64_t CPersistentFileCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_writePos;
+}
+
+bool CPersistentFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return iFilePosition == m_writePos || IsValid(iFilePosition);
+}
+
+void CPersistentFileCache::GetHitStats(uint64_t& hits, uint64_t& misses, uint64_t& hitBytes)
+{
+  CSingleLock lock(m_sync);
+  hits = m_hits;
+  misses = m_misses;
+  hitBytes = m_hitBytes;
+}
+
+CCacheStrategy *CPersistentFileCache::CreateNew()
+{
+  return new CPersistentFileCache(m_url, m_fileSize, m_mtime, m_maxCacheSize, m_folder);
+}
+
+uint64_t CPersistentFileCache::Evict(const std::string& folder, uint64_t targetSize)
+{
+  struct Entry
+  {
+    std::string key;
+    int64_t lastAccess;
+    uint64_t size;
+    bool hasIndex;
+  };
+
+  CFileItemList items;
+  if (!CDirectory::GetDirectory(folder, items, ".idx|.cache",
+                                DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE | DIR_FLAG_NO_FILE_INFO))
+  {
+    CSingleLock lock(m_globalSync);
+    return m_cacheSizes[folder];
+  }
+
+  std::map<std::string, Entry> found;
+  for (const auto& item : items)
+  {
+    const std::string key = URIUtils::GetFileName(URIUtils::ReplaceExtension(item->GetPath(), ""));
+    Entry& entry = found.emplace(key, Entry{key, -1, 0, false}).first->second;
+    if (!URIUtils::HasExtension(item->GetPath(), ".idx"))
+      continue;
+
+    IndexHeader header;
+    entry.hasIndex = true;
+    if (ReadIndexHeader(item->GetPath(), header))
+    {
+      entry.lastAccess = header.lastAccess;
+      entry.size = header.cachedBytes;
+    }
+    else
+      entry.lastAccess = 0; // broken entry, evict first
+  }
+
+  // data files without index (left by a crash or a failed open) sort first
+  std::vector<Entry> entries;
+  for (const auto& it : found)
+    entries.push_back(it.second);
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.lastAccess < b.lastAccess; });
+
+  uint64_t evictedBytes = 0;
+  unsigned int evictedFiles = 0;
+  CSingleLock lock(m_globalSync);
+
+  // open entries are counted with their current size, not the one of their index
+  uint64_t total = 0;
+  for (const auto& entry : m_openEntries)
+  {
+    if (StringUtils::StartsWith(entry.first, folder))
+      total += entry.second;
+  }
+  for (const auto& entry : entries)
+  {
+    if (m_openEntries.find(folder + entry.key) == m_openEntries.end())
+      total += entry.size;
+  }
+
+  for (const auto& entry : entries)
+  {
+    if (entry.hasIndex && total <= targetSize)
+      break;
+    if (m_openEntries.find(folder + entry.key) != m_openEntries.end())
+      continue;
+
+    const std::string indexFile = URIUtils::AddFileToFolder(folder, entry.key + ".idx");
+    IndexHeader header;
+    if (!entry.hasIndex && ReadIndexHeader(indexFile, header))
+    {
+      // closed after the folder was listed
+      total += header.cachedBytes;
+      continue;
+    }
+
+    CFile::Delete(indexFile);
+    CFile::Delete(URIUtils::AddFileToFolder(folder, entry.key + ".cache"));
+    total -= entry.size;
+    evictedBytes += entry.size;
+    evictedFiles++;
+  }
+  m_cacheSizes[folder] = total;
+
+  CLog::Log(LOGDEBUG,
+            "CPersistentFileCache::Evict - cache size %" PRIu64 " bytes, evicted %u entries with %" PRIu64
+            " bytes",
+            total, evictedFiles, evictedBytes);
+  return total;
+}
@@ -0,0 +1,119 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+
+/*!
+ \brief Cache strategy that keeps downloaded data on disk across sessions.
+
+ Data is stored in fixed size blocks in a sparse file below
+ <cachepath>/blockcache/, together with an index of the completed blocks. The
+ cache entry is keyed by URL, file size and modification time, so reopening
+ the same remote file (library scan, thumbnail extraction, playback) only
+ fetches the blocks that were not read before. The total size of all entries
+ is kept below a budget by evicting the least recently used entries whenever
+ a completed block or a closed entry exceeds it. The cache folder is only
+ scanned on the first open and when the running size exceeds the budget. An
+ entry that doesn't fit even after evicting all others stops growing the
+ budgeted size and is deleted on close.
+ */
+class CPersistentFileCache : public CCacheStrategy
+{
+public:
+  /*!
+   \param cacheFolder folder of the cache entries, <cachepath>/blockcache/ if empty
+   */
+  CPersistentFileCache(const std::string& url,
+                       int64_t fileSize,
+                       int64_t mtime,
+                       uint64_t maxCacheSize,
+                       const std::string& cacheFolder = "");
+  ~CPersistentFileCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+  void EndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  void GetHitStats(uint64_t& hits, uint64_t& misses, uint64_t& hitBytes) override;
+
+  CCacheStrategy *CreateNew() override;
+
+private:
+  bool LoadIndex();
+  bool SaveIndex(uint64_t cachedBytes);
+  uint64_t GetCachedBytes() const;
+  int64_t GetRunEnd(int64_t iFilePosition) const;
+  bool IsValid(int64_t iFilePosition) const;
+  void AddCompletedBytes(uint64_t bytes);
+
+  /*!
+   \brief Delete the least recently used entries of a folder that aren't open
+   until their total size is at most targetSize, and data files without index.
+   \return the total size of the folder's entries afterwards
+   */
+  static uint64_t Evict(const std::string& folder, uint64_t targetSize);
+
+  std::string m_url;
+  int64_t m_fileSize;
+  int64_t m_mtime;
+  uint64_t m_maxCacheSize;
+  std::string m_folder;
+
+  std::string m_key;
+  std::string m_entry;           /**< path of the entry without extension */
+  std::string m_dataFile;
+  std::string m_indexFile;
+  IFile* m_cacheFileRead;
+  IFile* m_cacheFileWrite;
+  bool m_opened = false;
+  bool m_discard = false;        /**< entry exceeds the budget on its own, deleted on close */
+
+  std::vector<bool> m_blocks;    /**< completed blocks */
+  std::vector<bool> m_persisted; /**< blocks that were completed when the entry was opened */
+  int64_t m_segmentStart = 0;    /**< start of the range written in this session */
+  int64_t m_writePos = 0;
+  int64_t m_readPos = 0;
+  uint64_t m_openedBytes = 0;    /**< cached bytes of the entry when it was opened */
+  uint64_t m_hits = 0;           /**< reads served from blocks cached by an earlier session */
+  uint64_t m_misses = 0;         /**< reads that needed data fetched from the source */
+  uint64_t m_hitBytes = 0;       /**< bytes read from blocks cached by an earlier session */
+  uint64_t m_missBytes = 0;      /**< bytes that had to be fetched from the source */
+
+  mutable CCriticalSection m_sync;
+  CEvent m_dataAvail;
+
+  static CCriticalSection m_globalSync;
+  static std::map<std::string, uint64_t> m_openEntries; /**< cached bytes of each open entry */
+  static std::map<std::string, uint64_t> m_cacheSizes; /**< running size of each cache folder */
+};
+
+}
@@ -73,7 +73,12 @@ bool CZipFile::Open(const CURL&url)
     return false;
   }
   mFile.Seek(mZipItem.offset,SEEK_SET);
-  return InitDecompress();
+  if (!InitDecompress())
+    return false;
+
+  if (mZipItem.method == 8 && mZipItem.usize > CInflateIndex::MIN_SPAN)
+    m_inflateIndex = g_ZipManager.GetInflateIndex(url2, mZipItem);
+  return true;
 }
 
 bool CZipFile::InitDecompress()
@@ -101,6 +106,75 @@ bool CZipFile::InitDecompress()
   return true;
 }
 
+int CZipFile::Inflate(int flush)
+{
+  // inflate stops at the end of every block with Z_BLOCK, which is where checkpoints
+  // can be taken. Keep going as long as there is input and room for output.
+  int iMessage;
+  do
+  {
+    iMessage = inflate(&m_ZStream, flush);
+    if (iMessage == Z_OK && m_inflateIndex)
+      AddCheckpoint();
+  } while (flush == Z_BLOCK && iMessage == Z_OK && m_ZStream.avail_in > 0 && m_ZStream.avail_out > 0);
+
+  return iMessage;
+}
+
+void CZipFile::AddCheckpoint()
+{
+  // only the end of a block that isn't the last one is a valid checkpoint
+  if (!(m_ZStream.data_type & 128) || (m_ZStream.data_type & 64))
+    return;
+
+  const int64_t out = static_cast<int64_t>(m_ZStream.total_out);
+  if (!m_inflateIndex->NeedsCheckpoint(out))
+    return;
+
+  SInflateCheckpoint point;
+  point.out = out;
+  point.in = m_iZipFilePos - m_ZStream.avail_in;
+  point.bits = m_ZStream.data_type & 7;
+  point.window.resize(1 << MAX_WBITS);
+  uInt windowSize = static_cast<uInt>(point.window.size());
+  if (inflateGetDictionary(&m_ZStream, point.window.data(), &windowSize) != Z_OK)
+    return;
+  point.window.resize(windowSize);
+
+  m_inflateIndex->Add(std::move(point));
+}
+
+bool CZipFile::RestoreCheckpoint(const SInflateCheckpoint& point)
+{
+  inflateEnd(&m_ZStream);
+  if (inflateInit2(&m_ZStream, -MAX_WBITS) != Z_OK)
+    return false;
+
+  // the checkpoint may start in the middle of a byte, feed its remaining bits first
+  m_iZipFilePos = point.in - (point.bits ? 1 : 0);
+  if (mFile.Seek(mZipItem.offset + m_iZipFilePos, SEEK_SET) < 0)
+    return false;
+
+  if (point.bits)
+  {
+    unsigned char byte;
+    if (mFile.Read(&byte, 1) != 1)
+      return false;
+    m_iZipFilePos++;
+    inflatePrime(&m_ZStream, point.bits, byte >> (8 - point.bits));
+  }
+
+  if (inflateSetDictionary(&m_ZStream, point.window.data(), static_cast<uInt>(point.window.size())) != Z_OK)
+    return false;
+
+  m_ZStream.next_in = (Bytef*)m_szBuffer;
+  m_ZStream.avail_in = 0;
+  m_ZStream.total_out = static_cast<uLong>(point.out);
+  m_iFilePos = point.out;
+  m_bFlush = false;
+  return true;
+}
+
 int64_t CZipFile::GetLength()
 {
   return mZipItem.usize;
@@ -166,6 +240,18 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
         return m_iFilePos; // mp3reader does this lots-of-times
       if (iFilePosition > mZipItem.usize || iFilePosition < 0)
         return -1;
+      // resume from the nearest checkpoint if that's closer than where we are
+      if (m_inflateIndex)
+      {
+        SInflateCheckpoint point;
+        if (m_inflateIndex->Find(iFilePosition, point) &&
+            (iFilePosition < m_iFilePos || point.out > m_iFilePos))
+        {
+          if (!RestoreCheckpoint(point))
+            return -1;
+          return Seek(iFilePosition - m_iFilePos, SEEK_CUR);
+        }
+      }
       // read until position in 128k blocks.. only way to do it due to format.
       // can't start in the middle of data since then we'd have no clue where
       // we are in uncompressed data..
@@ -197,6 +283,13 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
       // read until requested position, drop data
       if (m_iFilePos+iFilePosition > mZipItem.usize)
         return -1;
+      // skip ahead through a checkpoint, without one there's nothing to do but inflate
+      if (m_inflateIndex && iFilePosition > m_inflateIndex->GetSpan())
+      {
+        SInflateCheckpoint point;
+        if (m_inflateIndex->Find(m_iFilePos + iFilePosition, point) && point.out > m_iFilePos)
+          return Seek(m_iFilePos + iFilePosition, SEEK_SET);
+      }
       iFilePosition += m_iFilePos;
       while (m_iFilePos < iFilePosition)
       {
@@ -300,7 +393,7 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
       m_ZStream.avail_out = static_cast<uInt>(uiBufSize-iDecompressed);
       if (m_bFlush) // need to flush buffer !
       {
-        int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
+        int iMessage = Inflate(Z_BLOCK);
         m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false;
         if (!m_ZStream.avail_out) // flush filled buffer, get out of here
         {
@@ -318,7 +411,7 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
         }
       }
 
-      int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
+      int iMessage = Inflate(Z_BLOCK);
       if (iMessage < 0)
       {
         Close();
@@ -356,6 +449,7 @@ void CZipFile::Close()
   if (mZipItem.method == 8 && !m_bCached && m_iRead != -1)
     inflateEnd(&m_ZStream);
 
+  m_inflateIndex.reset();
   mFile.Close();
 }
 
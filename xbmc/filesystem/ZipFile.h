@@ -12,6 +12,8 @@
 #include "IFile.h"
 #include "ZipManager.h"
 
+#include <memory>
+
 #include <zlib.h>
 
 namespace XFILE
@@ -41,10 +43,14 @@ namespace XFILE
 
   private:
     bool InitDecompress();
+    int Inflate(int flush);
+    void AddCheckpoint();
+    bool RestoreCheckpoint(const SInflateCheckpoint& point);
     bool FillBuffer();
     void DestroyBuffer(void* lpBuffer, int iBufSize);
     CFile mFile;
     SZipEntry mZipItem;
+    std::shared_ptr<CInflateIndex> m_inflateIndex; // checkpoints of large deflated entries
     int64_t m_iFilePos = 0; // position in _uncompressed_ data read
     int64_t m_iZipFilePos = 0; // position in _compressed_ data
     int m_iAvailBuffer = 0;
@@ -9,23 +9,94 @@
 #include "ZipManager.h"
 
 #include <algorithm>
+#include <type_traits>
 #include <utility>
 
+#include "Directory.h"
 #include "File.h"
 #include "URL.h"
 #if defined(TARGET_POSIX)
 #include "PlatformDefs.h"
 #endif
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
+#include "utils/Digest.h"
 #include "utils/EndianSwap.h"
 #include "utils/log.h"
 #include "utils/RegExp.h"
 #include "utils/URIUtils.h"
 
 using namespace XFILE;
+using KODI::UTILITY::CDigest;
 
 static const size_t ZC_FLAG_EFS = 1 << 11; // general purpose bit 11 - zip holds utf-8 filenames
 
+// memory for the windows of the inflate checkpoints of all entries
+static const size_t MAX_INFLATE_INDEX_MEMORY = 8 * 1024 * 1024;
+
+// persisted central directories
+static const std::string INDEX_FOLDER = "special://temp/archivecache/";
+static const uint32_t INDEX_MAGIC = 0x5a494458; // "ZIDX"
+static const uint32_t INDEX_VERSION = 1;
+
+namespace
+{
+struct SIndexHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entrySize;
+  uint32_t count;
+  int64_t mtime;
+  int64_t size;
+};
+
+static_assert(std::is_trivially_copyable<SZipEntry>::value, "SZipEntry is stored as is in the index");
+} // namespace
+
+const int64_t CInflateIndex::MIN_SPAN;
+const int64_t CInflateIndex::MAX_CHECKPOINTS;
+
+CInflateIndex::CInflateIndex(int64_t size)
+  : m_span(std::max(MIN_SPAN, (size + MAX_CHECKPOINTS - 1) / MAX_CHECKPOINTS))
+{
+}
+
+bool CInflateIndex::Find(int64_t position, SInflateCheckpoint& point) const
+{
+  CSingleLock lock(m_lock);
+  auto it = std::upper_bound(m_points.begin(), m_points.end(), position,
+                             [](int64_t pos, const SInflateCheckpoint& p) { return pos < p.out; });
+  if (it == m_points.begin())
+    return false;
+
+  point = *(--it);
+  return true;
+}
+
+bool CInflateIndex::NeedsCheckpoint(int64_t position) const
+{
+  CSingleLock lock(m_lock);
+  return position >= (m_points.empty() ? 0 : m_points.back().out) + m_span;
+}
+
+void CInflateIndex::Add(SInflateCheckpoint&& point)
+{
+  CSingleLock lock(m_lock);
+  // another reader of the entry may have been faster
+  if (point.out >= (m_points.empty() ? 0 : m_points.back().out) + m_span)
+  {
+    m_memoryUsage += point.window.size();
+    m_points.push_back(std::move(point));
+  }
+}
+
+size_t CInflateIndex::GetMemoryUsage() const
+{
+  CSingleLock lock(m_lock);
+  return m_memoryUsage;
+}
+
 CZipManager::CZipManager() = default;
 
 CZipManager::~CZipManager() = default;
@@ -42,20 +113,44 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
     return false;
   }
 
-  std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  if (it != mZipMap.end()) // already listed, just return it if not changed, else release and reread
   {
-    std::map<std::string,int64_t>::iterator it2=mZipDate.find(strFile);
-
-    if (m_StatData.st_mtime == it2->second)
+    CSingleLock lock(m_lock);
+    auto it = mZipMap.find(strFile);
+    if (it != mZipMap.end()) // already listed, just return it if not changed, else release and reread
     {
-      items = it->second;
-      return true;
+      if (m_StatData.st_mtime == it->second.mtime)
+      {
+        items = it->second.items;
+        return true;
+      }
+      mZipMap.erase(it);
     }
-    mZipMap.erase(it);
-    mZipDate.erase(it2);
   }
 
+  items.clear();
+  if (!LoadIndex(strFile, m_StatData.st_mtime, m_StatData.st_size, items))
+  {
+    if (!ReadCentralDirectory(strFile, items))
+      return false;
+
+    // reading the local headers takes a seek per entry, worth avoiding for remote archives
+    if (URIUtils::IsRemote(strFile))
+      SaveIndex(strFile, m_StatData.st_mtime, m_StatData.st_size, items);
+  }
+
+  SZipArchive archive;
+  archive.mtime = m_StatData.st_mtime;
+  archive.items = items;
+  for (size_t i = 0; i < items.size(); i++)
+    archive.names.emplace(items[i].name, i);
+
+  CSingleLock lock(m_lock);
+  mZipMap[strFile] = std::move(archive);
+  return true;
+}
+
+bool CZipManager::ReadCentralDirectory(const std::string& strFile, std::vector<SZipEntry>& items)
+{
   CFile mFile;
   if (!mFile.Open(strFile))
   {
@@ -76,10 +171,6 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
   if (Endian_SwapLE32(hdr) == ZIP_SPLIT_ARCHIVE_HEADER)
     CLog::LogF(LOGWARNING, "ZIP split archive header found. Trying to process as a single archive..");
 
-  // push date for update detection
-  mZipDate.insert(make_pair(strFile,m_StatData.st_mtime));
-
-
   // Look for end of central directory record
   // Zipfile comment may be up to 65535 bytes
   // End of central directory record is 22 bytes (ECDREC_SIZE)
@@ -212,27 +303,92 @@ bool CZipManager::GetZipList(const CURL& url, std::vector<SZipEntry>& items)
 
   }
 
-  mZipMap.insert(make_pair(strFile,items));
   mFile.Close();
   return true;
 }
 
-bool CZipManager::GetZipEntry(const CURL& url, SZipEntry& item)
+std::string CZipManager::GetIndexPath(const std::string& strFile)
 {
-  std::string strFile = url.GetHostName();
+  return INDEX_FOLDER + CDigest::Calculate(CDigest::Type::MD5, strFile) + ".idx";
+}
 
-  std::map<std::string, std::vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  std::vector<SZipEntry> items;
-  if (it == mZipMap.end()) // we need to list the zip
+bool CZipManager::LoadIndex(const std::string& strFile, int64_t mtime, int64_t size, std::vector<SZipEntry>& items)
+{
+  const std::string indexPath = GetIndexPath(strFile);
+  CFile file;
+  if (!CFile::Exists(indexPath) || !file.Open(indexPath))
+    return false;
+
+  SIndexHeader header;
+  if (file.Read(&header, sizeof(header)) != sizeof(header) ||
+      header.magic != INDEX_MAGIC || header.version != INDEX_VERSION ||
+      header.entrySize != sizeof(SZipEntry) ||
+      header.mtime != mtime || header.size != size ||
+      header.count > (file.GetLength() - sizeof(header)) / sizeof(SZipEntry))
+    return false;
+
+  std::vector<SZipEntry> entries(header.count);
+  const ssize_t length = static_cast<ssize_t>(header.count * sizeof(SZipEntry));
+  if (header.count > 0 && file.Read(entries.data(), length) != length)
+    return false;
+
+  items = std::move(entries);
+  CLog::Log(LOGDEBUG, "CZipManager::LoadIndex - loaded %u entries of %s", header.count,
+            CURL::GetRedacted(strFile).c_str());
+  return true;
+}
+
+void CZipManager::SaveIndex(const std::string& strFile, int64_t mtime, int64_t size, const std::vector<SZipEntry>& items)
+{
+  if (!CDirectory::Exists(INDEX_FOLDER) && !CDirectory::Create(INDEX_FOLDER))
+    return;
+
+  SIndexHeader header;
+  header.magic = INDEX_MAGIC;
+  header.version = INDEX_VERSION;
+  header.entrySize = sizeof(SZipEntry);
+  header.count = static_cast<uint32_t>(items.size());
+  header.mtime = mtime;
+  header.size = size;
+
+  const std::string indexPath = GetIndexPath(strFile);
+  CFile file;
+  if (!file.OpenForWrite(indexPath, true))
+    return;
+
+  const ssize_t length = static_cast<ssize_t>(items.size() * sizeof(SZipEntry));
+  if (file.Write(&header, sizeof(header)) != sizeof(header) ||
+      (length > 0 && file.Write(items.data(), length) != length))
   {
-    GetZipList(url,items);
+    file.Close();
+    CFile::Delete(indexPath);
   }
-  else
+}
+
+bool CZipManager::GetZipEntry(const CURL& url, SZipEntry& item)
+{
+  std::string strFile = url.GetHostName();
+  std::string strFileName = url.GetFileName();
+
   {
-    items = it->second;
+    CSingleLock lock(m_lock);
+    auto it = mZipMap.find(strFile);
+    if (it != mZipMap.end())
+    {
+      auto name = it->second.names.find(strFileName);
+      if (name == it->second.names.end())
+        return false;
+
+      item = it->second.items[name->second];
+      return true;
+    }
   }
 
-  std::string strFileName = url.GetFileName();
+  // we need to list the zip
+  std::vector<SZipEntry> items;
+  if (!GetZipList(url, items))
+    return false;
+
   for (const auto& it2 : items)
   {
     if (std::string(it2.name) == strFileName)
@@ -244,6 +400,35 @@ bool CZipManager::GetZipEntry(const CURL& url, SZipEntry& item)
   return false;
 }
 
+std::shared_ptr<CInflateIndex> CZipManager::GetInflateIndex(const CURL& url, const SZipEntry& item)
+{
+  // the crc changes with the content of the entry
+  const std::string key = url.GetHostName() + "|" + item.name + "|" + std::to_string(item.crc32);
+
+  CSingleLock lock(m_lock);
+  auto it = std::find_if(mInflateIndexes.begin(), mInflateIndexes.end(),
+                         [&key](const std::pair<std::string, std::shared_ptr<CInflateIndex>>& index)
+                         { return index.first == key; });
+  if (it != mInflateIndexes.end())
+    mInflateIndexes.splice(mInflateIndexes.begin(), mInflateIndexes, it);
+  else // C++14 - Replace with std::make_shared
+    mInflateIndexes.emplace_front(key, std::shared_ptr<CInflateIndex>(new CInflateIndex(item.usize)));
+
+  // drop the least recently used indexes that don't fit, readers still holding one keep it alive
+  size_t memoryUsage = 0;
+  for (auto index = mInflateIndexes.begin(); index != mInflateIndexes.end(); ++index)
+  {
+    memoryUsage += index->second->GetMemoryUsage();
+    if (memoryUsage > MAX_INFLATE_INDEX_MEMORY && index != mInflateIndexes.begin())
+    {
+      mInflateIndexes.erase(index, mInflateIndexes.end());
+      break;
+    }
+  }
+
+  return mInflateIndexes.front().second;
+}
+
 bool CZipManager::ExtractArchive(const std::string& strArchive, const std::string& strPath)
 {
   const CURL pathToUrl(strArchive);
@@ -309,13 +494,8 @@ void CZipManager::readCHeader(const char* buffer, SZipEntry& info)
 void CZipManager::release(const std::string& strPath)
 {
   CURL url(strPath);
-  std::map<std::string, std::vector<SZipEntry> >::iterator it= mZipMap.find(url.GetHostName());
-  if (it != mZipMap.end())
-  {
-    std::map<std::string,int64_t>::iterator it2=mZipDate.find(url.GetHostName());
-    mZipMap.erase(it);
-    mZipDate.erase(it2);
-  }
+  CSingleLock lock(m_lock);
+  mZipMap.erase(url.GetHostName());
 }
 
 
@@ -19,9 +19,14 @@
 #define CHDR_SIZE 46
 #define ECDREC_SIZE 22
 
+#include "threads/CriticalSection.h"
+
+#include <list>
+#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
-#include <map>
 
 class CURL;
 
@@ -51,6 +56,54 @@ struct SZipEntry {
   }
 };
 
+/*!
+ \brief Point in a deflated entry where inflating can be restarted.
+
+ Besides the positions in the compressed and uncompressed data, restarting
+ needs the bits of the last compressed byte that belong to the next block and
+ the last 32 KiB of output, which is the dictionary for the data that follows.
+ */
+struct SInflateCheckpoint
+{
+  int64_t out = 0; // position in the uncompressed data
+  int64_t in = 0;  // compressed bytes consumed, relative to the start of the entry data
+  int bits = 0;    // number of unused bits in the byte before in
+  std::vector<unsigned char> window;
+};
+
+/*!
+ \brief Checkpoints of a deflated entry, shared by all readers of the entry.
+
+ Checkpoints are recorded while the entry is read, roughly every span bytes of
+ uncompressed data, so seeking only has to inflate from the nearest one. The
+ span grows with the entry so it never has more than MAX_CHECKPOINTS windows.
+ */
+class CInflateIndex
+{
+public:
+  static const int64_t MIN_SPAN = 256 * 1024;
+  static const int64_t MAX_CHECKPOINTS = 64;
+
+  /*!
+   \param size uncompressed size of the entry
+   */
+  explicit CInflateIndex(int64_t size);
+
+  bool Find(int64_t position, SInflateCheckpoint& point) const;
+  bool NeedsCheckpoint(int64_t position) const;
+  void Add(SInflateCheckpoint&& point);
+
+  int64_t GetSpan() const { return m_span; }
+  /*! \brief Bytes used by the windows of the checkpoints */
+  size_t GetMemoryUsage() const;
+
+private:
+  const int64_t m_span;
+  mutable CCriticalSection m_lock;
+  std::vector<SInflateCheckpoint> m_points;
+  size_t m_memoryUsage = 0;
+};
+
 class CZipManager
 {
 public:
@@ -59,14 +112,28 @@ public:
 
   bool GetZipList(const CURL& url, std::vector<SZipEntry>& items);
   bool GetZipEntry(const CURL& url, SZipEntry& item);
+  std::shared_ptr<CInflateIndex> GetInflateIndex(const CURL& url, const SZipEntry& item);
   bool ExtractArchive(const std::string& strArchive, const std::string& strPath);
   bool ExtractArchive(const CURL& archive, const std::string& strPath);
   void release(const std::string& strPath); // release resources used by list zip
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
 private:
-  std::map<std::string,std::vector<SZipEntry> > mZipMap;
-  std::map<std::string,int64_t> mZipDate;
+  struct SZipArchive
+  {
+    int64_t mtime = 0;
+    std::vector<SZipEntry> items;
+    std::unordered_map<std::string, size_t> names; // index of the entries in items
+  };
+
+  bool ReadCentralDirectory(const std::string& strFile, std::vector<SZipEntry>& items);
+  static std::string GetIndexPath(const std::string& strFile);
+  static bool LoadIndex(const std::string& strFile, int64_t mtime, int64_t size, std::vector<SZipEntry>& items);
+  static void SaveIndex(const std::string& strFile, int64_t mtime, int64_t size, const std::vector<SZipEntry>& items);
+
+  CCriticalSection m_lock;
+  std::map<std::string, SZipArchive> mZipMap;
+  std::list<std::pair<std::string, std::shared_ptr<CInflateIndex>>> mInflateIndexes; // most recently used first
 };
 
 extern CZipManager g_ZipManager;
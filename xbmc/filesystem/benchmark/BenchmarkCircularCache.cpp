@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/CircularCache.h"
+#include "filesystem/LockFreeCircularCache.h"
+#include "test/Benchmark.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr size_t FRONT_SIZE = 3 * 1024 * 1024;
+constexpr size_t BACK_SIZE = 1024 * 1024;
+constexpr size_t WRITE_SIZE = 128 * 1024;
+
+/*!
+ \brief Hand over size bytes from a producer to a consumer thread through the
+ cache, like CFileCache's fill thread and a demuxer do.
+
+ \return false if the cache failed, true otherwise
+ */
+bool Handover(CCacheStrategy& cache, int64_t size, size_t readSize, CBenchmark::CStage& write,
+              CBenchmark::CStage& read)
+{
+  if (cache.Open() != CACHE_RC_OK)
+    return false;
+
+  bool writeFailed = false;
+  std::thread writer([&]() {
+    std::vector<char> in(WRITE_SIZE, 'k');
+    int64_t pos = 0;
+    while (pos < size)
+    {
+      write.Begin();
+      const int ret = cache.WriteToCache(in.data(), in.size());
+      write.End();
+      if (ret < 0)
+      {
+        writeFailed = true;
+        break;
+      }
+      if (ret == 0)
+        cache.m_space.WaitMSec(5);
+      pos += ret;
+    }
+    cache.EndOfInput();
+  });
+
+  std::vector<char> out(readSize);
+  int64_t pos = 0;
+  while (true)
+  {
+    read.Begin();
+    const int ret = cache.ReadFromCache(out.data(), out.size());
+    read.End();
+    if (ret == CACHE_RC_WOULD_BLOCK)
+    {
+      cache.WaitForData(1, 10000);
+      continue;
+    }
+    if (ret <= 0)
+      break;
+    pos += ret;
+  }
+  writer.join();
+  cache.Close();
+
+  return !writeFailed && pos == size;
+}
+
+/*!
+ \brief Throughput of the locking and the lock-free circular cache, the two
+ threads only copy data so the handover between them dominates.
+ */
+int CircularCache(const std::vector<std::string>& args)
+{
+  int64_t megabytes = 1024;
+  size_t readSize = 32 * 1024;
+  if (!args.empty())
+    megabytes = std::strtoll(args[0].c_str(), nullptr, 10);
+  if (args.size() > 1)
+    readSize = std::strtoul(args[1].c_str(), nullptr, 10);
+  if (megabytes <= 0 || readSize == 0)
+  {
+    fprintf(stderr, "circularcache: invalid size or read size\n");
+    return 1;
+  }
+
+  const int64_t size = megabytes * 1024 * 1024;
+  printf("size: %" PRId64 " MiB, write size: %zu, read size: %zu\n\n", megabytes, WRITE_SIZE,
+         readSize);
+
+  struct SCache
+  {
+    const char* name;
+    std::unique_ptr<CCacheStrategy> cache;
+  };
+  SCache caches[] = {
+      {"CCircularCache", std::unique_ptr<CCacheStrategy>(new CCircularCache(FRONT_SIZE, BACK_SIZE))},
+      {"CLockFreeCircularCache",
+       std::unique_ptr<CCacheStrategy>(new CLockFreeCircularCache(FRONT_SIZE, BACK_SIZE))}};
+
+  for (SCache& cache : caches)
+  {
+    CBenchmark::CStage write("write");
+    CBenchmark::CStage read("read");
+
+    const auto start = std::chrono::steady_clock::now();
+    if (!Handover(*cache.cache, size, readSize, write, read))
+    {
+      fprintf(stderr, "circularcache: %s failed\n", cache.name);
+      return 1;
+    }
+    const double wall =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("cache: %s, %.1f MB/s\n", cache.name, wall > 0 ? size / wall / 1000000.0 : 0.0);
+    CBenchmark::PrintStages({&write, &read});
+    printf("\n");
+  }
+
+  return 0;
+}
+} // namespace
+
+BENCHMARK_REGISTER("circularcache", "[megabytes] [read size]", CircularCache);
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/CacheStrategy.h"
+#include "filesystem/CircularCache.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr size_t SEGMENT_SIZE = 64 * 1024;
+
+void FillSegment(CCacheStrategy& cache, int64_t pos, size_t size)
+{
+  std::vector<char> buf(size, static_cast<char>(pos / SEGMENT_SIZE));
+  ASSERT_FALSE(cache.IsCachedPosition(pos));
+  cache.Reset(pos, false);
+  ASSERT_EQ(static_cast<int>(size), cache.WriteToCache(buf.data(), buf.size()));
+}
+} // namespace
+
+TEST(TestSegmentedCache, KeepsSegments)
+{
+  CSegmentedCache cache(new CCircularCache(SEGMENT_SIZE, 0), 3);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  ASSERT_EQ(static_cast<int>(SEGMENT_SIZE / 2),
+            cache.WriteToCache(std::vector<char>(SEGMENT_SIZE / 2).data(), SEGMENT_SIZE / 2));
+  FillSegment(cache, 10 * SEGMENT_SIZE, SEGMENT_SIZE / 2);
+  FillSegment(cache, 20 * SEGMENT_SIZE, SEGMENT_SIZE / 2);
+
+  EXPECT_TRUE(cache.IsCachedPosition(0));
+  EXPECT_TRUE(cache.IsCachedPosition(10 * SEGMENT_SIZE));
+  EXPECT_TRUE(cache.IsCachedPosition(20 * SEGMENT_SIZE));
+  EXPECT_FALSE(cache.IsCachedPosition(30 * SEGMENT_SIZE));
+
+  // inactive segment: seek must go through Reset so the segment gets activated
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(10 * SEGMENT_SIZE));
+  EXPECT_EQ(static_cast<int64_t>(10 * SEGMENT_SIZE + SEGMENT_SIZE / 2),
+            cache.CachedDataEndPosIfSeekTo(10 * SEGMENT_SIZE));
+  EXPECT_FALSE(cache.Reset(10 * SEGMENT_SIZE, false));
+  EXPECT_EQ(static_cast<int64_t>(10 * SEGMENT_SIZE + SEGMENT_SIZE / 2), cache.CachedDataEndPos());
+
+  char c;
+  ASSERT_EQ(1, cache.ReadFromCache(&c, 1));
+  EXPECT_EQ(10, c);
+}
+
+TEST(TestSegmentedCache, EvictsLeastRecentlyUsed)
+{
+  CSegmentedCache cache(new CCircularCache(SEGMENT_SIZE, 0), 3);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  ASSERT_EQ(static_cast<int>(SEGMENT_SIZE / 2),
+            cache.WriteToCache(std::vector<char>(SEGMENT_SIZE / 2).data(), SEGMENT_SIZE / 2));
+  FillSegment(cache, 10 * SEGMENT_SIZE, SEGMENT_SIZE / 2);
+  FillSegment(cache, 20 * SEGMENT_SIZE, SEGMENT_SIZE / 2);
+
+  // touch the first segment, so the one at 10 becomes the least recently used
+  EXPECT_FALSE(cache.Reset(0, false));
+
+  FillSegment(cache, 30 * SEGMENT_SIZE, SEGMENT_SIZE / 2);
+  EXPECT_TRUE(cache.IsCachedPosition(0));
+  EXPECT_FALSE(cache.IsCachedPosition(10 * SEGMENT_SIZE));
+  EXPECT_TRUE(cache.IsCachedPosition(20 * SEGMENT_SIZE));
+  EXPECT_TRUE(cache.IsCachedPosition(30 * SEGMENT_SIZE));
+}
@@ -0,0 +1,171 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/CircularCache.h"
+#include "filesystem/LockFreeCircularCache.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+constexpr size_t FRONT_SIZE = 3 * 1024 * 1024;
+constexpr size_t BACK_SIZE = 1024 * 1024;
+constexpr size_t CHUNK_SIZE = 128 * 1024;
+
+uint8_t PatternAt(int64_t pos)
+{
+  return static_cast<uint8_t>((pos * 7) ^ (pos >> 11));
+}
+
+void FillPattern(std::vector<char>& buf, int64_t pos)
+{
+  for (size_t i = 0; i < buf.size(); i++)
+    buf[i] = static_cast<char>(PatternAt(pos + i));
+}
+} // namespace
+
+template<typename T>
+class TestCircularCache : public ::testing::Test
+{
+protected:
+  TestCircularCache() : m_cache(new T(FRONT_SIZE, BACK_SIZE))
+  {
+    EXPECT_EQ(CACHE_RC_OK, m_cache->Open());
+  }
+
+  std::unique_ptr<CCacheStrategy> m_cache;
+};
+
+typedef ::testing::Types<CCircularCache, CLockFreeCircularCache> CircularCacheTypes;
+TYPED_TEST_CASE(TestCircularCache, CircularCacheTypes);
+
+TYPED_TEST(TestCircularCache, WriteRead)
+{
+  std::vector<char> in(CHUNK_SIZE);
+  std::vector<char> out(CHUNK_SIZE);
+  FillPattern(in, 0);
+
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, this->m_cache->ReadFromCache(out.data(), out.size()));
+  EXPECT_EQ(CHUNK_SIZE, this->m_cache->GetMaxWriteSize(CHUNK_SIZE));
+  EXPECT_EQ(static_cast<int>(CHUNK_SIZE), this->m_cache->WriteToCache(in.data(), in.size()));
+  EXPECT_EQ(static_cast<int64_t>(CHUNK_SIZE), this->m_cache->WaitForData(0, 0));
+  EXPECT_EQ(static_cast<int>(CHUNK_SIZE), this->m_cache->ReadFromCache(out.data(), out.size()));
+  EXPECT_EQ(in, out);
+
+  this->m_cache->EndOfInput();
+  EXPECT_EQ(0, this->m_cache->ReadFromCache(out.data(), out.size()));
+}
+
+TYPED_TEST(TestCircularCache, FullCacheKeepsBackBuffer)
+{
+  std::vector<char> in(CHUNK_SIZE);
+  int64_t pos = 0;
+  while (this->m_cache->GetMaxWriteSize(CHUNK_SIZE) == CHUNK_SIZE)
+  {
+    FillPattern(in, pos);
+    ASSERT_EQ(static_cast<int>(CHUNK_SIZE), this->m_cache->WriteToCache(in.data(), in.size()));
+    pos += CHUNK_SIZE;
+  }
+  EXPECT_EQ(static_cast<int64_t>(FRONT_SIZE + BACK_SIZE), pos);
+  EXPECT_EQ(0, this->m_cache->WriteToCache(in.data(), in.size()));
+
+  // consume everything, then overwrite all but the guaranteed back buffer
+  std::vector<char> out(CHUNK_SIZE);
+  for (int64_t read = 0; read < pos; read += CHUNK_SIZE)
+    ASSERT_EQ(static_cast<int>(CHUNK_SIZE), this->m_cache->ReadFromCache(out.data(), out.size()));
+  for (size_t written = 0; written < FRONT_SIZE; written += CHUNK_SIZE)
+  {
+    FillPattern(in, pos);
+    ASSERT_EQ(static_cast<int>(CHUNK_SIZE), this->m_cache->WriteToCache(in.data(), in.size()));
+    pos += CHUNK_SIZE;
+  }
+
+  const int64_t backPos = pos - FRONT_SIZE - BACK_SIZE;
+  EXPECT_TRUE(this->m_cache->IsCachedPosition(backPos));
+  EXPECT_FALSE(this->m_cache->IsCachedPosition(backPos - 1));
+  EXPECT_EQ(backPos, this->m_cache->Seek(backPos));
+  EXPECT_EQ(CACHE_RC_ERROR, this->m_cache->Seek(backPos - 1));
+
+  ASSERT_EQ(static_cast<int>(CHUNK_SIZE), this->m_cache->ReadFromCache(out.data(), out.size()));
+  FillPattern(in, backPos);
+  EXPECT_EQ(in, out);
+}
+
+TYPED_TEST(TestCircularCache, Reset)
+{
+  std::vector<char> in(CHUNK_SIZE);
+  FillPattern(in, 0);
+  ASSERT_EQ(static_cast<int>(CHUNK_SIZE), this->m_cache->WriteToCache(in.data(), in.size()));
+
+  EXPECT_FALSE(this->m_cache->Reset(CHUNK_SIZE / 2, false));
+  EXPECT_EQ(static_cast<int64_t>(CHUNK_SIZE / 2), this->m_cache->WaitForData(0, 0));
+
+  EXPECT_TRUE(this->m_cache->Reset(10 * CHUNK_SIZE, false));
+  EXPECT_EQ(0, this->m_cache->WaitForData(0, 0));
+  EXPECT_EQ(static_cast<int64_t>(10 * CHUNK_SIZE), this->m_cache->CachedDataEndPos());
+}
+
+// A producer and a consumer thread handing over a large amount of data through
+// the cache, the same way CFileCache's fill thread and a demuxer do.
+TYPED_TEST(TestCircularCache, Handover)
+{
+  constexpr int64_t TOTAL_SIZE = 256 * 1024 * 1024;
+  constexpr size_t READ_SIZE = 32 * 1024;
+
+  std::thread writer([this]() {
+    std::vector<char> in(CHUNK_SIZE);
+    int64_t pos = 0;
+    while (pos < TOTAL_SIZE)
+    {
+      if (this->m_cache->GetMaxWriteSize(CHUNK_SIZE) < CHUNK_SIZE)
+      {
+        this->m_cache->m_space.WaitMSec(5);
+        continue;
+      }
+      in[0] = static_cast<char>(PatternAt(pos));
+      size_t written = 0;
+      while (written < CHUNK_SIZE)
+      {
+        int ret = this->m_cache->WriteToCache(in.data() + written, CHUNK_SIZE - written);
+        ASSERT_GE(ret, 0);
+        if (ret == 0)
+          this->m_cache->m_space.WaitMSec(5);
+        written += ret;
+      }
+      pos += CHUNK_SIZE;
+    }
+    this->m_cache->EndOfInput();
+  });
+
+  std::vector<char> out(READ_SIZE);
+  int64_t pos = 0;
+  while (true)
+  {
+    int ret = this->m_cache->ReadFromCache(out.data(), out.size());
+    if (ret == CACHE_RC_WOULD_BLOCK)
+    {
+      this->m_cache->WaitForData(1, 10000);
+      continue;
+    }
+    ASSERT_GE(ret, 0);
+    if (ret == 0)
+      break;
+    if (pos % CHUNK_SIZE == 0)
+      ASSERT_EQ(static_cast<char>(PatternAt(pos)), out[0]);
+    pos += ret;
+  }
+  writer.join();
+
+  EXPECT_EQ(TOTAL_SIZE, pos);
+}
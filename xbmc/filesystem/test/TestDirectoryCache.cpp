@@ -0,0 +1,121 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "filesystem/DirectoryCache.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+void FillItems(CFileItemList& items, const std::string& path, int count)
+{
+  for (int i = 0; i < count; i++)
+  {
+    CFileItemPtr item(new CFileItem(path + "file" + std::to_string(i) + ".mkv", false));
+    items.Add(item);
+  }
+}
+} // namespace
+
+TEST(TestDirectoryCache, SetGet)
+{
+  CDirectoryCache cache;
+  CFileItemList items;
+  FillItems(items, "smb://server/share/movies/", 10);
+
+  cache.SetDirectory("smb://server/share/movies/", items, DIR_CACHE_ONCE);
+
+  CFileItemList out;
+  EXPECT_FALSE(cache.GetDirectory("smb://server/share/movies/", out));
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share/movies", out, true));
+  EXPECT_EQ(10, out.Size());
+
+  bool inCache = false;
+  EXPECT_TRUE(cache.FileExists("smb://server/share/movies/file3.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists("smb://server/share/movies/missing.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists("smb://server/share/tv/file1.mkv", inCache));
+  EXPECT_FALSE(inCache);
+
+  cache.AddFile("smb://server/share/movies/added.mkv");
+  EXPECT_TRUE(cache.FileExists("smb://server/share/movies/added.mkv", inCache));
+
+  cache.ClearFile("smb://server/share/movies/file1.mkv");
+  EXPECT_FALSE(cache.GetDirectory("smb://server/share/movies/", out, true));
+}
+
+TEST(TestDirectoryCache, ClearSubPaths)
+{
+  CDirectoryCache cache;
+  // enough folders to end up in several shards
+  for (int i = 0; i < 64; i++)
+  {
+    const std::string path = "nfs://server/media/" + std::to_string(i) + "/";
+    CFileItemList items;
+    FillItems(items, path, 2);
+    cache.SetDirectory(path, items, DIR_CACHE_ALWAYS);
+  }
+  CFileItemList items;
+  FillItems(items, "nfs://other/media/", 2);
+  cache.SetDirectory("nfs://other/media/", items, DIR_CACHE_ALWAYS);
+
+  cache.ClearSubPaths("nfs://server/media/");
+
+  CFileItemList out;
+  for (int i = 0; i < 64; i++)
+    EXPECT_FALSE(cache.GetDirectory("nfs://server/media/" + std::to_string(i) + "/", out));
+  EXPECT_TRUE(cache.GetDirectory("nfs://other/media/", out));
+
+  cache.Clear();
+  EXPECT_FALSE(cache.GetDirectory("nfs://other/media/", out));
+}
+
+TEST(TestDirectoryCache, EvictUnderBudget)
+{
+  const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  const unsigned int budget = advancedSettings->m_directoryCacheMemSize;
+  advancedSettings->m_directoryCacheMemSize = 1024 * 1024;
+
+  // folders of roughly a tenth of the budget, so the cache holds several of them
+  // no matter which shards they end up in
+  const int itemsPerFolder = 1024 * 1024 / 10 / (sizeof(CFileItem) + 128);
+  const int numFolders = 30;
+
+  CDirectoryCache cache;
+  CFileItemList out;
+  for (int i = 0; i < numFolders; i++)
+  {
+    const std::string path = "smb://server/share/" + std::to_string(i) + "/";
+    CFileItemList items;
+    FillItems(items, path, itemsPerFolder);
+    cache.SetDirectory(path, items, DIR_CACHE_ONCE);
+
+    // keep the first folder in use
+    EXPECT_TRUE(cache.GetDirectory("smb://server/share/0/", out, true));
+  }
+
+  EXPECT_FALSE(cache.GetDirectory("smb://server/share/1/", out, true));
+  for (int i = numFolders - 5; i < numFolders; i++)
+    EXPECT_TRUE(cache.GetDirectory("smb://server/share/" + std::to_string(i) + "/", out, true));
+
+  // a single folder over budget is still cached
+  CFileItemList items;
+  FillItems(items, "smb://server/share/huge/", itemsPerFolder * 20);
+  cache.SetDirectory("smb://server/share/huge/", items, DIR_CACHE_ONCE);
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share/huge/", out, true));
+  EXPECT_FALSE(cache.GetDirectory("smb://server/share/0/", out, true));
+
+  advancedSettings->m_directoryCacheMemSize = budget;
+}
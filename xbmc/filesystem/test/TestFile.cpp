@@ -85,6 +85,42 @@ TEST(TestFile, Read)
   file.Close();
 }
 
+TEST(TestFile, ReadMapped)
+{
+  XFILE::CFile reference;
+  ASSERT_TRUE(reference.Open(XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt")));
+  const int64_t length = reference.GetLength();
+  std::string content(static_cast<size_t>(length), '\0');
+  ASSERT_EQ(length, reference.Read(&content[0], content.size()));
+  EXPECT_FALSE(reference.IsMapped());
+  EXPECT_EQ(nullptr, reference.GetSpan(0, 1));
+
+  XFILE::CFile file;
+  ASSERT_TRUE(file.Open(XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt"), XFILE::READ_MMAP));
+  ASSERT_TRUE(file.IsMapped());
+
+  // spans don't move the read position
+  const uint8_t* span = file.GetSpan(100, 20);
+  ASSERT_NE(nullptr, span);
+  EXPECT_EQ(0, memcmp(content.data() + 100, span, 20));
+  EXPECT_EQ(nullptr, file.GetSpan(length - 10, 20));
+  EXPECT_NE(nullptr, file.GetSpan(0, static_cast<size_t>(length)));
+  EXPECT_EQ(0, file.GetPosition());
+
+  char buf[23];
+  EXPECT_EQ(static_cast<ssize_t>(sizeof(buf)), file.Read(buf, sizeof(buf)));
+  EXPECT_EQ(0, memcmp(content.data(), buf, sizeof(buf)));
+  EXPECT_EQ(static_cast<int64_t>(sizeof(buf)) + 100, file.Seek(100, SEEK_CUR));
+  EXPECT_EQ(static_cast<ssize_t>(sizeof(buf)), file.Read(buf, sizeof(buf)));
+  EXPECT_EQ(0, memcmp(content.data() + sizeof(buf) + 100, buf, sizeof(buf)));
+  EXPECT_EQ(length - 5, file.Seek(-5, SEEK_END));
+  EXPECT_EQ(5, file.Read(buf, sizeof(buf)));
+  EXPECT_EQ(0, file.Read(buf, sizeof(buf)));
+
+  file.Close();
+  EXPECT_FALSE(file.IsMapped());
+}
+
 TEST(TestFile, Write)
 {
   XFILE::CFile *file;
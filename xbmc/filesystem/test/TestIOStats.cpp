@@ -0,0 +1,37 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/IOStats.h"
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+TEST(TestIOStats, Percentile)
+{
+  CIOStats::SProtocolStats& stats = CIOStats::GetInstance().Get("teststats");
+  EXPECT_EQ(0u, CIOStats::Percentile(stats.readLatency, 0.5));
+
+  // 90 fast and 10 slow reads
+  for (int i = 0; i < 90; i++)
+    CIOStats::Record(stats.readLatency, 100);
+  for (int i = 0; i < 10; i++)
+    CIOStats::Record(stats.readLatency, 100000);
+
+  EXPECT_EQ(128u, CIOStats::Percentile(stats.readLatency, 0.5));
+  EXPECT_EQ(131072u, CIOStats::Percentile(stats.readLatency, 0.9));
+  EXPECT_EQ(131072u, CIOStats::Percentile(stats.readLatency, 0.99));
+
+  // huge values end up in the last bucket
+  CIOStats::Record(stats.readSizes, UINT64_MAX);
+  EXPECT_EQ(1u, stats.readSizes[CIOStats::HISTOGRAM_BUCKETS - 1].load());
+
+  EXPECT_EQ(&stats, &CIOStats::GetInstance().Get("teststats"));
+  CIOStats::GetInstance().Reset();
+  EXPECT_EQ(0u, CIOStats::Percentile(stats.readLatency, 0.5));
+}
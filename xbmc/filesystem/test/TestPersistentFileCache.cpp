@@ -0,0 +1,151 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/PersistentFileCache.h"
+
+#include <algorithm>
+#include <time.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+const std::string TEST_URL = "http://localhost/TestPersistentFileCache.mkv";
+constexpr int64_t BLOCK_SIZE = 256 * 1024;
+constexpr int64_t FILE_SIZE = 3 * BLOCK_SIZE + 100;
+constexpr uint64_t MAX_CACHE_SIZE = 64 * 1024 * 1024;
+
+// keep the user's cache out of the test, the last step evicts everything
+const std::string CACHE_FOLDER = "special://temp/TestPersistentFileCache/";
+} // namespace
+
+TEST(TestPersistentFileCache, ReopenKeepsCompletedBlocks)
+{
+  const int64_t mtime = time(nullptr);
+  std::vector<char> in(BLOCK_SIZE + BLOCK_SIZE / 2);
+  for (size_t i = 0; i < in.size(); i++)
+    in[i] = static_cast<char>(i * 13);
+
+  {
+    CPersistentFileCache cache(TEST_URL, FILE_SIZE, mtime, MAX_CACHE_SIZE, CACHE_FOLDER);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    EXPECT_EQ(0, cache.CachedDataEndPosIfSeekTo(0));
+
+    // the same entry can't be opened twice
+    CPersistentFileCache other(TEST_URL, FILE_SIZE, mtime, MAX_CACHE_SIZE, CACHE_FOLDER);
+    EXPECT_EQ(CACHE_RC_ERROR, other.Open());
+
+    ASSERT_EQ(static_cast<int>(in.size()), cache.WriteToCache(in.data(), in.size()));
+    EXPECT_EQ(static_cast<int64_t>(in.size()), cache.CachedDataEndPos());
+    cache.Close();
+  }
+
+  {
+    // only the completely written block survives
+    CPersistentFileCache cache(TEST_URL, FILE_SIZE, mtime, MAX_CACHE_SIZE, CACHE_FOLDER);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    EXPECT_EQ(BLOCK_SIZE, cache.CachedDataEndPosIfSeekTo(0));
+    EXPECT_FALSE(cache.IsCachedPosition(BLOCK_SIZE + 1));
+    EXPECT_FALSE(cache.Reset(0, false));
+    EXPECT_EQ(BLOCK_SIZE, cache.CachedDataEndPos());
+
+    std::vector<char> out(BLOCK_SIZE);
+    ASSERT_EQ(static_cast<int>(BLOCK_SIZE), cache.ReadFromCache(out.data(), out.size()));
+    EXPECT_TRUE(std::equal(out.begin(), out.end(), in.begin()));
+    EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(out.data(), out.size()));
+    cache.Close();
+  }
+
+  {
+    // a different modification time is a different entry
+    CPersistentFileCache cache(TEST_URL, FILE_SIZE, mtime + 1, 0, CACHE_FOLDER);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    EXPECT_EQ(0, cache.CachedDataEndPosIfSeekTo(0));
+    cache.Close(); // evicts everything with a zero budget
+  }
+
+  CPersistentFileCache cache(TEST_URL, FILE_SIZE, mtime, MAX_CACHE_SIZE, CACHE_FOLDER);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  EXPECT_EQ(0, cache.CachedDataEndPosIfSeekTo(0));
+  cache.Close();
+
+  CDirectory::RemoveRecursive(CACHE_FOLDER);
+}
+
+TEST(TestPersistentFileCache, BudgetWhileWriting)
+{
+  const std::string folder = "special://temp/TestPersistentFileCacheBudget/";
+  const std::string orphan = folder + "0123456789abcdef0123456789abcdef.cache";
+  const int64_t mtime = time(nullptr);
+  const uint64_t maxCacheSize = 2 * BLOCK_SIZE;
+  std::vector<char> in(2 * BLOCK_SIZE, 'k');
+  std::vector<char> out(BLOCK_SIZE);
+
+  // a data file whose index was never written
+  ASSERT_TRUE(CDirectory::Create(folder));
+  {
+    CFile file;
+    ASSERT_TRUE(file.OpenForWrite(orphan, true));
+    EXPECT_EQ(static_cast<ssize_t>(out.size()), file.Write(out.data(), out.size()));
+  }
+
+  {
+    // the first open scans the folder and sweeps the orphan
+    CPersistentFileCache cache(TEST_URL + ".1", FILE_SIZE, mtime, maxCacheSize, folder);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    EXPECT_FALSE(CFile::Exists(orphan, false));
+    ASSERT_EQ(static_cast<int>(BLOCK_SIZE), cache.WriteToCache(in.data(), BLOCK_SIZE));
+    cache.Close();
+  }
+
+  {
+    // the second block exceeds the budget and evicts the closed entry while writing
+    CPersistentFileCache cache(TEST_URL + ".2", FILE_SIZE, mtime, maxCacheSize, folder);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    ASSERT_EQ(static_cast<int>(in.size()), cache.WriteToCache(in.data(), in.size()));
+    CPersistentFileCache first(TEST_URL + ".1", FILE_SIZE, mtime, maxCacheSize, folder);
+    ASSERT_EQ(CACHE_RC_OK, first.Open());
+    EXPECT_EQ(0, first.CachedDataEndPosIfSeekTo(0));
+    first.Close();
+    cache.Close();
+  }
+
+  {
+    // reads of blocks cached by the last session are hits
+    CPersistentFileCache cache(TEST_URL + ".2", FILE_SIZE, mtime, maxCacheSize, folder);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    EXPECT_FALSE(cache.Reset(0, false));
+    ASSERT_EQ(static_cast<int>(BLOCK_SIZE), cache.ReadFromCache(out.data(), out.size()));
+    uint64_t hits, misses, hitBytes;
+    cache.GetHitStats(hits, misses, hitBytes);
+    EXPECT_EQ(1u, hits);
+    EXPECT_EQ(0u, misses);
+    EXPECT_EQ(static_cast<uint64_t>(BLOCK_SIZE), hitBytes);
+    cache.Close();
+  }
+
+  {
+    // an entry that doesn't fit on its own isn't kept
+    CPersistentFileCache cache(TEST_URL + ".3", FILE_SIZE, mtime, BLOCK_SIZE, folder);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    ASSERT_EQ(static_cast<int>(in.size()), cache.WriteToCache(in.data(), in.size()));
+    cache.Close();
+  }
+
+  CPersistentFileCache cache(TEST_URL + ".3", FILE_SIZE, mtime, BLOCK_SIZE, folder);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  EXPECT_EQ(0, cache.CachedDataEndPosIfSeekTo(0));
+  cache.Close();
+
+  CDirectory::RemoveRecursive(folder);
+}
@@ -18,6 +18,7 @@
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 
+#include <cstdlib>
 #include <errno.h>
 
 #include <gtest/gtest.h>
@@ -88,6 +89,50 @@ TEST_F(TestZipFile, Read)
   file.Close();
 }
 
+TEST_F(TestZipFile, SeekLargeEntry)
+{
+  // 1 MiB deflated entry, made of 64 byte lines that start with their offset
+  XFILE::CFile file;
+  char buf[16];
+  memset(&buf, 0, sizeof(buf));
+  CFileItemList itemlist;
+
+  std::string reffile = XBMC_REF_FILE_PATH("xbmc/filesystem/test/largefile.txt.zip");
+  CURL zipUrl = URIUtils::CreateArchivePath("zip", CURL(reffile), "");
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(zipUrl, itemlist, "",
+    XFILE::DIR_FLAG_NO_FILE_DIRS));
+  ASSERT_EQ(1, itemlist.Size());
+  std::string strpathinzip = itemlist[0]->GetPath();
+  ASSERT_TRUE(file.Open(strpathinzip));
+  EXPECT_EQ(1024 * 1024, file.GetLength());
+
+  // forward, further than the checkpoint span and before any checkpoint exists
+  EXPECT_EQ(640 * 1024, file.Seek(640 * 1024));
+  EXPECT_EQ(15, file.Read(buf, 15));
+  EXPECT_EQ(640 * 1024, std::strtoll(buf, nullptr, 10));
+
+  EXPECT_EQ(960 * 1024, file.Seek(960 * 1024 - file.GetPosition(), SEEK_CUR));
+  EXPECT_EQ(15, file.Read(buf, 15));
+  EXPECT_EQ(960 * 1024, std::strtoll(buf, nullptr, 10));
+
+  // back and forth using the checkpoints recorded on the way
+  EXPECT_EQ(320 * 1024, file.Seek(320 * 1024));
+  EXPECT_EQ(15, file.Read(buf, 15));
+  EXPECT_EQ(320 * 1024, std::strtoll(buf, nullptr, 10));
+
+  EXPECT_EQ(1024 * 1024 - 64, file.Seek(1024 * 1024 - 64));
+  EXPECT_EQ(15, file.Read(buf, 15));
+  EXPECT_EQ(1024 * 1024 - 64, std::strtoll(buf, nullptr, 10));
+  file.Close();
+
+  // a new handle shares the checkpoints of the entry
+  ASSERT_TRUE(file.Open(strpathinzip));
+  EXPECT_EQ(512 * 1024, file.Seek(512 * 1024));
+  EXPECT_EQ(15, file.Read(buf, 15));
+  EXPECT_EQ(512 * 1024, std::strtoll(buf, nullptr, 10));
+  file.Close();
+}
+
 TEST_F(TestZipFile, Exists)
 {
   std::string reffile, strpathinzip;
@@ -28,3 +28,46 @@ TEST(TestZipManager, PathTraversal)
   ASSERT_FALSE(pathTraversal.RegFind("test.txt..") >= 0);
   ASSERT_FALSE(pathTraversal.RegFind("test..test.txt") >= 0);
 }
+
+TEST(TestZipManager, InflateIndex)
+{
+  CInflateIndex index(16 * CInflateIndex::MIN_SPAN);
+  ASSERT_EQ(CInflateIndex::MIN_SPAN, index.GetSpan());
+  SInflateCheckpoint point;
+  EXPECT_FALSE(index.Find(CInflateIndex::MIN_SPAN * 4, point));
+  EXPECT_FALSE(index.NeedsCheckpoint(CInflateIndex::MIN_SPAN - 1));
+  EXPECT_TRUE(index.NeedsCheckpoint(CInflateIndex::MIN_SPAN));
+
+  for (int64_t i = 1; i <= 3; i++)
+  {
+    SInflateCheckpoint add;
+    add.out = i * CInflateIndex::MIN_SPAN + 10;
+    add.in = i;
+    add.window.resize(1024);
+    index.Add(std::move(add));
+  }
+
+  // too close to the last one, dropped
+  SInflateCheckpoint close;
+  close.out = 3 * CInflateIndex::MIN_SPAN + 20;
+  index.Add(std::move(close));
+  EXPECT_FALSE(index.NeedsCheckpoint(4 * CInflateIndex::MIN_SPAN));
+
+  EXPECT_FALSE(index.Find(CInflateIndex::MIN_SPAN, point));
+  ASSERT_TRUE(index.Find(2 * CInflateIndex::MIN_SPAN + 10, point));
+  EXPECT_EQ(2, point.in);
+  ASSERT_TRUE(index.Find(10 * CInflateIndex::MIN_SPAN, point));
+  EXPECT_EQ(3, point.in);
+  EXPECT_EQ(3u * 1024, index.GetMemoryUsage());
+}
+
+TEST(TestZipManager, InflateIndexSpanGrowsWithEntry)
+{
+  // large entries get fewer checkpoints per byte, so their windows stay bounded
+  const int64_t size = 1000 * CInflateIndex::MIN_SPAN;
+  CInflateIndex index(size);
+  EXPECT_GT(index.GetSpan(), CInflateIndex::MIN_SPAN);
+  EXPECT_LE(size, index.GetSpan() * CInflateIndex::MAX_CHECKPOINTS);
+  EXPECT_FALSE(index.NeedsCheckpoint(index.GetSpan() - 1));
+  EXPECT_TRUE(index.NeedsCheckpoint(index.GetSpan()));
+}
@@ -57,7 +57,7 @@ public:
       FT_Done_FreeType(m_library);
   }
 
-  FT_Face GetFont(const std::string &filename, float size, float aspect, XUTILS::auto_buffer& memoryBuf)
+  FT_Face GetFont(const std::string &filename, float size, float aspect, XUTILS::auto_buffer& memoryBuf, std::unique_ptr<XFILE::CFile>& mappedFile)
   {
     // don't have it yet - create it
     if (!m_library)
@@ -76,6 +76,7 @@ public:
       return NULL;
 
     memoryBuf.clear();
+    mappedFile.reset();
 #ifndef TARGET_WINDOWS
     if (!realFile.GetProtocol().empty())
 #endif // ! TARGET_WINDOWS
@@ -83,10 +84,25 @@ public:
       // load file into memory if it is not on local drive
       // in case of win32: always load file into memory as filename is in UTF-8,
       //                   but freetype expect filename in ANSI encoding
-      XFILE::CFile f;
-      if (f.LoadFile(realFile, memoryBuf) <= 0)
-        return NULL;
-      if (FT_New_Memory_Face(m_library, (const FT_Byte*)memoryBuf.get(), memoryBuf.size(), 0, &face) != 0)
+      // local files are mapped instead, the mapping is kept open as long as the face
+      const uint8_t* data = nullptr;
+      int64_t length = 0;
+      mappedFile.reset(new XFILE::CFile());
+      if (mappedFile->Open(realFile, XFILE::READ_MMAP) && mappedFile->IsMapped())
+      {
+        length = mappedFile->GetLength();
+        data = mappedFile->GetSpan(0, static_cast<size_t>(length));
+      }
+      if (data == nullptr)
+      {
+        mappedFile.reset();
+        XFILE::CFile f;
+        if (f.LoadFile(realFile, memoryBuf) <= 0)
+          return NULL;
+        data = reinterpret_cast<const uint8_t*>(memoryBuf.get());
+        length = static_cast<int64_t>(memoryBuf.size());
+      }
+      if (FT_New_Memory_Face(m_library, (const FT_Byte*)data, static_cast<FT_Long>(length), 0, &face) != 0)
         return NULL;
     }
 #ifndef TARGET_WINDOWS
@@ -230,13 +246,14 @@ void CGUIFontTTFBase::Clear()
 
   m_strFileName.clear();
   m_fontFileInMemory.clear();
+  m_fontFile.reset();
 }
 
 bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float aspect, float lineSpacing, bool border)
 {
   // we now know that this object is unique - only the GUIFont objects are non-unique, so no need
   // for reference tracking these fonts
-  m_face = g_freeTypeLibrary.GetFont(strFilename, height, aspect, m_fontFileInMemory);
+  m_face = g_freeTypeLibrary.GetFont(strFilename, height, aspect, m_fontFileInMemory, m_fontFile);
 
   if (!m_face)
     return false;
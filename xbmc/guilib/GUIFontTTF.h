@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <stdint.h>
 #include <vector>
@@ -29,6 +30,11 @@ constexpr size_t LOOKUPTABLE_SIZE = 256 * 8;
 class CBaseTexture;
 class CRenderSystemBase;
 
+namespace XFILE
+{
+class CFile;
+}
+
 struct FT_FaceRec_;
 struct FT_LibraryRec_;
 struct FT_GlyphSlotRec_;
@@ -176,6 +182,7 @@ protected:
 
   std::string m_strFileName;
   XUTILS::auto_buffer m_fontFileInMemory; // used only in some cases, see CFreeTypeLibrary::GetFont()
+  std::unique_ptr<XFILE::CFile> m_fontFile; // mapped font file, used instead of m_fontFileInMemory when possible
 
   CGUIFontCache<CGUIFontCacheStaticPosition, CGUIFontCacheStaticValue> m_staticCache;
   CGUIFontCache<CGUIFontCacheDynamicPosition, CGUIFontCacheDynamicValue> m_dynamicCache;
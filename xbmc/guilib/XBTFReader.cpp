@@ -9,44 +9,64 @@
 #include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
-#include <sys/stat.h>
 
 #include "XBTFReader.h"
+#include "filesystem/File.h"
 #include "guilib/XBTF.h"
 #include "utils/EndianSwap.h"
 
-#ifdef TARGET_WINDOWS
-#include "filesystem/SpecialProtocol.h"
-#include "utils/CharsetConverter.h"
-#include "platform/win32/PlatformDefs.h"
-#endif
+namespace
+{
+// reads the header fields straight from the mapping if the bundle is mapped
+class CHeaderReader
+{
+public:
+  explicit CHeaderReader(XFILE::CFile& file) : m_file(file) {}
+
+  bool Read(void* buffer, size_t size)
+  {
+    if (m_file.IsMapped())
+    {
+      const uint8_t* data = m_file.GetSpan(m_position, size);
+      if (data == nullptr)
+        return false;
+      memcpy(buffer, data, size);
+    }
+    else if (m_file.Read(buffer, size) != static_cast<ssize_t>(size))
+      return false;
+
+    m_position += size;
+    return true;
+  }
+
+  int64_t GetPosition() const { return m_position; }
 
-static bool ReadString(FILE* file, char* str, size_t max_length)
+private:
+  XFILE::CFile& m_file;
+  int64_t m_position = 0;
+};
+} // namespace
+
+static bool ReadString(CHeaderReader& file, char* str, size_t max_length)
 {
-  if (file == nullptr || str == nullptr || max_length <= 0)
+  if (str == nullptr || max_length <= 0)
     return false;
 
-  return (fread(str, max_length, 1, file) == 1);
+  return file.Read(str, max_length);
 }
 
-static bool ReadUInt32(FILE* file, uint32_t& value)
+static bool ReadUInt32(CHeaderReader& file, uint32_t& value)
 {
-  if (file == nullptr)
-    return false;
-
-  if (fread(&value, sizeof(uint32_t), 1, file) != 1)
+  if (!file.Read(&value, sizeof(uint32_t)))
     return false;
 
   value = Endian_SwapLE32(value);
   return true;
 }
 
-static bool ReadUInt64(FILE* file, uint64_t& value)
+static bool ReadUInt64(CHeaderReader& file, uint64_t& value)
 {
-  if (file == nullptr)
-    return false;
-
-  if (fread(&value, sizeof(uint64_t), 1, file) != 1)
+  if (!file.Read(&value, sizeof(uint64_t)))
     return false;
 
   value = Endian_SwapLE64(value);
@@ -70,19 +90,18 @@ bool CXBTFReader::Open(const std::string& path)
 
   m_path = path;
 
-#ifdef TARGET_WINDOWS
-  std::wstring strPathW;
-  g_charsetConverter.utf8ToW(CSpecialProtocol::TranslatePath(m_path), strPathW, false);
-  m_file = _wfopen(strPathW.c_str(), L"rb");
-#else
-  m_file = fopen(m_path.c_str(), "rb");
-#endif
-  if (m_file == nullptr)
+  // textures are loaded straight from the mapping, the bundle isn't read into memory
+  m_file.reset(new XFILE::CFile());
+  if (!m_file->Open(m_path, XFILE::READ_NO_CACHE | XFILE::READ_MMAP))
+  {
+    m_file.reset();
     return false;
+  }
+  CHeaderReader header(*m_file);
 
   // read the magic word
   char magic[4];
-  if (!ReadString(m_file, magic, sizeof(magic)))
+  if (!ReadString(header, magic, sizeof(magic)))
     return false;
 
   if (strncmp(XBTF_MAGIC.c_str(), magic, sizeof(magic)) != 0)
@@ -90,14 +109,14 @@ bool CXBTFReader::Open(const std::string& path)
 
   // read the version
   char version[1];
-  if (!ReadString(m_file, version, sizeof(version)))
+  if (!ReadString(header, version, sizeof(version)))
     return false;
 
   if (strncmp(XBTF_VERSION.c_str(), version, sizeof(version)) != 0)
     return false;
 
   unsigned int nofFiles;
-  if (!ReadUInt32(m_file, nofFiles))
+  if (!ReadUInt32(header, nofFiles))
     return false;
 
   for (uint32_t i = 0; i < nofFiles; i++)
@@ -109,47 +128,47 @@ bool CXBTFReader::Open(const std::string& path)
     // one extra char to null terminate the string with the following memset
     char path[CXBTFFile::MaximumPathLength + 1];
     memset(path, 0, sizeof(path));
-    if (!ReadString(m_file, path, sizeof(path) - 1))
+    if (!ReadString(header, path, sizeof(path) - 1))
       return false;
     xbtfFile.SetPath(path);
 
-    if (!ReadUInt32(m_file, u32))
+    if (!ReadUInt32(header, u32))
       return false;
     xbtfFile.SetLoop(u32);
 
     unsigned int nofFrames;
-    if (!ReadUInt32(m_file, nofFrames))
+    if (!ReadUInt32(header, nofFrames))
       return false;
 
     for (uint32_t j = 0; j < nofFrames; j++)
     {
       CXBTFFrame frame;
 
-      if (!ReadUInt32(m_file, u32))
+      if (!ReadUInt32(header, u32))
         return false;
       frame.SetWidth(u32);
 
-      if (!ReadUInt32(m_file, u32))
+      if (!ReadUInt32(header, u32))
         return false;
       frame.SetHeight(u32);
 
-      if (!ReadUInt32(m_file, u32))
+      if (!ReadUInt32(header, u32))
         return false;
       frame.SetFormat(u32);
 
-      if (!ReadUInt64(m_file, u64))
+      if (!ReadUInt64(header, u64))
         return false;
       frame.SetPackedSize(u64);
 
-      if (!ReadUInt64(m_file, u64))
+      if (!ReadUInt64(header, u64))
         return false;
       frame.SetUnpackedSize(u64);
 
-      if (!ReadUInt32(m_file, u32))
+      if (!ReadUInt32(header, u32))
         return false;
       frame.SetDuration(u32);
 
-      if (!ReadUInt64(m_file, u64))
+      if (!ReadUInt64(header, u64))
         return false;
       frame.SetOffset(u64);
 
@@ -160,7 +179,7 @@ bool CXBTFReader::Open(const std::string& path)
   }
 
   // Sanity check
-  uint64_t pos = static_cast<uint64_t>(ftell(m_file));
+  uint64_t pos = static_cast<uint64_t>(header.GetPosition());
   if (pos != GetHeaderSize())
     return false;
 
@@ -176,8 +195,8 @@ void CXBTFReader::Close()
 {
   if (m_file != nullptr)
   {
-    fclose(m_file);
-    m_file = nullptr;
+    m_file->Close();
+    m_file.reset();
   }
 
   m_path.clear();
@@ -189,8 +208,8 @@ time_t CXBTFReader::GetLastModificationTimestamp() const
   if (m_file == nullptr)
     return 0;
 
-  struct stat fileStat;
-  if (fstat(fileno(m_file), &fileStat) == -1)
+  struct __stat64 fileStat;
+  if (m_file->Stat(&fileStat) == -1)
     return 0;
 
   return fileStat.st_mtime;
@@ -201,17 +220,26 @@ bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
   if (m_file == nullptr)
     return false;
 
-#if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
-  if (fseeko(m_file, static_cast<off_t>(frame.GetOffset()), SEEK_SET) == -1)
-#elif defined(TARGET_ANDROID)
-  if (fseek(m_file, static_cast<long>(frame.GetOffset()), SEEK_SET) == -1)  // No fseeko64 before N
-#else
-  if (fseeko64(m_file, static_cast<off_t>(frame.GetOffset()), SEEK_SET) == -1)
-#endif
+  const uint8_t* data = GetFrameData(frame);
+  if (data != nullptr)
+  {
+    memcpy(buffer, data, static_cast<size_t>(frame.GetPackedSize()));
+    return true;
+  }
+
+  if (m_file->Seek(static_cast<int64_t>(frame.GetOffset()), SEEK_SET) != static_cast<int64_t>(frame.GetOffset()))
     return false;
 
-  if (fread(buffer, 1, static_cast<size_t>(frame.GetPackedSize()), m_file) != frame.GetPackedSize())
+  if (m_file->Read(buffer, static_cast<size_t>(frame.GetPackedSize())) != static_cast<ssize_t>(frame.GetPackedSize()))
     return false;
 
   return true;
 }
+
+const uint8_t* CXBTFReader::GetFrameData(const CXBTFFrame& frame) const
+{
+  if (m_file == nullptr)
+    return nullptr;
+
+  return m_file->GetSpan(static_cast<int64_t>(frame.GetOffset()), static_cast<size_t>(frame.GetPackedSize()));
+}
@@ -15,6 +15,11 @@
 #include <string>
 #include <vector>
 
+namespace XFILE
+{
+class CFile;
+}
+
 class CXBTFReader : public CXBTFBase
 {
 public:
@@ -29,9 +34,15 @@ public:
 
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
 
+  /*!
+   \brief Get the packed data of a frame without copying it.
+   \return pointer into the memory mapped bundle, or nullptr if the bundle couldn't be mapped
+   */
+  const uint8_t* GetFrameData(const CXBTFFrame& frame) const;
+
 private:
   std::string m_path;
-  FILE* m_file = nullptr;
+  std::unique_ptr<XFILE::CFile> m_file;
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
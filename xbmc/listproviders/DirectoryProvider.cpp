@@ -14,6 +14,7 @@
 #include "addons/GUIDialogAddonInfo.h"
 #include "favourites/FavouritesService.h"
 #include "filesystem/Directory.h"
+#include "filesystem/File.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
 #include "interfaces/AnnouncementManager.h"
@@ -27,8 +28,11 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
 #include "utils/JobManager.h"
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/XMLUtils.h"
@@ -37,21 +41,68 @@
 #include "video/dialogs/GUIDialogVideoInfo.h"
 #include "video/windows/GUIWindowVideoBase.h"
 
+#include <atomic>
 #include <memory>
+#include <set>
 #include <utility>
 
 using namespace XFILE;
 using namespace KODI::MESSAGING;
 using namespace PVR;
 
+namespace
+{
+// refreshes running at once for all directory providers, so a home screen full of
+// widgets doesn't flood the job manager with library and plugin queries
+const unsigned int MAX_REFRESHES = 4;
+std::atomic<unsigned int> activeRefreshes(0);
+
+// last contents of the widgets, shown until they are refreshed
+const std::string CACHE_FOLDER = "special://profile/widgetcache/";
+
+InfoTagType GetItemType(const CGUIStaticItem& item)
+{
+  if (item.IsVideo())
+    return InfoTagType::VIDEO;
+  if (item.IsAudio())
+    return InfoTagType::AUDIO;
+  if (item.IsPicture())
+    return InfoTagType::PICTURE;
+  if (item.IsPVRChannelGroup())
+    return InfoTagType::PVR;
+  return InfoTagType::PROGRAM;
+}
+
+bool IsSameItem(const CGUIStaticItem& a, const CGUIStaticItem& b)
+{
+  if (a.GetPath() != b.GetPath() || a.GetLabel() != b.GetLabel() ||
+      a.GetLabel2() != b.GetLabel2() || a.GetArt() != b.GetArt())
+    return false;
+
+  // covers the info tags and properties
+  CVariant va, vb;
+  a.Serialize(va);
+  b.Serialize(vb);
+  return va == vb;
+}
+} // namespace
+
 class CDirectoryJob : public CJob
 {
 public:
-  CDirectoryJob(const std::string &url, SortDescription sort, int limit, int parentID)
+  /*!
+   \brief Job fetching the contents of a directory provider.
+   \param cacheFile where the contents are persisted to.
+   \param fromCache load the persisted contents instead of fetching the directory.
+   */
+  CDirectoryJob(const std::string &url, SortDescription sort, int limit, int parentID,
+                const std::string& cacheFile, bool fromCache)
     : m_url(url),
       m_sort(sort),
       m_limit(limit),
-      m_parentID(parentID)
+      m_parentID(parentID),
+      m_cacheFile(cacheFile),
+      m_fromCache(fromCache)
   { }
   ~CDirectoryJob() override = default;
 
@@ -61,7 +112,7 @@ public:
     if (strcmp(job->GetType(),GetType()) == 0)
     {
       const CDirectoryJob* dirJob = dynamic_cast<const CDirectoryJob*>(job);
-      if (dirJob && dirJob->m_url == m_url)
+      if (dirJob && dirJob->m_url == m_url && dirJob->m_fromCache == m_fromCache)
         return true;
     }
     return false;
@@ -69,6 +120,9 @@ public:
 
   bool DoWork() override
   {
+    if (m_fromCache)
+      return Load();
+
     CFileItemList items;
     if (CDirectory::GetDirectory(m_url, items, "", DIR_FLAG_DEFAULTS))
     {
@@ -91,34 +145,33 @@ public:
         m_items.push_back(item);
       }
       m_target = items.GetProperty("node.target").asString();
+      Save();
     }
     return true;
   }
 
   std::shared_ptr<CThumbLoader> getThumbLoader(CGUIStaticItemPtr &item)
   {
-    if (item->IsVideo())
-    {
-      initThumbLoader<CVideoThumbLoader>(InfoTagType::VIDEO);
-      return m_thumbloaders[InfoTagType::VIDEO];
-    }
-    if (item->IsAudio())
+    const InfoTagType type = GetItemType(*item);
+    switch (type)
     {
-      initThumbLoader<CMusicThumbLoader>(InfoTagType::AUDIO);
-      return m_thumbloaders[InfoTagType::AUDIO];
+      case InfoTagType::VIDEO:
+        initThumbLoader<CVideoThumbLoader>(type);
+        break;
+      case InfoTagType::AUDIO:
+        initThumbLoader<CMusicThumbLoader>(type);
+        break;
+      case InfoTagType::PICTURE:
+        initThumbLoader<CPictureThumbLoader>(type);
+        break;
+      case InfoTagType::PVR:
+        initThumbLoader<CPVRThumbLoader>(type);
+        break;
+      default:
+        initThumbLoader<CProgramThumbLoader>(type);
+        break;
     }
-    if (item->IsPicture())
-    {
-      initThumbLoader<CPictureThumbLoader>(InfoTagType::PICTURE);
-      return m_thumbloaders[InfoTagType::PICTURE];
-    }
-    if (item->IsPVRChannelGroup())
-    {
-      initThumbLoader<CPVRThumbLoader>(InfoTagType::PVR);
-      return m_thumbloaders[InfoTagType::PVR];
-    }
-    initThumbLoader<CProgramThumbLoader>(InfoTagType::PROGRAM);
-    return m_thumbloaders[InfoTagType::PROGRAM];
+    return m_thumbloaders[type];
   }
 
   template<class CThumbLoaderClass>
@@ -132,21 +185,87 @@ public:
     }
   }
 
+  bool IsFromCache() const { return m_fromCache; }
   const std::vector<CGUIStaticItemPtr> &GetItems() const { return m_items; }
   const std::string &GetTarget() const { return m_target; }
   std::vector<InfoTagType> GetItemTypes(std::vector<InfoTagType> &itemTypes) const
   {
     itemTypes.clear();
+    if (m_fromCache)
+    {
+      std::set<InfoTagType> types;
+      for (const auto& item : m_items)
+        types.insert(GetItemType(*item));
+      itemTypes.assign(types.begin(), types.end());
+      return itemTypes;
+    }
     for (const auto& i : m_thumbloaders)
       itemTypes.push_back(i.first);
     return itemTypes;
   }
 private:
+  bool Load()
+  {
+    CFileItemList items;
+    CFile file;
+    if (!CFile::Exists(m_cacheFile) || !file.Open(m_cacheFile))
+      return false;
+
+    try
+    {
+      CArchive ar(&file, CArchive::load);
+      ar >> items;
+    }
+    catch (const std::out_of_range&)
+    {
+      CLog::Log(LOGERROR, "CDirectoryProvider[%s]: corrupt cache file %s", m_url.c_str(), m_cacheFile.c_str());
+      return false;
+    }
+
+    // the art was loaded before the items were saved, no need for the thumb loaders
+    m_items.reserve(items.Size());
+    for (int i = 0; i < items.Size(); i++)
+    {
+      CGUIStaticItemPtr item(new CGUIStaticItem(*items[i]));
+      if (item->HasProperty("node.visible"))
+        item->SetVisibleCondition(item->GetProperty("node.visible").asString(), m_parentID);
+      m_items.push_back(item);
+    }
+    m_target = items.GetProperty("node.target").asString();
+    return true;
+  }
+
+  void Save()
+  {
+    if (m_items.empty())
+    {
+      CFile::Delete(m_cacheFile);
+      return;
+    }
+
+    if (!CDirectory::Exists(CACHE_FOLDER) && !CDirectory::Create(CACHE_FOLDER))
+      return;
+
+    CFileItemList items(m_url);
+    items.SetProperty("node.target", m_target);
+    for (const auto& item : m_items)
+      items.Add(item);
+
+    CFile file;
+    if (file.OpenForWrite(m_cacheFile, true))
+    {
+      CArchive ar(&file, CArchive::store);
+      ar << items;
+    }
+  }
+
   std::string m_url;
   std::string m_target;
   SortDescription m_sort;
   unsigned int m_limit;
   int m_parentID;
+  std::string m_cacheFile;
+  bool m_fromCache;
   std::vector<CGUIStaticItemPtr> m_items;
   std::map<InfoTagType, std::shared_ptr<CThumbLoader> > m_thumbloaders;
 };
@@ -155,7 +274,9 @@ CDirectoryProvider::CDirectoryProvider(const TiXmlElement *element, int parentID
  : IListProvider(parentID),
    m_updateState(OK),
    m_isAnnounced(false),
+   m_cacheLoaded(false),
    m_jobID(0),
+   m_cacheJobID(0),
    m_currentLimit(0)
 {
   assert(element);
@@ -208,10 +329,31 @@ bool CDirectoryProvider::Update(bool forceRefresh)
 
   if (fireJob)
   {
-    CLog::Log(LOGDEBUG, "CDirectoryProvider[%s]: refreshing..", m_currentUrl.c_str());
-    if (m_jobID)
-      CJobManager::GetInstance().CancelJob(m_jobID);
-    m_jobID = CJobManager::GetInstance().AddJob(new CDirectoryJob(m_currentUrl, m_currentSort, m_currentLimit, m_parentID), this);
+    const std::string cacheFile = GetCacheFile();
+
+    // show the contents from last time until the refresh is done
+    if (m_items.empty() && !m_cacheLoaded)
+    {
+      m_cacheLoaded = true;
+      m_cacheJobID = CJobManager::GetInstance().AddJob(
+          new CDirectoryJob(m_currentUrl, m_currentSort, m_currentLimit, m_parentID, cacheFile, true),
+          this, CJob::PRIORITY_NORMAL);
+    }
+
+    CancelRefresh();
+    if (++activeRefreshes > MAX_REFRESHES)
+    {
+      // too many refreshes running, try again on the next update
+      --activeRefreshes;
+      m_updateState = INVALIDATED;
+    }
+    else
+    {
+      CLog::Log(LOGDEBUG, "CDirectoryProvider[%s]: refreshing..", m_currentUrl.c_str());
+      m_jobID = CJobManager::GetInstance().AddJob(
+          new CDirectoryJob(m_currentUrl, m_currentSort, m_currentLimit, m_parentID, cacheFile, false),
+          this);
+    }
   }
 
   if (!changed)
@@ -329,9 +471,11 @@ void CDirectoryProvider::OnFavouritesEvent(const CFavouritesService::FavouritesU
 void CDirectoryProvider::Reset()
 {
   CSingleLock lock(m_section);
-  if (m_jobID)
-    CJobManager::GetInstance().CancelJob(m_jobID);
-  m_jobID = 0;
+  CancelRefresh();
+  if (m_cacheJobID)
+    CJobManager::GetInstance().CancelJob(m_cacheJobID);
+  m_cacheJobID = 0;
+  m_cacheLoaded = false;
   m_items.clear();
   m_currentTarget.clear();
   m_currentUrl.clear();
@@ -355,17 +499,83 @@ void CDirectoryProvider::Reset()
 void CDirectoryProvider::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   CSingleLock lock(m_section);
+  CDirectoryJob* dirJob = static_cast<CDirectoryJob*>(job);
+  if (dirJob->IsFromCache())
+  {
+    // only useful as long as nothing else was shown
+    if (jobID == m_cacheJobID && success && m_items.empty())
+    {
+      m_items = dirJob->GetItems();
+      m_currentTarget = dirJob->GetTarget();
+      dirJob->GetItemTypes(m_itemTypes);
+      if (m_updateState == OK)
+        m_updateState = DONE;
+    }
+    m_cacheJobID = 0;
+    return;
+  }
+
   if (success)
   {
-    m_items = static_cast<CDirectoryJob*>(job)->GetItems();
-    m_currentTarget = static_cast<CDirectoryJob*>(job)->GetTarget();
-    static_cast<CDirectoryJob*>(job)->GetItemTypes(m_itemTypes);
-    if (m_updateState == OK)
+    // the refreshed contents win over the persisted ones
+    if (m_cacheJobID)
+      CJobManager::GetInstance().CancelJob(m_cacheJobID);
+    m_cacheJobID = 0;
+
+    bool changed = UpdateItems(dirJob->GetItems());
+    if (m_currentTarget != dirJob->GetTarget())
+    {
+      m_currentTarget = dirJob->GetTarget();
+      changed = true;
+    }
+    dirJob->GetItemTypes(m_itemTypes);
+    if (changed && m_updateState == OK)
       m_updateState = DONE;
   }
+  if (m_jobID)
+    --activeRefreshes;
   m_jobID = 0;
 }
 
+bool CDirectoryProvider::UpdateItems(const std::vector<CGUIStaticItemPtr>& items)
+{
+  // keep the items that didn't change, so the list is only touched if something did
+  bool changed = items.size() != m_items.size();
+  std::vector<CGUIStaticItemPtr> merged;
+  merged.reserve(items.size());
+  for (size_t i = 0; i < items.size(); i++)
+  {
+    if (i < m_items.size() && IsSameItem(*m_items[i], *items[i]))
+      merged.push_back(m_items[i]);
+    else
+    {
+      merged.push_back(items[i]);
+      changed = true;
+    }
+  }
+
+  if (changed)
+    m_items = std::move(merged);
+  return changed;
+}
+
+void CDirectoryProvider::CancelRefresh()
+{
+  if (!m_jobID)
+    return;
+
+  CJobManager::GetInstance().CancelJob(m_jobID);
+  m_jobID = 0;
+  --activeRefreshes;
+}
+
+std::string CDirectoryProvider::GetCacheFile() const
+{
+  const std::string key = StringUtils::Format("%s|%i|%i|%u", m_currentUrl.c_str(), m_currentSort.sortBy,
+                                              m_currentSort.sortOrder, m_currentLimit);
+  return StringUtils::Format("%s%08x.fi", CACHE_FOLDER.c_str(), Crc32::Compute(key));
+}
+
 std::string CDirectoryProvider::GetTarget(const CFileItem& item) const
 {
   std::string target = item.GetProperty("node.target").asString();
@@ -67,7 +67,9 @@ public:
 private:
   UpdateState      m_updateState;
   bool             m_isAnnounced;
-  unsigned int     m_jobID;
+  bool             m_cacheLoaded;   ///< \brief whether the persisted contents have been requested
+  unsigned int     m_jobID;         ///< \brief job refreshing the contents, holds a refresh slot
+  unsigned int     m_cacheJobID;    ///< \brief job loading the persisted contents
   KODI::GUILIB::GUIINFO::CGUIInfoLabel m_url;
   KODI::GUILIB::GUIINFO::CGUIInfoLabel m_target;
   KODI::GUILIB::GUIINFO::CGUIInfoLabel m_sortMethod;
@@ -84,6 +86,9 @@ private:
   bool UpdateURL();
   bool UpdateLimit();
   bool UpdateSort();
+  bool UpdateItems(const std::vector<CGUIStaticItemPtr>& items);
+  void CancelRefresh();
+  std::string GetCacheFile() const;
   void OnAddonEvent(const ADDON::AddonEvent& event);
   void OnAddonRepositoryEvent(const ADDON::CRepositoryUpdater::RepositoryUpdated& event);
   void OnPVRManagerEvent(const PVR::PVREvent& event);
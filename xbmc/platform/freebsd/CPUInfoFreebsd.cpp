@@ -133,6 +133,22 @@ CCPUInfoFreebsd::CCPUInfoFreebsd()
 
     if (ecx & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+
+    // AVX needs the OS to save the extended registers as well
+    if ((ecx & CPUID_00000001_ECX_OSXSAVE) && (ecx & CPUID_00000001_ECX_AVX))
+    {
+      uint32_t xcr0;
+      __asm__("xgetbv" : "=a"(xcr0) : "c"(0) : "%edx");
+      if ((xcr0 & XCR0_SSE_AVX_STATE) == XCR0_SSE_AVX_STATE)
+        m_cpuFeatures |= CPU_FEATURE_AVX;
+    }
+  }
+
+  if ((m_cpuFeatures & CPU_FEATURE_AVX) && __get_cpuid_max(0, nullptr) >= CPUID_INFOTYPE_STRUCTURED)
+  {
+    __cpuid_count(CPUID_INFOTYPE_STRUCTURED, 0, eax, ebx, ecx, edx);
+    if (ebx & CPUID_00000007_EBX_AVX2)
+      m_cpuFeatures |= CPU_FEATURE_AVX2;
   }
 
   if (__get_cpuid(CPUID_INFOTYPE_EXTENDED_IMPLEMENTED, &eax, &eax, &ecx, &edx))
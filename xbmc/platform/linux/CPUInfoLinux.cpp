@@ -200,6 +200,22 @@ CCPUInfoLinux::CCPUInfoLinux()
 
     if (ecx & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+
+    // AVX needs the OS to save the extended registers as well
+    if ((ecx & CPUID_00000001_ECX_OSXSAVE) && (ecx & CPUID_00000001_ECX_AVX))
+    {
+      uint32_t xcr0;
+      __asm__("xgetbv" : "=a"(xcr0) : "c"(0) : "%edx");
+      if ((xcr0 & XCR0_SSE_AVX_STATE) == XCR0_SSE_AVX_STATE)
+        m_cpuFeatures |= CPU_FEATURE_AVX;
+    }
+  }
+
+  if ((m_cpuFeatures & CPU_FEATURE_AVX) && __get_cpuid_max(0, nullptr) >= CPUID_INFOTYPE_STRUCTURED)
+  {
+    __cpuid_count(CPUID_INFOTYPE_STRUCTURED, 0, eax, ebx, ecx, edx);
+    if (ebx & CPUID_00000007_EBX_AVX2)
+      m_cpuFeatures |= CPU_FEATURE_AVX2;
   }
 
   if (__get_cpuid(CPUID_INFOTYPE_EXTENDED_IMPLEMENTED, &eax, &eax, &ecx, &edx))
@@ -255,6 +271,9 @@ CCPUInfoLinux::CCPUInfoLinux()
 #if defined(HAS_NEON) && defined(__arm__)
   if (getauxval(AT_HWCAP) & HWCAP_NEON)
     m_cpuFeatures |= CPU_FEATURE_NEON;
+#elif defined(__aarch64__)
+  // Advanced SIMD is mandatory on aarch64
+  m_cpuFeatures |= CPU_FEATURE_NEON;
 #endif
 
   // Set MMX2 when SSE is present as SSE is a superset of MMX2 and Intel doesn't set the MMX2 cap
@@ -17,10 +17,13 @@
 #include <assert.h>
 #include <errno.h>
 #include <limits.h>
+#include <stdint.h>
+#include <string.h>
 #include <string>
 
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -28,6 +31,7 @@ using namespace XFILE;
 
 CPosixFile::~CPosixFile()
 {
+  Unmap();
   if (m_fd >= 0)
     close(m_fd);
 }
@@ -79,6 +83,7 @@ bool CPosixFile::OpenForWrite(const CURL& url, bool bOverWrite /* = false*/ )
 
 void CPosixFile::Close()
 {
+  Unmap();
   if (m_fd >= 0)
   {
     close(m_fd);
@@ -102,7 +107,21 @@ ssize_t CPosixFile::Read(void* lpBuf, size_t uiBufSize)
   if (uiBufSize > SSIZE_MAX)
     uiBufSize = SSIZE_MAX;
 
-  const ssize_t res = read(m_fd, lpBuf, uiBufSize);
+  ssize_t res;
+  if (m_map && m_filePos >= 0 && m_filePos < m_mapSize)
+  {
+    // serve from the mapping, the file descriptor position isn't updated
+    res = static_cast<ssize_t>(std::min<int64_t>(uiBufSize, m_mapSize - m_filePos));
+    memcpy(lpBuf, m_map + m_filePos, res);
+  }
+  else
+  {
+    // the file may have grown since it was mapped
+    if (m_map && m_filePos >= 0 && Seek(m_filePos, SEEK_SET) < 0)
+      return -1;
+    res = read(m_fd, lpBuf, uiBufSize);
+  }
+
   if (res < 0)
   {
     Seek(0, SEEK_CUR); // force update file position
@@ -122,9 +141,20 @@ ssize_t CPosixFile::Read(void* lpBuf, size_t uiBufSize)
     if (end_drop >= 17 * 1024 * 1024)
     {
       const int64_t start_drop = std::max<int64_t>(m_lastDropPos, 16 * 1024 * 1024);
-      if (end_drop - start_drop >= 1 * 1024 * 1024 &&
-          posix_fadvise(m_fd, start_drop, end_drop - start_drop, POSIX_FADV_DONTNEED) == 0)
-        m_lastDropPos = end_drop;
+      if (end_drop - start_drop >= 1 * 1024 * 1024)
+      {
+        // pages that are still mapped aren't dropped from the cache, unmap them first
+        if (m_map && end_drop <= m_mapSize)
+        {
+          const int64_t pageSize = sysconf(_SC_PAGESIZE);
+          const int64_t mapStart = (start_drop + pageSize - 1) / pageSize * pageSize;
+          const int64_t mapEnd = end_drop / pageSize * pageSize;
+          if (mapEnd > mapStart)
+            madvise(const_cast<uint8_t*>(m_map) + mapStart, mapEnd - mapStart, MADV_DONTNEED);
+        }
+        if (posix_fadvise(m_fd, start_drop, end_drop - start_drop, POSIX_FADV_DONTNEED) == 0)
+          m_lastDropPos = end_drop;
+      }
     }
 #endif
   }
@@ -162,6 +192,13 @@ int64_t CPosixFile::Seek(int64_t iFilePosition, int iWhence /* = SEEK_SET*/)
   if (m_fd < 0)
     return -1;
 
+  // reads from the mapping don't move the file descriptor
+  if (m_map && iWhence == SEEK_CUR && m_filePos >= 0)
+  {
+    iFilePosition += m_filePos;
+    iWhence = SEEK_SET;
+  }
+
 #ifdef TARGET_ANDROID
   //! @todo properly support with detection in configure
   //! Android special case: Android doesn't substitute off64_t for off_t and similar functions
@@ -225,7 +262,31 @@ int CPosixFile::IoControl(EIoControl request, void* param)
   if (m_fd < 0)
     return -1;
 
-  if (request == IOCTRL_NATIVE)
+  if (request == IOCTRL_MMAP)
+  {
+    if (!param || m_allowWrite)
+      return -1;
+    if (!m_map)
+    {
+      const int64_t length = GetLength();
+      if (length <= 0 || static_cast<uint64_t>(length) > SIZE_MAX)
+        return -1;
+
+      void* map = mmap(nullptr, static_cast<size_t>(length), PROT_READ, MAP_SHARED, m_fd, 0);
+      if (map == MAP_FAILED)
+      {
+        CLog::Log(LOGDEBUG, "CPosixFile::IoControl - mmap failed with errno %d", errno);
+        return -1;
+      }
+      m_map = static_cast<const uint8_t*>(map);
+      m_mapSize = length;
+    }
+    SFileMapping* mapping = static_cast<SFileMapping*>(param);
+    mapping->data = m_map;
+    mapping->size = m_mapSize;
+    return 0;
+  }
+  else if (request == IOCTRL_NATIVE)
   {
     if(!param)
       return -1;
@@ -268,6 +329,16 @@ int CPosixFile::IoControl(EIoControl request, void* param)
 }
 
 
+void CPosixFile::Unmap()
+{
+  if (m_map)
+  {
+    munmap(const_cast<uint8_t*>(m_map), static_cast<size_t>(m_mapSize));
+    m_map = nullptr;
+    m_mapSize = 0;
+  }
+}
+
 bool CPosixFile::Delete(const CURL& url)
 {
   const std::string filename(getFilename(url));
@@ -38,10 +38,14 @@ namespace XFILE
     int Stat(struct __stat64* buffer) override;
 
   protected:
+    void Unmap();
+
     int     m_fd = -1;
     int64_t m_filePos = -1;
     int64_t m_lastDropPos = -1;
     bool    m_allowWrite = false;
+    const uint8_t* m_map = nullptr; /**< whole file mapping, see IOCTRL_MMAP */
+    int64_t m_mapSize = 0;
   };
 
 }
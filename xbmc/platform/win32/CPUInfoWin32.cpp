@@ -20,6 +20,7 @@
 
 #include <Pdh.h>
 #include <PdhMsg.h>
+#include <immintrin.h>
 #include <intrin.h>
 
 #pragma comment(lib, "Pdh.lib")
@@ -146,6 +147,19 @@ CCPUInfoWin32::CCPUInfoWin32()
       m_cpuFeatures |= CPU_FEATURE_SSE4;
     if (CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_SSE42)
       m_cpuFeatures |= CPU_FEATURE_SSE42;
+
+    // AVX needs the OS to save the extended registers as well
+    if ((CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_OSXSAVE) &&
+        (CPUInfo[CPUINFO_ECX] & CPUID_00000001_ECX_AVX) &&
+        (_xgetbv(0) & XCR0_SSE_AVX_STATE) == XCR0_SSE_AVX_STATE)
+      m_cpuFeatures |= CPU_FEATURE_AVX;
+  }
+
+  if ((m_cpuFeatures & CPU_FEATURE_AVX) && MaxStdInfoType >= CPUID_INFOTYPE_STRUCTURED)
+  {
+    __cpuidex(CPUInfo, CPUID_INFOTYPE_STRUCTURED, 0);
+    if (CPUInfo[CPUINFO_EBX] & CPUID_00000007_EBX_AVX2)
+      m_cpuFeatures |= CPU_FEATURE_AVX2;
   }
 
   __cpuid(CPUInfo, CPUID_INFOTYPE_EXTENDED_IMPLEMENTED);
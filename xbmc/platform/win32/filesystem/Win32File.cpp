@@ -44,6 +44,7 @@ CWin32File::CWin32File(bool asSmbFile) : m_smbFile(asSmbFile)
 
 CWin32File::~CWin32File()
 {
+  Unmap();
   if (m_hFile != INVALID_HANDLE_VALUE)
     CloseHandle(m_hFile);
 }
@@ -156,6 +157,7 @@ bool CWin32File::OpenForWrite(const CURL& url, bool bOverWrite /*= false*/)
 
 void CWin32File::Close()
 {
+  Unmap();
   if (m_hFile != INVALID_HANDLE_VALUE)
     CloseHandle(m_hFile);
 
@@ -339,6 +341,50 @@ int64_t CWin32File::GetPosition()
   return m_filePos;
 }
 
+int CWin32File::IoControl(EIoControl request, void* param)
+{
+  if (request != IOCTRL_MMAP || !param || m_hFile == INVALID_HANDLE_VALUE || m_allowWrite || m_smbFile)
+    return -1;
+
+  if (!m_mapView)
+  {
+    const int64_t length = GetLength();
+    if (length <= 0 || static_cast<uint64_t>(length) > SIZE_MAX)
+      return -1;
+
+    m_hMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_hMapping == nullptr)
+      return -1;
+
+    m_mapView = static_cast<const uint8_t*>(MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_mapView == nullptr)
+    {
+      CLog::LogF(LOGDEBUG, "MapViewOfFile failed with error %lu", GetLastError());
+      CloseHandle(m_hMapping);
+      m_hMapping = nullptr;
+      return -1;
+    }
+    m_mapSize = length;
+  }
+
+  SFileMapping* mapping = static_cast<SFileMapping*>(param);
+  mapping->data = m_mapView;
+  mapping->size = m_mapSize;
+  return 0;
+}
+
+void CWin32File::Unmap()
+{
+  if (m_mapView)
+    UnmapViewOfFile(m_mapView);
+  if (m_hMapping)
+    CloseHandle(m_hMapping);
+
+  m_mapView = nullptr;
+  m_hMapping = nullptr;
+  m_mapSize = 0;
+}
+
 int64_t CWin32File::GetLength()
 {
   if (m_hFile == INVALID_HANDLE_VALUE)
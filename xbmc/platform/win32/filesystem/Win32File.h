@@ -33,6 +33,7 @@ namespace XFILE
     virtual int64_t GetPosition();
     virtual int64_t GetLength();
     virtual void Flush();
+    virtual int IoControl(EIoControl request, void* param);
 
     virtual bool Delete(const CURL& url);
     virtual bool Rename(const CURL& urlCurrentName, const CURL& urlNewName);
@@ -43,6 +44,8 @@ namespace XFILE
 
   protected:
     explicit CWin32File(bool asSmbFile);
+    void Unmap();
+
     HANDLE  m_hFile;
     int64_t m_filePos;
     bool    m_allowWrite;
@@ -50,6 +53,9 @@ namespace XFILE
     std::wstring m_filepathnameW;
     const bool m_smbFile; // true for SMB file, false for local file
     unsigned long m_lastSMBFileErr; // used for SMB file operations
+    HANDLE m_hMapping = nullptr; // file mapping for IOCTRL_MMAP, only the data is mapped, Read() is unchanged
+    const uint8_t* m_mapView = nullptr;
+    int64_t m_mapSize = 0;
   };
 
 }
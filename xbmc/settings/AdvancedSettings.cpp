@@ -152,6 +152,9 @@ void CAdvancedSettings::Initialize()
   m_DXVACheckCompatibility = false;
   m_DXVACheckCompatibilityPresent = false;
   m_videoFpsDetect = 1;
+  m_videoPlaybackTrace = 0;
+  m_videoLowLatencyDecoding = false;
+  m_videoPreloadNextItem = 0;
   m_maxTempo = 1.55f;
   m_videoPreferStereoStream = false;
 
@@ -337,6 +340,8 @@ void CAdvancedSettings::Initialize()
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
   m_curlDisableHTTP2 = false;
+  m_curlRangeConnections = 0; // parallel range requests for cached http(s) files, disabled by default
+  m_curlRangeChunkSize = 2 * 1024 * 1024; // 2 MiB
 
 #if defined(TARGET_DARWIN_EMBEDDED)
   m_startFullScreen = true;
@@ -377,6 +382,16 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  // single-producer/single-consumer memory cache without a shared lock
+  m_cacheLockFree = false;
+  // number of non-contiguous ranges of a file kept in cache (memory is split between them)
+  m_cacheSegments = 1;
+  // size in MiB of the on-disk cache kept across sessions, 0 disables it
+  m_cachePersistentSize = 0;
+  // memory in bytes the directory listing cache may use before folders are evicted
+  m_directoryCacheMemSize = 32 * 1024 * 1024;
+  // per protocol I/O counters of the VFS, see Files.GetIOStats
+  m_ioStats = false;
 
   m_addonPackageFolderSize = 200;
 
@@ -701,6 +716,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
 
     //0 = disable fps detect, 1 = only detect on timestamps with uniform spacing, 2 detect on all timestamps
     XMLUtils::GetInt(pElement, "fpsdetect", m_videoFpsDetect, 0, 2);
+    XMLUtils::GetInt(pElement, "playbacktrace", m_videoPlaybackTrace, 0, 4 * 1024 * 1024);
+    XMLUtils::GetBoolean(pElement, "lowlatencydecoding", m_videoLowLatencyDecoding);
+    XMLUtils::GetInt(pElement, "preloadnextitem", m_videoPreloadNextItem, 0, 600);
     XMLUtils::GetFloat(pElement, "maxtempo", m_maxTempo, 1.5, 2.1);
     XMLUtils::GetBoolean(pElement, "preferstereostream", m_videoPreferStereoStream);
 
@@ -820,6 +838,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement, "disableipv6", m_curlDisableIPV6);
     XMLUtils::GetBoolean(pElement, "disablehttp2", m_curlDisableHTTP2);
+    XMLUtils::GetUInt(pElement, "curlrangeconnections", m_curlRangeConnections, 0, 16);
+    XMLUtils::GetUInt(pElement, "curlrangechunksize", m_curlRangeChunkSize, 64 * 1024, 32 * 1024 * 1024);
   }
 
   pElement = pRootElement->FirstChildElement("cache");
@@ -829,6 +849,10 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetUInt(pElement, "chunksize", m_cacheChunkSize, 256, 1024 * 1024);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetBoolean(pElement, "lockfree", m_cacheLockFree);
+    XMLUtils::GetUInt(pElement, "segments", m_cacheSegments, 1, 8);
+    XMLUtils::GetUInt(pElement, "persistentsize", m_cachePersistentSize);
+    XMLUtils::GetUInt(pElement, "directorysize", m_directoryCacheMemSize, 1024 * 1024, 1024 * 1024 * 1024);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -1038,6 +1062,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   XMLUtils::GetBoolean(pRootElement, "playlistasfolders", m_playlistAsFolders);
   XMLUtils::GetBoolean(pRootElement, "uselocalecollation", m_useLocaleCollation);
   XMLUtils::GetBoolean(pRootElement, "detectasudf", m_detectAsUdf);
+  XMLUtils::GetBoolean(pRootElement, "iostats", m_ioStats);
 
   // music thumbs
   TiXmlElement* pThumbs = pRootElement->FirstChildElement("musicthumbs");
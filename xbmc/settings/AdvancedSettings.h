@@ -170,6 +170,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_DXVACheckCompatibility;
     bool m_DXVACheckCompatibilityPresent;
     int  m_videoFpsDetect;
+    int  m_videoPlaybackTrace; // events kept by the playback trace, 0 disables it
+    bool m_videoLowLatencyDecoding; // decode live streams with fewer threads, less frame delay
+    int  m_videoPreloadNextItem; // seconds before the end the next playlist item is opened, 0 disables it
     float m_maxTempo;
     bool m_videoPreferStereoStream = false;
 
@@ -286,6 +289,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlretries;
     bool m_curlDisableIPV6;
     bool m_curlDisableHTTP2;
+    unsigned int m_curlRangeConnections;
+    unsigned int m_curlRangeChunkSize;
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -328,6 +333,11 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_cacheBufferMode;
     unsigned int m_cacheChunkSize;
     float m_cacheReadFactor;
+    bool m_cacheLockFree;
+    unsigned int m_cacheSegments;
+    unsigned int m_cachePersistentSize;
+    unsigned int m_directoryCacheMemSize;
+    bool m_ioStats;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Registry and helpers of the standalone benchmarks run by kodi-benchmark.
+
+ A benchmark registers itself with BENCHMARK_REGISTER and gets the command line
+ arguments following its name. It runs in the same basic environment as the
+ unit tests (settings, special paths, service manager), but without GUI or
+ render system.
+ */
+class CBenchmark
+{
+public:
+  using Function = std::function<int(const std::vector<std::string>& args)>;
+
+  struct SEntry
+  {
+    std::string name;
+    std::string usage;
+    Function function;
+  };
+
+  static bool Register(const std::string& name, const std::string& usage, Function function);
+  static const std::vector<SEntry>& GetBenchmarks();
+
+  /*!
+   \brief Heap allocations made through operator new since the process started.
+
+   Only operator new is counted. Memory from malloc, av_malloc, the aligned
+   allocators and the buffer pools of the player isn't, so the figures are a
+   lower bound and are labelled "new" in the output.
+   */
+  static uint64_t GetAllocations();
+  static uint64_t GetAllocatedBytes();
+
+  /*!
+   \brief Wall clock and process CPU time spent in a stage, accumulated over
+   many Begin/End pairs, and the allocations made meanwhile.
+   */
+  class CStage
+  {
+  public:
+    explicit CStage(const std::string& name) : m_name(name) {}
+
+    void Begin()
+    {
+      m_wallStart = std::chrono::steady_clock::now();
+      m_cpuStart = std::clock();
+      m_allocationsStart = GetAllocations();
+    }
+
+    void End()
+    {
+      m_wall += std::chrono::steady_clock::now() - m_wallStart;
+      m_cpu += std::clock() - m_cpuStart;
+      m_allocations += GetAllocations() - m_allocationsStart;
+      m_calls++;
+    }
+
+    const std::string& GetName() const { return m_name; }
+    double GetWallSeconds() const { return std::chrono::duration<double>(m_wall).count(); }
+    double GetCpuSeconds() const { return static_cast<double>(m_cpu) / CLOCKS_PER_SEC; }
+    uint64_t GetAllocations() const { return m_allocations; }
+    uint64_t GetCalls() const { return m_calls; }
+
+  private:
+    std::string m_name;
+    std::chrono::steady_clock::time_point m_wallStart;
+    std::chrono::steady_clock::duration m_wall{0};
+    std::clock_t m_cpuStart = 0;
+    std::clock_t m_cpu = 0;
+    uint64_t m_allocationsStart = 0;
+    uint64_t m_allocations = 0;
+    uint64_t m_calls = 0;
+  };
+
+  /*!
+   \brief Print the stages as a table, the rate is calls per wall clock second.
+   */
+  static void PrintStages(const std::vector<const CStage*>& stages);
+};
+
+#define BENCHMARK_REGISTER(name, usage, function) \
+  static const bool benchmark_registered_##function = CBenchmark::Register(name, usage, function)
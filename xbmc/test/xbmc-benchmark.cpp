@@ -0,0 +1,121 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "Benchmark.h"
+#include "TestBasicEnvironment.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+namespace
+{
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> allocatedBytes{0};
+
+std::vector<CBenchmark::SEntry>& GetRegistry()
+{
+  static std::vector<CBenchmark::SEntry> registry;
+  return registry;
+}
+
+void PrintUsage(const char* app)
+{
+  fprintf(stderr, "usage: %s <benchmark> [arguments]\n\nbenchmarks:\n", app);
+  for (const auto& benchmark : CBenchmark::GetBenchmarks())
+    fprintf(stderr, "  %s %s\n", benchmark.name.c_str(), benchmark.usage.c_str());
+}
+} // namespace
+
+// count the operator new allocations of the process, the benchmarks report them per stage
+void* operator new(size_t size)
+{
+  allocations++;
+  allocatedBytes += size;
+  void* ptr = malloc(size ? size : 1);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  free(ptr);
+}
+
+bool CBenchmark::Register(const std::string& name, const std::string& usage, Function function)
+{
+  GetRegistry().push_back({name, usage, function});
+  return true;
+}
+
+const std::vector<CBenchmark::SEntry>& CBenchmark::GetBenchmarks()
+{
+  return GetRegistry();
+}
+
+uint64_t CBenchmark::GetAllocations()
+{
+  return allocations;
+}
+
+uint64_t CBenchmark::GetAllocatedBytes()
+{
+  return allocatedBytes;
+}
+
+void CBenchmark::PrintStages(const std::vector<const CStage*>& stages)
+{
+  printf("%-16s %12s %10s %10s %12s %14s\n", "stage", "calls", "wall (s)", "cpu (s)", "calls/s", "new allocs");
+  for (const CStage* stage : stages)
+  {
+    const double wall = stage->GetWallSeconds();
+    printf("%-16s %12" PRIu64 " %10.3f %10.3f %12.1f %14" PRIu64 "\n", stage->GetName().c_str(),
+           stage->GetCalls(), wall, stage->GetCpuSeconds(),
+           wall > 0 ? stage->GetCalls() / wall : 0.0, stage->GetAllocations());
+  }
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const CBenchmark::SEntry* benchmark = nullptr;
+  for (const auto& entry : CBenchmark::GetBenchmarks())
+  {
+    if (entry.name == argv[1])
+      benchmark = &entry;
+  }
+  if (!benchmark)
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // the environment of the unit tests, its members are incomplete types here
+  // so it's destroyed through the base class
+  std::unique_ptr<testing::Environment> environment(new TestBasicEnvironment());
+  environment->SetUp();
+
+  const int ret = benchmark->function(std::vector<std::string>(argv + 2, argv + argc));
+
+  environment->TearDown();
+  return ret;
+}
@@ -29,6 +29,8 @@ enum CpuFeature
   CPU_FEATURE_3DNOWEXT = 1 << 9,
   CPU_FEATURE_ALTIVEC = 1 << 10,
   CPU_FEATURE_NEON = 1 << 11,
+  CPU_FEATURE_AVX = 1 << 12,
+  CPU_FEATURE_AVX2 = 1 << 13,
 };
 
 struct CoreInfo
@@ -46,6 +48,7 @@ public:
   // Defines to help with calls to CPUID
   const unsigned int CPUID_INFOTYPE_MANUFACTURER = 0x00000000;
   const unsigned int CPUID_INFOTYPE_STANDARD = 0x00000001;
+  const unsigned int CPUID_INFOTYPE_STRUCTURED = 0x00000007;
   const unsigned int CPUID_INFOTYPE_EXTENDED_IMPLEMENTED = 0x80000000;
   const unsigned int CPUID_INFOTYPE_EXTENDED = 0x80000001;
   const unsigned int CPUID_INFOTYPE_PROCESSOR_1 = 0x80000002;
@@ -58,11 +61,20 @@ public:
   const unsigned int CPUID_00000001_ECX_SSSE3 = (1 << 9);
   const unsigned int CPUID_00000001_ECX_SSE4 = (1 << 19);
   const unsigned int CPUID_00000001_ECX_SSE42 = (1 << 20);
+  const unsigned int CPUID_00000001_ECX_OSXSAVE = (1 << 27);
+  const unsigned int CPUID_00000001_ECX_AVX = (1 << 28);
 
   const unsigned int CPUID_00000001_EDX_MMX = (1 << 23);
   const unsigned int CPUID_00000001_EDX_SSE = (1 << 25);
   const unsigned int CPUID_00000001_EDX_SSE2 = (1 << 26);
 
+  // Structured Extended Features
+  // Bitmasks for the values returned by a call to cpuid with eax=0x00000007, ecx=0
+  const unsigned int CPUID_00000007_EBX_AVX2 = (1 << 5);
+
+  // The OS saves the SSE and AVX registers on context switches (XCR0 bits 1 and 2)
+  const unsigned int XCR0_SSE_AVX_STATE = 0x6;
+
   // Extended Features
   // Bitmasks for the values returned by a call to cpuid with eax=0x80000001
   const unsigned int CPUID_80000001_EDX_MMX2 = (1 << 22);
@@ -27,6 +27,7 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "settings/lib/Setting.h"
+#include "utils/CPUInfo.h"
 #include "utils/EmbeddedArt.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -42,6 +43,18 @@
 using namespace XFILE;
 using namespace VIDEO;
 
+namespace
+{
+// files are extracted in parallel, bounded by the cores; the job manager
+// runs at most two low priority pausable jobs at once anyway
+unsigned int GetExtractionJobs()
+{
+  const std::shared_ptr<CCPUInfo> cpuInfo = CServiceBroker::GetCPUInfo();
+  const int cpus = cpuInfo ? cpuInfo->GetCPUCount() : 1;
+  return static_cast<unsigned int>(std::max(1, std::min(cpus / 2, 2)));
+}
+} // namespace
+
 CThumbExtractor::CThumbExtractor(const CFileItem& item,
                                  const std::string& listpath,
                                  bool thumb,
@@ -177,7 +190,7 @@ bool CThumbExtractor::DoWork()
 }
 
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(), CJobQueue(true, GetExtractionJobs(), CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_videoDatabase = new CVideoDatabase();
 }
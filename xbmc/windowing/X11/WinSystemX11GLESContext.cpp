@@ -13,6 +13,7 @@
 #include "GLContextEGL.h"
 #include "OptionalsReg.h"
 #include "X11DPMSSupport.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
 #include "cores/RetroPlayer/process/X11/RPProcessInfoX11.h"
 #include "cores/RetroPlayer/rendering/VideoRenderers/RPRendererOpenGLES.h"
 #include "cores/VideoPlayer/DVDCodecs/DVDFactoryCodec.h"
@@ -55,6 +56,10 @@ CWinSystemX11GLESContext::CWinSystemX11GLESContext()
   {
     OPTIONALS::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "NULL"))
+  {
+    CAESinkNULL::Register();
+  }
   else
   {
     if (!OPTIONALS::PulseAudioRegister())
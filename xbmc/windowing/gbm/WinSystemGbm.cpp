@@ -14,6 +14,7 @@
 #include "OffScreenModeSetting.h"
 #include "OptionalsReg.h"
 #include "ServiceBroker.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
 #include "messaging/ApplicationMessenger.h"
 #include "settings/DisplaySettings.h"
 #include "settings/Settings.h"
@@ -55,6 +56,10 @@ CWinSystemGbm::CWinSystemGbm() :
   {
     OPTIONALS::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "NULL"))
+  {
+    CAESinkNULL::Register();
+  }
   else if (StringUtils::EqualsNoCase(envSink, "ALSA+PULSE"))
   {
     OPTIONALS::ALSARegister();